@@ -0,0 +1,229 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "common/JobSystem.h"
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Measures scheduling overhead of JobSystem and how parallel work scales with
+ * worker count. Every test also verifies its result, so the benchmark fails
+ * (with nonzero exit code) if the jobs are lost or executed out of order.
+ */
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+double elapsedMilliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/* Returns best time of given count of runs, in milliseconds */
+double measure(std::size_t runs, const std::function<bool()>& test, bool& passed) {
+    double best = 0.0;
+    for(std::size_t i = 0; i != runs; ++i) {
+        const Clock::time_point start = Clock::now();
+        if(!test()) passed = false;
+        const double time = elapsedMilliseconds(start);
+        if(!i || time < best) best = time;
+    }
+    return best;
+}
+
+/* Some floating-point work which the compiler can't optimize away */
+double kernel(std::size_t first, std::size_t last) {
+    double sum = 0.0;
+    for(std::size_t i = first; i != last; ++i)
+        sum += std::sqrt(double(i))*std::sin(double(i)*0.001);
+    return sum;
+}
+
+/* Recursive job tree, each job spawns two children and waits for them */
+UnsignedLong fibonacci(JobSystem& jobs, UnsignedInt n) {
+    if(n < 16) {
+        UnsignedLong a = 0, b = 1;
+        for(UnsignedInt i = 0; i != n; ++i) {
+            const UnsignedLong c = a + b;
+            a = b;
+            b = c;
+        }
+        return a;
+    }
+
+    UnsignedLong a, b;
+    JobSystem::JobHandle first = jobs.add([&]() { a = fibonacci(jobs, n - 1); });
+    JobSystem::JobHandle second = jobs.add([&]() { b = fibonacci(jobs, n - 2); });
+    jobs.wait(first);
+    jobs.wait(second);
+    return a + b;
+}
+
+constexpr std::size_t EmptyJobCount = 100000;
+constexpr std::size_t KernelSize = 1 << 24;
+constexpr std::size_t KernelGrainSize = 1 << 14;
+constexpr std::size_t GraphLayerCount = 64;
+constexpr std::size_t GraphLayerWidth = 256;
+constexpr UnsignedInt FibonacciN = 30;
+constexpr UnsignedLong FibonacciResult = 832040;
+
+}
+
+int benchmark(int argc, char** argv) {
+    bool checkScaling = false;
+    const UnsignedInt hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    UnsignedInt maxThreads = hardwareThreads;
+    std::size_t runs = 5;
+    for(int i = 1; i != argc; ++i) {
+        if(std::strcmp(argv[i], "--check-scaling") == 0) checkScaling = true;
+        else if(std::strcmp(argv[i], "--max-threads") == 0 && i + 1 != argc)
+            maxThreads = std::max(std::atoi(argv[++i]), 1);
+        else if(std::strcmp(argv[i], "--runs") == 0 && i + 1 != argc)
+            runs = std::max(std::atoi(argv[++i]), 1);
+        else {
+            std::cout << "Usage: " << argv[0] << " [--max-threads N] [--runs N] [--check-scaling]" << std::endl;
+            return 0;
+        }
+    }
+
+    /* More threads than cores can't scale, so the scaling test is limited
+       to the hardware threads */
+    if(checkScaling) maxThreads = std::min(maxThreads, hardwareThreads);
+
+    bool passed = true;
+
+    /* Serial baseline for the scaling test */
+    const double expectedSum = kernel(0, KernelSize);
+    const double serialTime = measure(runs, [&]() { return kernel(0, KernelSize) == expectedSum; }, passed);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "threads   empty jobs/s   graph ms   fib(" << FibonacciN << ") ms   parallelFor ms   speedup   efficiency" << std::endl;
+
+    /* Powers of two and the max thread count, one thread means no workers
+       and all jobs executed serially */
+    std::vector<UnsignedInt> threadCounts;
+    for(UnsignedInt threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    double lastEfficiency = 1.0;
+    for(UnsignedInt threads: threadCounts) {
+        /* The thread calling wait() helps, so one worker less */
+        JobSystem jobs(threads - 1);
+
+        /* Scheduling overhead of jobs doing nothing */
+        std::atomic<std::size_t> counter;
+        const double emptyTime = measure(runs, [&]() {
+            counter = 0;
+            std::vector<JobSystem::JobHandle> handles;
+            handles.reserve(EmptyJobCount);
+            for(std::size_t i = 0; i != EmptyJobCount; ++i)
+                handles.push_back(jobs.add([&counter]() { ++counter; }));
+            jobs.wait(handles);
+            return counter == EmptyJobCount;
+        }, passed);
+
+        /* Layers of jobs, each job depending on two jobs from previous
+           layer, checks that the dependencies are finished before the job
+           runs */
+        std::vector<std::atomic<UnsignedInt>> values(GraphLayerCount*GraphLayerWidth);
+        const double graphTime = measure(runs, [&]() {
+            std::atomic<bool> ordered(true);
+            std::vector<JobSystem::JobHandle> previous, current;
+            for(std::size_t layer = 0; layer != GraphLayerCount; ++layer) {
+                current.clear();
+                for(std::size_t i = 0; i != GraphLayerWidth; ++i) {
+                    const std::size_t index = layer*GraphLayerWidth + i;
+                    values[index] = 0;
+                    auto job = [&values, &ordered, layer, i, index]() {
+                        if(layer && (values[index - GraphLayerWidth] != layer || values[(layer - 1)*GraphLayerWidth + (i + 1)%GraphLayerWidth] != layer))
+                            ordered = false;
+                        values[index] = layer + 1;
+                    };
+                    if(layer) current.push_back(jobs.add(job, {previous[i], previous[(i + 1)%GraphLayerWidth]}));
+                    else current.push_back(jobs.add(job));
+                }
+                std::swap(previous, current);
+            }
+            jobs.wait(previous);
+            return bool(ordered);
+        }, passed);
+
+        /* Nested jobs, tests stealing and waiting inside jobs */
+        const double fibonacciTime = measure(runs, [&]() {
+            return fibonacci(jobs, FibonacciN) == FibonacciResult;
+        }, passed);
+
+        /* Data-parallel work. Floating-point addition isn't associative, so
+           the chunk sums are added in fixed order and compared with small
+           tolerance. */
+        const double parallelTime = measure(runs, [&]() {
+            std::vector<double> sums(KernelSize/KernelGrainSize);
+            jobs.parallelFor(0, KernelSize, KernelGrainSize, [&sums](std::size_t first, std::size_t last) {
+                sums[first/KernelGrainSize] = kernel(first, last);
+            });
+            double sum = 0.0;
+            for(double s: sums) sum += s;
+            return std::abs(sum - expectedSum) <= std::abs(expectedSum)*1.0e-9;
+        }, passed);
+
+        const double speedup = serialTime/parallelTime;
+        lastEfficiency = speedup/threads;
+        std::cout << std::setw(7) << threads
+                  << std::setw(15) << std::setprecision(0) << EmptyJobCount/(emptyTime/1000.0)
+                  << std::setw(11) << std::setprecision(2) << graphTime
+                  << std::setw(13) << fibonacciTime
+                  << std::setw(17) << parallelTime
+                  << std::setw(10) << speedup
+                  << std::setw(13) << lastEfficiency << std::endl;
+    }
+
+    if(!passed) {
+        std::cout << "FAILED: some jobs were lost or executed out of order" << std::endl;
+        return 1;
+    }
+
+    /* Half of the ideal speedup is what should be achievable even on busy
+       machines */
+    if(checkScaling && maxThreads > 1 && lastEfficiency < 0.5) {
+        std::cout << "FAILED: parallel efficiency with " << maxThreads << " threads is below 50%" << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
+
+}}
+
+int main(int argc, char** argv) {
+    return Magnum::Examples::benchmark(argc, argv);
+}
@@ -0,0 +1,288 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/ConcurrentResourceMap.h"
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Measures lookup throughput of ConcurrentResourceMap with increasing count
+ * of reader threads while the main thread keeps replacing the data, and
+ * compares it with the same map protected by a mutex. Readers also post
+ * their own updates from time to time. Every looked up value is checked for
+ * belonging to the key and for not being deleted yet, and at the end all
+ * values must be deleted, so the benchmark also works as a stress test and
+ * fails with nonzero exit code if the map returns wrong or deleted data or
+ * leaks them.
+ */
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+constexpr UnsignedInt AliveMagic = 0xa11fe;
+constexpr std::size_t KeyCount = 1024;
+constexpr std::size_t LookupBatchSize = 64;
+constexpr std::size_t PostInterval = 4096;
+
+std::atomic<std::ptrdiff_t> aliveCount{0};
+
+struct Value {
+    explicit Value(UnsignedInt key, UnsignedInt version): key(key), version(version), magic(AliveMagic) { ++aliveCount; }
+
+    ~Value() {
+        magic = 0;
+        --aliveCount;
+    }
+
+    UnsignedInt key, version;
+    volatile UnsignedInt magic;
+};
+
+/* Cheap random numbers, so they don't dominate the lookup time */
+inline UnsignedInt xorshift(UnsignedInt& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/* Same map as ConcurrentResourceMap, but with every access locked */
+struct LockedMap {
+    struct KeyHash {
+        std::size_t operator()(const ResourceKey& key) const {
+            return *reinterpret_cast<const std::size_t*>(key.byteArray());
+        }
+    };
+
+    void set(const ResourceKey& key, Value* data) {
+        std::shared_ptr<const Value> value(data);
+        std::lock_guard<std::mutex> lock(mutex);
+        table[key] = std::move(value);
+    }
+
+    const Value* get(const ResourceKey& key) const {
+        auto found = table.find(key);
+        return found == table.end() ? nullptr : found->second.get();
+    }
+
+    std::mutex mutex;
+    std::unordered_map<ResourceKey, std::shared_ptr<const Value>, KeyHash> table;
+};
+
+struct Shared {
+    std::atomic<bool> stop, passed;
+    std::atomic<UnsignedLong> lookups;
+};
+
+struct Result {
+    Double lookupsPerSecond, updatesPerSecond;
+};
+
+inline bool check(const Value* value, UnsignedInt key) {
+    return value && value->key == key && value->magic == AliveMagic;
+}
+
+/* Lookups in batches, each batch through one reader, until stopped. Some
+   updates are posted from the readers too. */
+void rcuReader(ConcurrentResourceMap<Value>& map, const std::vector<ResourceKey>& keys, UnsignedInt state, Shared& shared) {
+    UnsignedLong count = 0;
+    bool ok = true;
+    while(!shared.stop.load(std::memory_order_relaxed)) {
+        {
+            ConcurrentResourceMap<Value>::Reader reader(map);
+            for(std::size_t i = 0; i != LookupBatchSize; ++i) {
+                const UnsignedInt key = xorshift(state)%KeyCount;
+                ok = check(reader.get(keys[key]), key) && ok;
+            }
+        }
+
+        count += LookupBatchSize;
+        if(count%PostInterval == 0) {
+            const UnsignedInt key = xorshift(state)%KeyCount;
+            map.post(keys[key], new Value(key, 0));
+        }
+    }
+
+    shared.lookups += count;
+    if(!ok) shared.passed = false;
+}
+
+/* The same with the lock held for each batch */
+void lockedReader(LockedMap& map, const std::vector<ResourceKey>& keys, UnsignedInt state, Shared& shared) {
+    UnsignedLong count = 0;
+    bool ok = true;
+    while(!shared.stop.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(map.mutex);
+            for(std::size_t i = 0; i != LookupBatchSize; ++i) {
+                const UnsignedInt key = xorshift(state)%KeyCount;
+                ok = check(map.get(keys[key]), key) && ok;
+            }
+        }
+
+        count += LookupBatchSize;
+        if(count%PostInterval == 0) {
+            const UnsignedInt key = xorshift(state)%KeyCount;
+            map.set(keys[key], new Value(key, 0));
+        }
+    }
+
+    shared.lookups += count;
+    if(!ok) shared.passed = false;
+}
+
+/* Runs the readers on given count of threads, while the calling thread
+   updates random keys */
+Result run(UnsignedInt threadCount, Double duration, std::chrono::microseconds updateInterval, const std::function<void(UnsignedInt, Shared&)>& reader, const std::function<void(UnsignedInt, UnsignedInt)>& update, bool& passed) {
+    Shared shared;
+    shared.stop = false;
+    shared.passed = true;
+    shared.lookups = 0;
+
+    std::vector<std::thread> threads;
+    for(UnsignedInt t = 0; t != threadCount; ++t)
+        threads.emplace_back(reader, 2463534242u + t*7919, std::ref(shared));
+
+    UnsignedInt state = 88172645u;
+    UnsignedInt updates = 0;
+    const Clock::time_point start = Clock::now();
+    Double elapsed;
+    while((elapsed = std::chrono::duration<Double>(Clock::now() - start).count()) < duration) {
+        update(xorshift(state)%KeyCount, ++updates);
+        std::this_thread::sleep_for(updateInterval);
+    }
+
+    shared.stop = true;
+    for(std::thread& thread: threads) thread.join();
+
+    if(!shared.passed) passed = false;
+    return {shared.lookups/elapsed, updates/elapsed};
+}
+
+}
+
+int benchmark(int argc, char** argv) {
+    UnsignedInt maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    Double duration = 0.5;
+    std::chrono::microseconds updateInterval(100);
+    for(int i = 1; i != argc; ++i) {
+        if(std::strcmp(argv[i], "--max-threads") == 0 && i + 1 != argc)
+            maxThreads = std::max(std::atoi(argv[++i]), 1);
+        else if(std::strcmp(argv[i], "--duration") == 0 && i + 1 != argc && std::atof(argv[i + 1]) > 0.0)
+            duration = std::atof(argv[++i]);
+        else if(std::strcmp(argv[i], "--update-interval") == 0 && i + 1 != argc && std::atoi(argv[i + 1]) >= 0)
+            updateInterval = std::chrono::microseconds(std::atoi(argv[++i]));
+        else {
+            std::cout << "Usage: " << argv[0] << " [--max-threads N] [--duration S] [--update-interval US]" << std::endl;
+            return 0;
+        }
+    }
+
+    std::vector<ResourceKey> keys;
+    for(std::size_t i = 0; i != KeyCount; ++i) {
+        std::ostringstream name;
+        name << "resource" << i;
+        keys.emplace_back(name.str());
+    }
+
+    std::cout << KeyCount << " resources, lookups in batches of " << LookupBatchSize << ", update every " << updateInterval.count() << " us" << std::endl
+              << std::fixed << std::setprecision(2)
+              << "threads   RCU Mlookups/s   updates/s   mutex Mlookups/s   updates/s   speedup" << std::endl;
+
+    /* Powers of two and the max thread count */
+    std::vector<UnsignedInt> threadCounts;
+    for(UnsignedInt threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    bool passed = true;
+    std::size_t maxRetired = 0;
+    for(UnsignedInt threads: threadCounts) {
+        Result rcu, locked;
+
+        {
+            ConcurrentResourceMap<Value> map;
+            for(UnsignedInt i = 0; i != KeyCount; ++i) map.set(keys[i], new Value(i, 0));
+            rcu = run(threads, duration, updateInterval, [&](UnsignedInt state, Shared& shared) {
+                rcuReader(map, keys, state, shared);
+            }, [&](UnsignedInt key, UnsignedInt version) {
+                map.set(keys[key], new Value(key, version));
+                map.processPending();
+                maxRetired = std::max(maxRetired, map.retiredCount());
+            }, passed);
+        }
+
+        {
+            LockedMap map;
+            for(UnsignedInt i = 0; i != KeyCount; ++i) map.set(keys[i], new Value(i, 0));
+            locked = run(threads, duration, updateInterval, [&](UnsignedInt state, Shared& shared) {
+                lockedReader(map, keys, state, shared);
+            }, [&](UnsignedInt key, UnsignedInt version) {
+                map.set(keys[key], new Value(key, version));
+            }, passed);
+        }
+
+        std::cout << std::setw(7) << threads
+                  << std::setw(17) << rcu.lookupsPerSecond/1.0e6
+                  << std::setw(12) << std::setprecision(0) << rcu.updatesPerSecond
+                  << std::setw(19) << std::setprecision(2) << locked.lookupsPerSecond/1.0e6
+                  << std::setw(12) << std::setprecision(0) << locked.updatesPerSecond
+                  << std::setw(10) << std::setprecision(2) << rcu.lookupsPerSecond/locked.lookupsPerSecond << std::endl;
+    }
+
+    std::cout << "At most " << maxRetired << " old snapshots were waiting for readers" << std::endl;
+
+    if(!passed) {
+        std::cout << "FAILED: lookup returned wrong or deleted data" << std::endl;
+        return 1;
+    }
+
+    if(aliveCount != 0) {
+        std::cout << "FAILED: " << aliveCount << " values were not deleted" << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
+
+}}
+
+int main(int argc, char** argv) {
+    return Magnum::Examples::benchmark(argc, argv);
+}
@@ -0,0 +1,311 @@
+#ifndef Magnum_Examples_ConcurrentResourceMap_h
+#define Magnum_Examples_ConcurrentResourceMap_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <ResourceManager.h>
+#include <Utility/Assert.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Resource map with concurrent read access
+
+@ref ResourceManager can't be used from more threads, not even for lookups,
+as resource handles are reference-counted without any synchronization. This
+map keeps read-only data (e.g. decoded images or mesh data next to GL objects
+in the resource manager) which worker threads can look up while the owner
+thread keeps updating it.
+
+The map is read-copy-update: readers see an immutable snapshot of the whole
+map, mutations copy it, modify the copy and atomically publish it. Lookups
+thus don't lock and don't write to any shared memory, so they scale with
+reader count, while each mutation costs a copy of the map, which is fine for
+maps that are read much more often than changed. Old snapshots are deleted
+only after no reader uses them, each reader announces its snapshot in its
+own slot (a hazard pointer), which the owner checks before deleting.
+
+All mutations are done on the thread which created the map (usually the one
+with GL context), other threads can only post() them to be applied in the
+next processPending() call, all at once in one snapshot:
+@code
+// Worker thread
+{
+    ConcurrentResourceMap<Trade::ImageData2D>::Reader reader(images);
+    if(!reader.get("tarnish"))
+        images.post("tarnish", importer->image2D(0));
+}
+
+// GL thread, once per frame
+images.processPending();
+@endcode
+*/
+template<class T> class ConcurrentResourceMap {
+    private:
+        struct KeyHash {
+            inline std::size_t operator()(const ResourceKey& key) const {
+                return *reinterpret_cast<const std::size_t*>(key.byteArray());
+            }
+        };
+
+        typedef std::unordered_map<ResourceKey, std::shared_ptr<const T>, KeyHash> Table;
+
+    public:
+        enum: std::size_t {
+            MaxReaders = 64     /**< @brief Max count of concurrent readers */
+        };
+
+        /**
+         * @brief Reader
+         *
+         * Pins the current snapshot of the map for its whole lifetime, so all
+         * lookups through one reader are consistent and the returned
+         * pointers stay valid until the reader is destroyed. It should thus
+         * be short-lived, e.g. one per job, as long-lived readers delay
+         * deletion of old data. If there are already @ref MaxReaders
+         * readers, the constructor waits for some of them to finish.
+         */
+        class Reader {
+            public:
+                explicit Reader(const ConcurrentResourceMap<T>& map);
+
+                Reader(const Reader&) = delete;
+                Reader& operator=(const Reader&) = delete;
+
+                ~Reader();
+
+                /** @brief Data for given key or `nullptr` if there are none */
+                inline const T* get(const ResourceKey& key) const {
+                    auto found = table->find(key);
+                    return found == table->end() ? nullptr : found->second.get();
+                }
+
+                /** @brief Count of resources in the snapshot */
+                inline std::size_t count() const { return table->size(); }
+
+            private:
+                const ConcurrentResourceMap<T>& map;
+                std::size_t slot;
+                const Table* table;
+        };
+
+        /**
+         * @brief Constructor
+         *
+         * The calling thread becomes owner of the map.
+         */
+        explicit ConcurrentResourceMap();
+
+        ConcurrentResourceMap(const ConcurrentResourceMap<T>&) = delete;
+        ConcurrentResourceMap<T>& operator=(const ConcurrentResourceMap<T>&) = delete;
+
+        /**
+         * @brief Destructor
+         *
+         * Expects that there are no readers.
+         */
+        ~ConcurrentResourceMap();
+
+        /**
+         * @brief Set data
+         *
+         * The map takes ownership of the data, replaced data are deleted
+         * after no reader uses them. Can be called only from owner thread.
+         */
+        void set(const ResourceKey& key, T* data);
+
+        /**
+         * @brief Remove data
+         *
+         * Can be called only from owner thread.
+         */
+        void remove(const ResourceKey& key);
+
+        /**
+         * @brief Post data to be set from owner thread
+         *
+         * Can be called from any thread. If @p data is `nullptr`, the key is
+         * removed. Takes ownership of the data.
+         */
+        void post(const ResourceKey& key, T* data);
+
+        /**
+         * @brief Apply posted mutations
+         *
+         * Applies all mutations posted since last call in one snapshot and
+         * deletes old snapshots which aren't used anymore, should be called
+         * once per frame. Can be called only from owner thread. Returns
+         * count of applied mutations.
+         */
+        std::size_t processPending();
+
+        /** @brief Count of old snapshots waiting for deletion */
+        inline std::size_t retiredCount() const { return retired.size(); }
+
+    private:
+        /* Each slot on separate cache line, so readers don't invalidate
+           each other's caches. The padding keeps the size even where the
+           alignment isn't honored, e.g. for heap-allocated maps. */
+        struct alignas(64) Slot {
+            std::atomic<const Table*> hazard;
+            std::atomic<bool> used;
+            char padding[64 - sizeof(std::atomic<const Table*>) - sizeof(std::atomic<bool>)];
+        };
+
+        void publish(Table* next);
+        void reclaim();
+
+        std::thread::id owner;
+        std::atomic<const Table*> current;
+        std::vector<const Table*> retired;
+        mutable Slot slots[MaxReaders];
+
+        std::mutex pendingMutex;
+        std::vector<std::pair<ResourceKey, std::shared_ptr<const T>>> pending;
+};
+
+template<class T> ConcurrentResourceMap<T>::Reader::Reader(const ConcurrentResourceMap<T>& map): map(map) {
+    /* Claim a free slot, starting at different one in each thread to avoid
+       fighting over the first ones */
+    const std::size_t start = std::hash<std::thread::id>()(std::this_thread::get_id())%MaxReaders;
+    for(std::size_t i = 0; ; ++i) {
+        slot = (start + i)%MaxReaders;
+        bool expected = false;
+        if(!map.slots[slot].used.load(std::memory_order_relaxed) && map.slots[slot].used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            break;
+        if(i%MaxReaders == MaxReaders - 1) std::this_thread::yield();
+    }
+
+    /* Announce the snapshot and check that it wasn't replaced in the
+       meantime, otherwise the owner might have already missed the
+       announcement and deleted it */
+    const Table* t = map.current.load();
+    for(;;) {
+        map.slots[slot].hazard.store(t);
+        const Table* again = map.current.load();
+        if(again == t) break;
+        t = again;
+    }
+    table = t;
+}
+
+template<class T> ConcurrentResourceMap<T>::Reader::~Reader() {
+    map.slots[slot].hazard.store(nullptr, std::memory_order_release);
+    map.slots[slot].used.store(false, std::memory_order_release);
+}
+
+template<class T> ConcurrentResourceMap<T>::ConcurrentResourceMap(): owner(std::this_thread::get_id()), current(new Table) {
+    for(Slot& slot: slots) {
+        slot.hazard = nullptr;
+        slot.used = false;
+    }
+}
+
+template<class T> ConcurrentResourceMap<T>::~ConcurrentResourceMap() {
+    for(const Slot& slot: slots)
+        CORRADE_ASSERT(!slot.used, "ConcurrentResourceMap: destroyed while there are readers", );
+
+    delete current.load();
+    for(const Table* table: retired) delete table;
+}
+
+template<class T> void ConcurrentResourceMap<T>::set(const ResourceKey& key, T* data) {
+    CORRADE_ASSERT(std::this_thread::get_id() == owner, "ConcurrentResourceMap::set(): can be called only from owner thread", );
+
+    Table* next = new Table(*current.load(std::memory_order_relaxed));
+    (*next)[key] = std::shared_ptr<const T>(data);
+    publish(next);
+}
+
+template<class T> void ConcurrentResourceMap<T>::remove(const ResourceKey& key) {
+    CORRADE_ASSERT(std::this_thread::get_id() == owner, "ConcurrentResourceMap::remove(): can be called only from owner thread", );
+
+    Table* next = new Table(*current.load(std::memory_order_relaxed));
+    next->erase(key);
+    publish(next);
+}
+
+template<class T> void ConcurrentResourceMap<T>::post(const ResourceKey& key, T* data) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending.emplace_back(key, std::shared_ptr<const T>(data));
+}
+
+template<class T> std::size_t ConcurrentResourceMap<T>::processPending() {
+    CORRADE_ASSERT(std::this_thread::get_id() == owner, "ConcurrentResourceMap::processPending(): can be called only from owner thread", 0);
+
+    std::vector<std::pair<ResourceKey, std::shared_ptr<const T>>> mutations;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        std::swap(mutations, pending);
+    }
+
+    if(mutations.empty()) {
+        reclaim();
+        return 0;
+    }
+
+    /* Later mutations of the same key override earlier ones */
+    Table* next = new Table(*current.load(std::memory_order_relaxed));
+    for(auto& mutation: mutations) {
+        if(mutation.second) (*next)[mutation.first] = std::move(mutation.second);
+        else next->erase(mutation.first);
+    }
+    publish(next);
+    return mutations.size();
+}
+
+template<class T> void ConcurrentResourceMap<T>::publish(Table* next) {
+    retired.push_back(current.exchange(next));
+    reclaim();
+}
+
+template<class T> void ConcurrentResourceMap<T>::reclaim() {
+    if(retired.empty()) return;
+
+    std::vector<const Table*> used;
+    for(const Slot& slot: slots)
+        if(const Table* table = slot.hazard.load()) used.push_back(table);
+
+    std::size_t kept = 0;
+    for(const Table* table: retired) {
+        if(std::find(used.begin(), used.end(), table) != used.end())
+            retired[kept++] = table;
+        else delete table;
+    }
+    retired.resize(kept);
+}
+
+}}
+
+#endif
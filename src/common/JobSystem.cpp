@@ -0,0 +1,225 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+    JobSystem* globalInstance = nullptr;
+}
+
+JobSystem* JobSystem::instance() { return globalInstance; }
+
+JobSystem::JobSystem(UnsignedInt workerCount): startedCount(0), nextWorker(0), queuedCount(0), stopping(false) {
+    if(workerCount == AutomaticWorkerCount)
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    /* Create all deques first, so the workers can steal from any of them
+       right after they start */
+    for(UnsignedInt i = 0; i != workerCount; ++i)
+        workers.emplace_back(new Worker);
+    for(UnsignedInt i = 0; i != workerCount; ++i)
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+
+    /* Wait until all workers saved their thread IDs */
+    while(startedCount != workerCount) std::this_thread::yield();
+
+    if(!globalInstance) globalInstance = this;
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+
+    for(std::unique_ptr<Worker>& worker: workers) worker->thread.join();
+
+    if(globalInstance == this) globalInstance = nullptr;
+}
+
+JobSystem::JobHandle JobSystem::add(std::function<void()> function, std::initializer_list<JobHandle> dependencies) {
+    JobHandle job = std::make_shared<Job>();
+    job->function = std::move(function);
+    addDependencies(job, dependencies.begin(), dependencies.end());
+    return job;
+}
+
+JobSystem::JobHandle JobSystem::add(std::function<void()> function, const std::vector<JobHandle>& dependencies) {
+    JobHandle job = std::make_shared<Job>();
+    job->function = std::move(function);
+    addDependencies(job, dependencies.data(), dependencies.data() + dependencies.size());
+    return job;
+}
+
+void JobSystem::addDependencies(const JobHandle& job, const JobHandle* begin, const JobHandle* end) {
+    /* The extra one prevents the job from being scheduled by a dependency
+       finishing while the other dependencies are still being added */
+    job->pendingDependencies = 1;
+    job->finished = false;
+
+    for(const JobHandle* dependency = begin; dependency != end; ++dependency) {
+        std::lock_guard<std::mutex> lock((*dependency)->mutex);
+        if((*dependency)->finished) continue;
+
+        ++job->pendingDependencies;
+        (*dependency)->dependents.push_back(job);
+    }
+
+    if(--job->pendingDependencies == 0) schedule(job);
+}
+
+bool JobSystem::isFinished(const JobHandle& job) { return job->finished; }
+
+void JobSystem::wait(const JobHandle& job) {
+    const Int current = currentWorker();
+    while(!job->finished) {
+        if(JobHandle other = take(current)) run(other);
+        else std::this_thread::yield();
+    }
+}
+
+void JobSystem::wait(const std::vector<JobHandle>& jobs) {
+    for(const JobHandle& job: jobs) wait(job);
+}
+
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)>& function) {
+    if(begin >= end) return;
+    if(!grainSize) grainSize = 1;
+
+    /* Everything fits into one job, no need to involve the workers */
+    if(end - begin <= grainSize) {
+        function(begin, end);
+        return;
+    }
+
+    std::vector<JobHandle> jobs;
+    jobs.reserve((end - begin + grainSize - 1)/grainSize);
+    for(std::size_t first = begin; first < end; first += grainSize) {
+        const std::size_t last = std::min(first + grainSize, end);
+        jobs.push_back(add([&function, first, last]() { function(first, last); }));
+    }
+
+    wait(jobs);
+}
+
+void JobSystem::schedule(JobHandle job) {
+    /* No workers, execute right away */
+    if(workers.empty()) {
+        run(job);
+        return;
+    }
+
+    /* Count the job before it becomes visible, so the counter never goes
+       below zero when the job is taken immediately */
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        ++queuedCount;
+    }
+
+    /* Push to own deque if called from a worker, otherwise distribute the
+       jobs among workers in round-robin fashion */
+    Int index = currentWorker();
+    if(index == -1) index = nextWorker++%workers.size();
+    {
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+
+    sleepCondition.notify_one();
+}
+
+void JobSystem::run(const JobHandle& job) {
+    job->function();
+
+    std::vector<JobHandle> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished = true;
+        std::swap(dependents, job->dependents);
+    }
+
+    for(JobHandle& dependent: dependents)
+        if(--dependent->pendingDependencies == 0) schedule(std::move(dependent));
+}
+
+JobSystem::JobHandle JobSystem::take(Int current) {
+    /* Own jobs from the back */
+    if(current != -1) {
+        Worker& worker = *workers[current];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if(!worker.jobs.empty()) {
+            JobHandle job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            --queuedCount;
+            return job;
+        }
+    }
+
+    /* Steal from front of other deques, starting at the next one so the
+       victims are spread evenly */
+    const std::size_t count = workers.size();
+    for(std::size_t i = 1; i <= count; ++i) {
+        Worker& victim = *workers[(current + i)%count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.jobs.empty()) {
+            JobHandle job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            --queuedCount;
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+Int JobSystem::currentWorker() const {
+    const std::thread::id id = std::this_thread::get_id();
+    for(std::size_t i = 0; i != workers.size(); ++i)
+        if(workers[i]->id == id) return i;
+    return -1;
+}
+
+void JobSystem::workerLoop(UnsignedInt index) {
+    workers[index]->id = std::this_thread::get_id();
+    ++startedCount;
+
+    for(;;) {
+        if(JobHandle job = take(index)) {
+            run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return stopping || queuedCount != 0; });
+        if(stopping) return;
+    }
+}
+
+}}
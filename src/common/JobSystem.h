@@ -0,0 +1,174 @@
+#ifndef Magnum_Examples_JobSystem_h
+#define Magnum_Examples_JobSystem_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Work-stealing job system
+
+Pool of worker threads, each with its own job deque. Jobs created on a worker
+thread are pushed to back of its deque and the worker takes them from the
+back again (so related jobs run while their data are still in cache), idle
+workers steal from front of other deques. Jobs can depend on other jobs, in
+which case they are scheduled only after all dependencies finish.
+
+Thread waiting for a job (see wait()) doesn't block, but executes other jobs
+in the meantime, so it is possible to wait from inside a job and the calling
+thread itself contributes to the work.
+
+Only one instance is meant to exist in the application and it is shared by
+everything, available through instance().
+*/
+class JobSystem {
+    private:
+        struct Job;
+
+    public:
+        /** @brief Job handle */
+        typedef std::shared_ptr<Job> JobHandle;
+
+        enum: UnsignedInt {
+            AutomaticWorkerCount = ~UnsignedInt(0)  /**< @brief Worker count based on hardware threads */
+        };
+
+        /**
+         * @brief Global instance
+         *
+         * Returns `nullptr` if no instance exists.
+         */
+        static JobSystem* instance();
+
+        /**
+         * @brief Constructor
+         * @param workerCount   Count of worker threads. If
+         *      @ref AutomaticWorkerCount, count of hardware threads minus one
+         *      is used, as the thread calling wait() participates in the work
+         *      too. If `0`, all jobs are executed serially on the thread
+         *      which adds them.
+         *
+         * Sets global instance to this, if there is none yet.
+         */
+        explicit JobSystem(UnsignedInt workerCount = AutomaticWorkerCount);
+
+        /**
+         * @brief Destructor
+         *
+         * Waits for all running jobs to finish, unscheduled jobs are
+         * discarded.
+         */
+        ~JobSystem();
+
+        /** @brief Count of worker threads */
+        inline UnsignedInt workerCount() const { return workers.size(); }
+
+        /**
+         * @brief Add job
+         * @param function      Function to execute
+         * @param dependencies  Jobs which need to finish before this job is
+         *      executed
+         *
+         * The job is scheduled immediately if it has no unfinished
+         * dependencies.
+         */
+        JobHandle add(std::function<void()> function, std::initializer_list<JobHandle> dependencies = {});
+
+        /** @overload */
+        JobHandle add(std::function<void()> function, const std::vector<JobHandle>& dependencies);
+
+        /** @brief Whether given job is finished */
+        static bool isFinished(const JobHandle& job);
+
+        /**
+         * @brief Wait for job to finish
+         *
+         * Executes other jobs while waiting.
+         */
+        void wait(const JobHandle& job);
+
+        /** @brief Wait for all given jobs to finish */
+        void wait(const std::vector<JobHandle>& jobs);
+
+        /**
+         * @brief Parallel for
+         * @param begin         Beginning of the range
+         * @param end           End of the range
+         * @param grainSize     Max count of items processed in one job
+         * @param function      Function processing subrange `[first, last)`
+         *
+         * Splits the range into jobs and waits for all of them. The calling
+         * thread participates in the work.
+         */
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)>& function);
+
+    private:
+        struct Worker {
+            std::thread thread;
+            std::thread::id id;
+            std::mutex mutex;
+            std::deque<JobHandle> jobs;
+        };
+
+        void addDependencies(const JobHandle& job, const JobHandle* begin, const JobHandle* end);
+        void schedule(JobHandle job);
+        void run(const JobHandle& job);
+        JobHandle take(Int current);
+        Int currentWorker() const;
+        void workerLoop(UnsignedInt index);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<UnsignedInt> startedCount, nextWorker;
+        std::atomic<std::size_t> queuedCount;
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        bool stopping;
+};
+
+struct JobSystem::Job {
+    std::function<void()> function;
+
+    /* Unfinished dependencies, plus one while the job is being set up */
+    std::atomic<UnsignedInt> pendingDependencies;
+
+    /* Guards dependents and finished flag */
+    std::mutex mutex;
+    std::vector<JobHandle> dependents;
+    std::atomic<bool> finished;
+};
+
+}}
+
+#endif
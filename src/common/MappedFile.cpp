@@ -0,0 +1,99 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+MappedFile::MappedFile(const std::string& filename): mappedData(nullptr), mappedSize(0) {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1) {
+        Error() << "MappedFile: cannot open" << filename;
+        return;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) == -1 || info.st_size == 0) {
+        Error() << "MappedFile: cannot map empty file" << filename;
+        close(fd);
+        return;
+    }
+
+    /* The mapping keeps the file referenced, descriptor is not needed */
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(data == MAP_FAILED) {
+        Error() << "MappedFile: cannot map" << filename;
+        return;
+    }
+
+    mappedData = static_cast<const char*>(data);
+    mappedSize = info.st_size;
+}
+
+MappedFile::~MappedFile() {
+    if(mappedData) munmap(const_cast<char*>(mappedData), mappedSize);
+}
+
+void MappedFile::adviseSequential(std::size_t offset, std::size_t size) {
+    if(!mappedData || offset >= mappedSize) return;
+
+    /* madvise() needs page-aligned address */
+    const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    const std::size_t begin = offset/pageSize*pageSize;
+    const std::size_t end = std::min(offset + size, mappedSize);
+    char* const data = const_cast<char*>(mappedData) + begin;
+    madvise(data, end - begin, MADV_SEQUENTIAL);
+    madvise(data, end - begin, MADV_WILLNEED);
+}
+
+void MappedFile::adviseWillNeed(std::size_t offset, std::size_t size) {
+    if(!mappedData || offset >= mappedSize) return;
+
+    const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    const std::size_t begin = offset/pageSize*pageSize;
+    const std::size_t end = std::min(offset + size, mappedSize);
+    madvise(const_cast<char*>(mappedData) + begin, end - begin, MADV_WILLNEED);
+}
+
+void MappedFile::adviseDontNeed(std::size_t offset, std::size_t size) {
+    if(!mappedData || offset >= mappedSize) return;
+
+    /* Round inwards, so pages shared with neighboring data are kept. The end
+       of the file is the end of the last page. */
+    const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    const std::size_t begin = (offset + pageSize - 1)/pageSize*pageSize;
+    const std::size_t end = offset + size >= mappedSize ? mappedSize : (offset + size)/pageSize*pageSize;
+    if(begin >= end) return;
+    madvise(const_cast<char*>(mappedData) + begin, end - begin, MADV_DONTNEED);
+}
+
+}}
@@ -0,0 +1,94 @@
+#ifndef Magnum_Examples_MappedFile_h
+#define Magnum_Examples_MappedFile_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstddef>
+#include <string>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Read-only memory-mapped file
+
+The file contents are paged in by the OS on first access, so even files larger
+than physical memory can be processed without reading them in full. Data are
+valid for the whole lifetime of the instance.
+*/
+class MappedFile {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * Maps whole file. If the file cannot be opened or is empty, prints
+         * error message and isOpen() returns `false`.
+         */
+        explicit MappedFile(const std::string& filename);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /** @brief Unmaps the file */
+        ~MappedFile();
+
+        /** @brief Whether the file is mapped */
+        inline bool isOpen() const { return mappedData; }
+
+        /** @brief File contents */
+        inline const char* data() const { return mappedData; }
+
+        /** @brief File size */
+        inline std::size_t size() const { return mappedSize; }
+
+        /**
+         * @brief Hint that given range will be read sequentially
+         *
+         * Enables aggressive read-ahead for given range.
+         */
+        void adviseSequential(std::size_t offset, std::size_t size);
+
+        /**
+         * @brief Hint that given range will be needed soon
+         *
+         * Starts reading the range in background, so later access doesn't
+         * block on disk.
+         */
+        void adviseWillNeed(std::size_t offset, std::size_t size);
+
+        /**
+         * @brief Hint that given range won't be needed
+         *
+         * Releases pages fully inside the range from memory. The data stay
+         * accessible, on next access they are read from the file again.
+         */
+        void adviseDontNeed(std::size_t offset, std::size_t size);
+
+    private:
+        const char* mappedData;
+        std::size_t mappedSize;
+};
+
+}}
+
+#endif
@@ -0,0 +1,221 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PostProcessing.h"
+
+#include <sstream>
+#include <Renderer.h>
+#include <Shader.h>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+/* Fullscreen triangle without any vertex buffer, texture coordinates span
+   given part of the input */
+constexpr const char* VertexSource = R"(
+uniform vec4 textureRectangle;
+
+out vec2 textureCoords;
+
+void main() {
+    gl_Position = vec4(gl_VertexID == 1 ? 3.0 : -1.0,
+                       gl_VertexID == 2 ? 3.0 : -1.0, 0.0, 1.0);
+    textureCoords = textureRectangle.xy + (gl_Position.xy*0.5 + vec2(0.5))*textureRectangle.zw;
+}
+)";
+
+std::string effectPrefix(std::size_t index) {
+    std::ostringstream out;
+    out << "effect" << index << '_';
+    return out.str();
+}
+
+}
+
+PostProcessingShader::PostProcessingShader(const std::string& fragmentSource) {
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, VertexSource));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, fragmentSource));
+
+    link();
+
+    setUniform(uniform("inputTexture"), InputTextureLayer);
+}
+
+Int PostProcessingShader::uniform(const std::string& name) {
+    auto found = locations.find(name);
+    if(found != locations.end()) return found->second;
+
+    const Int location = uniformLocation(name);
+    locations.emplace(name, location);
+    return location;
+}
+
+PostProcessingEffect::~PostProcessingEffect() = default;
+
+bool PostProcessingEffect::isPointwise() const { return true; }
+
+std::string PostProcessingEffect::declarations(const std::string&) const { return {}; }
+
+Int PostProcessingEffect::textureCount() const { return 0; }
+
+void PostProcessingEffect::bind(PostProcessingShader&, const std::string&, Int) {}
+
+PostProcessingChain::PostProcessingChain(const Vector2i& size): inputSize(size), fusion(true), dirty(true) {
+    fullscreenTriangle.setPrimitive(Mesh::Primitive::Triangles)
+        ->setVertexCount(3);
+}
+
+PostProcessingChain::~PostProcessingChain() = default;
+
+PostProcessingChain* PostProcessingChain::setFusionEnabled(bool enabled) {
+    if(fusion != enabled) dirty = true;
+    fusion = enabled;
+    return this;
+}
+
+std::size_t PostProcessingChain::passCount() {
+    if(dirty) compile();
+    return passes.size();
+}
+
+std::string PostProcessingChain::fragmentSource(std::size_t pass) {
+    if(dirty) compile();
+    return passes[pass].source;
+}
+
+void PostProcessingChain::setSize(const Vector2i& size) {
+    if(inputSize == size) return;
+
+    inputSize = size;
+    if(targets[0]) createTargets();
+}
+
+void PostProcessingChain::createTargets() {
+    for(std::size_t i = 0; i != 2; ++i) {
+        /* Immutable storage can't be resized, create new texture */
+        targetTextures[i].reset(new Texture2D);
+        targetTextures[i]->setMinificationFilter(Texture2D::Filter::Linear)
+            ->setMagnificationFilter(Texture2D::Filter::Linear)
+            ->setWrapping(Texture2D::Wrapping::ClampToEdge)
+            ->setStorage(1, Texture2D::InternalFormat::RGBA8, inputSize);
+
+        targets[i].reset(new Framebuffer({{}, inputSize}));
+        targets[i]->attachTexture2D(Framebuffer::ColorAttachment(0), targetTextures[i].get(), 0);
+    }
+}
+
+std::string PostProcessingChain::generate(std::size_t begin, std::size_t end) const {
+    std::ostringstream out;
+    out << "uniform sampler2D inputTexture;\n"
+           "uniform vec2 texelSize;\n"
+           "in vec2 textureCoords;\n"
+           "out vec4 fragmentColor;\n\n";
+    for(std::size_t i = begin; i != end; ++i)
+        out << effects[i]->declarations(effectPrefix(i)) << '\n';
+
+    /* Effect which isn't pointwise reads the input itself, only the first
+       effect in a pass can be such */
+    out << "void main() {\n";
+    if(begin == end || effects[begin]->isPointwise())
+        out << "    vec4 color = texture(inputTexture, textureCoords);\n";
+    else out << "    vec4 color;\n";
+    for(std::size_t i = begin; i != end; ++i)
+        out << "    {\n" << effects[i]->code(effectPrefix(i)) << "\n    }\n";
+    out << "    fragmentColor = color;\n"
+           "}\n";
+    return out.str();
+}
+
+void PostProcessingChain::compile() {
+    passes.clear();
+
+    /* Split the effects into passes, each starting with effect which isn't
+       pointwise or with all effects separate if fusion is disabled. Empty
+       chain just copies the input. */
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    for(std::size_t i = 0; i != effects.size(); ++i) {
+        if(ranges.empty() || !fusion || !effects[i]->isPointwise())
+            ranges.emplace_back(i, i + 1);
+        else ranges.back().second = i + 1;
+    }
+    if(ranges.empty()) ranges.emplace_back(0, 0);
+
+    for(const auto& range: ranges) {
+        Pass pass;
+        pass.source = generate(range.first, range.second);
+        pass.begin = range.first;
+        pass.end = range.second;
+
+        std::unique_ptr<PostProcessingShader>& shader = shaders[pass.source];
+        if(!shader) shader.reset(new PostProcessingShader(pass.source));
+        pass.shader = shader.get();
+        passes.push_back(pass);
+    }
+
+    dirty = false;
+}
+
+void PostProcessingChain::draw(Texture2D* input, AbstractFramebuffer& output, const Rectanglei& outputRectangle, const Rectangle& inputRectangle) {
+    if(dirty) compile();
+    if(passes.size() > 1 && !targets[0]) createTargets();
+
+    Renderer::setFeature(Renderer::Feature::DepthTest, false);
+
+    const Rectanglei outputViewport = output.viewport();
+    Texture2D* source = input;
+    for(std::size_t i = 0; i != passes.size(); ++i) {
+        const Pass& pass = passes[i];
+        const bool last = i + 1 == passes.size();
+
+        /* Intermediate passes process the whole input, the last one only
+           the requested part */
+        Rectangle textureRectangle = {{}, Vector2(1.0f)};
+        if(last) {
+            output.setViewport(outputRectangle);
+            output.bind(AbstractFramebuffer::Target::Draw);
+            textureRectangle = inputRectangle;
+        } else targets[i%2]->bind(AbstractFramebuffer::Target::Draw);
+
+        source->bind(PostProcessingShader::InputTextureLayer);
+        pass.shader->setUniform(pass.shader->uniform("textureRectangle"), Vector4(textureRectangle.bottomLeft().x(), textureRectangle.bottomLeft().y(), textureRectangle.size().x(), textureRectangle.size().y()));
+        pass.shader->setUniform(pass.shader->uniform("texelSize"), Vector2(1.0f)/Vector2(inputSize));
+
+        Int layer = PostProcessingShader::InputTextureLayer + 1;
+        for(std::size_t j = pass.begin; j != pass.end; ++j) {
+            effects[j]->bind(*pass.shader, effectPrefix(j), layer);
+            layer += effects[j]->textureCount();
+        }
+
+        pass.shader->use();
+        fullscreenTriangle.draw();
+
+        if(!last) source = targetTextures[i%2].get();
+    }
+
+    output.setViewport(outputViewport);
+    Renderer::setFeature(Renderer::Feature::DepthTest, true);
+}
+
+}}
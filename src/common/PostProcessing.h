@@ -0,0 +1,218 @@
+#ifndef Magnum_Examples_PostProcessing_h
+#define Magnum_Examples_PostProcessing_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <AbstractShaderProgram.h>
+#include <Framebuffer.h>
+#include <Mesh.h>
+#include <Texture.h>
+#include <Math/Geometry/Rectangle.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Shader of one post-processing pass
+
+Generated by @ref PostProcessingChain from code of the effects in the pass.
+Uniform locations are queried only once and then cached.
+*/
+class PostProcessingShader: public AbstractShaderProgram {
+    public:
+        enum: Int {
+            InputTextureLayer = 0   /**< @brief Layer of pass input texture */
+        };
+
+        /**
+         * @brief Constructor
+         * @param fragmentSource    Fragment shader source without version
+         *      directive
+         */
+        explicit PostProcessingShader(const std::string& fragmentSource);
+
+        /** @brief Uniform location */
+        Int uniform(const std::string& name);
+
+        using AbstractShaderProgram::setUniform;
+
+    private:
+        std::unordered_map<std::string, Int> locations;
+};
+
+/**
+@brief Post-processing effect
+
+Effect is described by GLSL code, which is pasted into generated shader
+together with code of other effects in the same pass. All names in the
+declarations should begin with given prefix, so more instances of the same
+effect can be in one pass.
+*/
+class PostProcessingEffect {
+    public:
+        virtual ~PostProcessingEffect();
+
+        /**
+         * @brief Whether the effect is pointwise
+         *
+         * Pointwise effect reads only the input pixel at the same position,
+         * so it can be fused into one pass with effects before it. Default
+         * is `true`.
+         */
+        virtual bool isPointwise() const;
+
+        /** @brief GLSL declarations of uniforms and functions */
+        virtual std::string declarations(const std::string& prefix) const;
+
+        /**
+         * @brief GLSL code of the effect
+         *
+         * Pointwise effect modifies `vec4 color`, which contains result of
+         * previous effect. Other effects set `color` from `sampler2D
+         * inputTexture`, which contains result of the previous pass. Both
+         * can use `vec2 textureCoords` and `vec2 texelSize`.
+         */
+        virtual std::string code(const std::string& prefix) const = 0;
+
+        /** @brief Count of textures used by the effect */
+        virtual Int textureCount() const;
+
+        /**
+         * @brief Set uniforms and bind textures
+         * @param shader            Shader of the pass
+         * @param prefix            Name prefix
+         * @param firstTextureLayer First texture layer available to the
+         *      effect, textureCount() layers are reserved
+         *
+         * Called before each draw of the pass.
+         */
+        virtual void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer);
+};
+
+/**
+@brief Post-processing chain
+
+Applies list of effects to a texture, drawing the result into a framebuffer.
+Adjacent pointwise effects are fused into one generated shader and thus
+drawn in one full-screen pass, so the chain reads and writes each pixel only
+once for all of them. Each effect which isn't pointwise starts a new pass,
+the effects after it are again fused into its pass. Passes before the last
+one draw into intermediate RGBA8 textures of the input size.
+
+The generated shaders are cached by their source, so switching fusion on and
+off or rebuilding the chain with the same effects doesn't compile anything.
+*/
+class PostProcessingChain {
+    public:
+        /**
+         * @brief Constructor
+         * @param size      Input texture size
+         */
+        explicit PostProcessingChain(const Vector2i& size);
+
+        ~PostProcessingChain();
+
+        /**
+         * @brief Add effect
+         *
+         * The chain takes ownership of the effect. Returns the effect for
+         * setting its parameters.
+         */
+        template<class T> T* add(T* effect) {
+            effects.emplace_back(effect);
+            dirty = true;
+            return effect;
+        }
+
+        /** @brief Effect count */
+        inline std::size_t effectCount() const { return effects.size(); }
+
+        /** @brief Whether pointwise effects are fused */
+        inline bool isFusionEnabled() const { return fusion; }
+
+        /**
+         * @brief Enable or disable fusion
+         *
+         * If disabled, each effect is drawn in separate pass, which is useful
+         * for comparing the cost. Enabled by default.
+         */
+        PostProcessingChain* setFusionEnabled(bool enabled);
+
+        /** @brief Pass count */
+        std::size_t passCount();
+
+        /** @brief Generated fragment shader source of given pass */
+        std::string fragmentSource(std::size_t pass);
+
+        /** @brief Input size */
+        inline Vector2i size() const { return inputSize; }
+
+        /** @brief Set input size */
+        void setSize(const Vector2i& size);
+
+        /**
+         * @brief Draw the chain
+         * @param input             Input texture
+         * @param output            Output framebuffer
+         * @param outputRectangle   Part of output framebuffer to draw to
+         * @param inputRectangle    Part of the input drawn there, in texture
+         *      coordinates
+         *
+         * Depth test is disabled during the drawing and enabled again
+         * afterwards, output framebuffer viewport is restored.
+         */
+        void draw(Texture2D* input, AbstractFramebuffer& output, const Rectanglei& outputRectangle, const Rectangle& inputRectangle = {{}, Vector2(1.0f)});
+
+        /** @overload */
+        inline void draw(Texture2D* input, AbstractFramebuffer& output) {
+            draw(input, output, output.viewport());
+        }
+
+    private:
+        struct Pass {
+            PostProcessingShader* shader;
+            std::string source;
+            std::size_t begin, end;
+        };
+
+        std::string generate(std::size_t begin, std::size_t end) const;
+        void compile();
+        void createTargets();
+
+        std::vector<std::unique_ptr<PostProcessingEffect>> effects;
+        std::vector<Pass> passes;
+        std::unordered_map<std::string, std::unique_ptr<PostProcessingShader>> shaders;
+        Vector2i inputSize;
+        std::unique_ptr<Texture2D> targetTextures[2];
+        std::unique_ptr<Framebuffer> targets[2];
+        Mesh fullscreenTriangle;
+        bool fusion, dirty;
+};
+
+}}
+
+#endif
@@ -0,0 +1,167 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PostProcessingEffects.h"
+
+#include <sstream>
+#include <Utility/Assert.h>
+
+#include "ShaderVariants.h"
+
+namespace Magnum { namespace Examples {
+
+GrayscaleEffect::GrayscaleEffect(): amount(1.0f) {}
+
+std::string GrayscaleEffect::declarations(const std::string& prefix) const {
+    return "uniform float " + prefix + "amount;\n";
+}
+
+std::string GrayscaleEffect::code(const std::string& prefix) const {
+    return "        float gray = dot(color.rgb, vec3(0.3, 0.59, 0.11));\n"
+           "        color.rgb = mix(color.rgb, vec3(gray), " + prefix + "amount);";
+}
+
+void GrayscaleEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int) {
+    shader.setUniform(shader.uniform(prefix + "amount"), amount);
+}
+
+Lut1DEffect::Lut1DEffect(Buffer* buffer, UnsignedInt size): size(size) {
+    texture.setBuffer(BufferTexture::InternalFormat::R32F, buffer);
+}
+
+std::string Lut1DEffect::declarations(const std::string& prefix) const {
+    ShaderDefines defines;
+    defines.define(prefix + "SIZE", Int(size));
+
+    std::ostringstream out;
+    out << defines.source()
+        << "uniform samplerBuffer " << prefix << "table;\n"
+        << "float " << prefix << "lookup(float value) {\n"
+        << "    return texelFetch(" << prefix << "table, int(clamp(value, 0.0, 1.0)*(" << prefix << "SIZE - 1) + 0.5)).r;\n"
+        << "}\n";
+    return out.str();
+}
+
+std::string Lut1DEffect::code(const std::string& prefix) const {
+    return "        color.rgb = vec3(" + prefix + "lookup(color.r), " + prefix + "lookup(color.g), " + prefix + "lookup(color.b));";
+}
+
+Int Lut1DEffect::textureCount() const { return 1; }
+
+void Lut1DEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) {
+    texture.bind(firstTextureLayer);
+    shader.setUniform(shader.uniform(prefix + "table"), firstTextureLayer);
+}
+
+Lut3DEffect::Lut3DEffect(Texture3D* texture, UnsignedInt size): texture(texture), size(size) {}
+
+std::string Lut3DEffect::declarations(const std::string& prefix) const {
+    ShaderDefines defines;
+    defines.define(prefix + "SIZE", Float(size));
+    return defines.source() + "uniform sampler3D " + prefix + "table;\n";
+}
+
+std::string Lut3DEffect::code(const std::string& prefix) const {
+    /* Centers of the edge texels are at 0.5/size and 1 - 0.5/size */
+    return "        color.rgb = texture(" + prefix + "table, clamp(color.rgb, 0.0, 1.0)*((" + prefix + "SIZE - 1.0)/" + prefix + "SIZE) + vec3(0.5/" + prefix + "SIZE)).rgb;";
+}
+
+Int Lut3DEffect::textureCount() const { return 1; }
+
+void Lut3DEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) {
+    texture->bind(firstTextureLayer);
+    shader.setUniform(shader.uniform(prefix + "table"), firstTextureLayer);
+}
+
+FrameBlendEffect::FrameBlendEffect(UnsignedInt frameCount): frameCount(frameCount) {}
+
+FrameBlendEffect* FrameBlendEffect::setFrames(std::vector<Texture2D*> frames) {
+    CORRADE_ASSERT(frames.size() == frameCount, "FrameBlendEffect::setFrames(): expected" << frameCount << "frames, got" << frames.size(), this);
+    this->frames = std::move(frames);
+    return this;
+}
+
+std::string FrameBlendEffect::declarations(const std::string& prefix) const {
+    ShaderDefines defines;
+    defines.define(prefix + "FRAME_COUNT", Int(frameCount));
+    return defines.source() + "uniform sampler2D " + prefix + "frames[" + prefix + "FRAME_COUNT];\n";
+}
+
+std::string FrameBlendEffect::code(const std::string& prefix) const {
+    return "        vec3 sum = color.rgb;\n"
+           "        for(int i = 0; i != " + prefix + "FRAME_COUNT; ++i)\n"
+           "            sum += texture(" + prefix + "frames[i], textureCoords).rgb;\n"
+           "        color.rgb = sum/float(" + prefix + "FRAME_COUNT + 1);";
+}
+
+Int FrameBlendEffect::textureCount() const { return frameCount; }
+
+void FrameBlendEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) {
+    std::ostringstream name;
+    for(Int i = 0; i != Int(frames.size()); ++i) {
+        frames[i]->bind(firstTextureLayer + i);
+        name.str("");
+        name << prefix << "frames[" << i << "]";
+        shader.setUniform(shader.uniform(name.str()), firstTextureLayer + i);
+    }
+}
+
+VignetteEffect::VignetteEffect(): strength(0.5f), radius(0.6f) {}
+
+std::string VignetteEffect::declarations(const std::string& prefix) const {
+    return "uniform float " + prefix + "strength;\n"
+           "uniform float " + prefix + "radius;\n";
+}
+
+std::string VignetteEffect::code(const std::string& prefix) const {
+    return "        float centerDistance = length(textureCoords - vec2(0.5))*1.41421356;\n"
+           "        color.rgb *= 1.0 - " + prefix + "strength*smoothstep(" + prefix + "radius, 1.0, centerDistance);";
+}
+
+void VignetteEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int) {
+    shader.setUniform(shader.uniform(prefix + "strength"), strength);
+    shader.setUniform(shader.uniform(prefix + "radius"), radius);
+}
+
+BlurEffect::BlurEffect(): radius(1.0f) {}
+
+bool BlurEffect::isPointwise() const { return false; }
+
+std::string BlurEffect::declarations(const std::string& prefix) const {
+    return "uniform float " + prefix + "radius;\n";
+}
+
+std::string BlurEffect::code(const std::string& prefix) const {
+    return "        color = vec4(0.0);\n"
+           "        for(int y = -1; y <= 1; ++y) for(int x = -1; x <= 1; ++x)\n"
+           "            color += texture(inputTexture, textureCoords + vec2(x, y)*texelSize*" + prefix + "radius)*\n"
+           "                (x == 0 ? 2.0 : 1.0)*(y == 0 ? 2.0 : 1.0);\n"
+           "        color /= 16.0;";
+}
+
+void BlurEffect::bind(PostProcessingShader& shader, const std::string& prefix, Int) {
+    shader.setUniform(shader.uniform(prefix + "radius"), radius);
+}
+
+}}
@@ -0,0 +1,206 @@
+#ifndef Magnum_Examples_PostProcessingEffects_h
+#define Magnum_Examples_PostProcessingEffects_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <BufferTexture.h>
+#include <Texture.h>
+
+#include "PostProcessing.h"
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Grayscale effect
+
+Mixes the color with its luminance.
+*/
+class GrayscaleEffect: public PostProcessingEffect {
+    public:
+        explicit GrayscaleEffect();
+
+        /**
+         * @brief Set amount
+         *
+         * `0` keeps the original color, `1` is fully grayscale. Default is
+         * `1`.
+         */
+        inline GrayscaleEffect* setAmount(Float amount) {
+            this->amount = amount;
+            return this;
+        }
+
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        Float amount;
+};
+
+/**
+@brief 1D lookup table effect
+
+Maps each color channel through the same curve, stored as floats in a buffer
+texture. The table size is compiled into the shader.
+*/
+class Lut1DEffect: public PostProcessingEffect {
+    public:
+        /**
+         * @brief Constructor
+         * @param buffer    Buffer with @p size float values
+         * @param size      Table size
+         */
+        explicit Lut1DEffect(Buffer* buffer, UnsignedInt size);
+
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        Int textureCount() const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        BufferTexture texture;
+        UnsignedInt size;
+};
+
+/**
+@brief 3D lookup table effect
+
+Maps the color through RGB cube with linear filtering. Texture coordinates
+are adjusted so input `0` and `1` are at centers of the edge texels.
+*/
+class Lut3DEffect: public PostProcessingEffect {
+    public:
+        /**
+         * @brief Constructor
+         * @param texture   Texture with the table, expected to have linear
+         *      filtering and clamp to edge wrapping
+         * @param size      Table size in each dimension
+         */
+        explicit Lut3DEffect(Texture3D* texture, UnsignedInt size);
+
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        Int textureCount() const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        Texture3D* texture;
+        UnsignedInt size;
+};
+
+/**
+@brief Frame blending effect
+
+Averages the color with the same pixel of previous frames, e.g. for motion
+blur. The frame count is compiled into the shader.
+*/
+class FrameBlendEffect: public PostProcessingEffect {
+    public:
+        /**
+         * @brief Constructor
+         * @param frameCount    Count of previous frames
+         */
+        explicit FrameBlendEffect(UnsignedInt frameCount);
+
+        /**
+         * @brief Set previous frames
+         *
+         * Expects frameCount textures. Their order doesn't matter.
+         */
+        FrameBlendEffect* setFrames(std::vector<Texture2D*> frames);
+
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        Int textureCount() const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        UnsignedInt frameCount;
+        std::vector<Texture2D*> frames;
+};
+
+/**
+@brief Vignette effect
+
+Darkens the color towards corners of the input.
+*/
+class VignetteEffect: public PostProcessingEffect {
+    public:
+        explicit VignetteEffect();
+
+        /**
+         * @brief Set strength and radius
+         *
+         * Darkening starts at @p radius, relative to distance between center
+         * and corner, and reaches @p strength in the corners. Default is
+         * `0.5` and `0.6`.
+         */
+        inline VignetteEffect* setParameters(Float strength, Float radius) {
+            this->strength = strength;
+            this->radius = radius;
+            return this;
+        }
+
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        Float strength, radius;
+};
+
+/**
+@brief Blur effect
+
+3x3 Gaussian blur. Reads neighbor pixels, so it is not pointwise and starts
+a new pass.
+*/
+class BlurEffect: public PostProcessingEffect {
+    public:
+        explicit BlurEffect();
+
+        /**
+         * @brief Set distance of the samples in pixels
+         *
+         * Default is `1`.
+         */
+        inline BlurEffect* setRadius(Float radius) {
+            this->radius = radius;
+            return this;
+        }
+
+        bool isPointwise() const override;
+        std::string declarations(const std::string& prefix) const override;
+        std::string code(const std::string& prefix) const override;
+        void bind(PostProcessingShader& shader, const std::string& prefix, Int firstTextureLayer) override;
+
+    private:
+        Float radius;
+};
+
+}}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ShaderVariants.h"
+
+#include <sstream>
+
+namespace Magnum { namespace Examples {
+
+ShaderDefines* ShaderDefines::define(const std::string& name, Int value) {
+    std::ostringstream out;
+    out << value;
+    return define(name, out.str());
+}
+
+ShaderDefines* ShaderDefines::define(const std::string& name, UnsignedInt value) {
+    std::ostringstream out;
+    out << value << 'u';
+    return define(name, out.str());
+}
+
+ShaderDefines* ShaderDefines::define(const std::string& name, Float value) {
+    std::ostringstream out;
+    out.precision(9);
+    out << std::showpoint << value;
+    return define(name, out.str());
+}
+
+ShaderDefines* ShaderDefines::define(const std::string& name, bool value) {
+    return define(name, std::string(value ? "1" : "0"));
+}
+
+ShaderDefines* ShaderDefines::define(const std::string& name, const std::string& value) {
+    /* Redefinition replaces the previous value instead of adding a line */
+    for(auto& d: defines) if(d.first == name) {
+        d.second = value;
+        return this;
+    }
+
+    defines.emplace_back(name, value);
+    return this;
+}
+
+std::string ShaderDefines::source() const {
+    std::string out;
+    for(const auto& d: defines)
+        out += "#define " + d.first + ' ' + d.second + '\n';
+    return out;
+}
+
+}}
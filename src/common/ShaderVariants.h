@@ -0,0 +1,132 @@
+#ifndef Magnum_Examples_ShaderVariants_h
+#define Magnum_Examples_ShaderVariants_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Preprocessor defines of a shader variant
+
+Constants shared by C++ and GLSL code (cluster grid size, table sizes, frame
+counts) are passed to the shader as `#define`s generated from the C++
+values, so they can't get out of sync and the driver sees them as constants,
+unrolling the loops and folding the branches. Prepend source() to the shader
+source after the version directive, e.g.:
+@code
+ShaderDefines defines;
+defines.define("SLICE_COUNT", ClusteredLighting::SliceCount)
+    ->define("SPECULAR", true);
+attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment,
+    defines.source() + rs.get("Shader.frag")));
+@endcode
+
+Floats are always written with decimal point and unsigned values with `u`
+suffix, so they have the expected type also in GLSL expressions. Booleans
+are written as `1` and `0` to be usable in `#if`.
+*/
+class ShaderDefines {
+    public:
+        /** @brief Define integer constant */
+        ShaderDefines* define(const std::string& name, Int value);
+
+        /** @brief Define unsigned integer constant */
+        ShaderDefines* define(const std::string& name, UnsignedInt value);
+
+        /** @brief Define float constant */
+        ShaderDefines* define(const std::string& name, Float value);
+
+        /** @brief Define boolean constant */
+        ShaderDefines* define(const std::string& name, bool value);
+
+        /** @brief Define constant with custom GLSL value */
+        ShaderDefines* define(const std::string& name, const std::string& value);
+
+        /** @overload */
+        inline ShaderDefines* define(const std::string& name, const char* value) {
+            return define(name, std::string(value));
+        }
+
+        /**
+         * @brief Define constant from C++ enum value
+         *
+         * Enums with compile-time constants are converted to integers.
+         */
+        template<class T> inline typename std::enable_if<std::is_enum<T>::value, ShaderDefines*>::type define(const std::string& name, T value) {
+            return define(name, Int(value));
+        }
+
+        /**
+         * @brief Source with the defines
+         *
+         * The defines are in the order they were added, one per line. The
+         * source is also used as variant key in @ref ShaderVariants.
+         */
+        std::string source() const;
+
+        /** @brief Whether there are no defines */
+        inline bool isEmpty() const { return defines.empty(); }
+
+    private:
+        std::vector<std::pair<std::string, std::string>> defines;
+};
+
+/**
+@brief Cache of shader variants
+
+Compiles each variant of shader `T` only once, the shader is expected to have
+constructor taking @ref ShaderDefines. The variants are kept until the cache
+is destroyed.
+*/
+template<class T> class ShaderVariants {
+    public:
+        /**
+         * @brief Shader variant for given defines
+         *
+         * Compiles and links the shader on first request.
+         */
+        T* get(const ShaderDefines& defines) {
+            std::unique_ptr<T>& shader = variants[defines.source()];
+            if(!shader) shader.reset(new T(defines));
+            return shader.get();
+        }
+
+        /** @brief Count of compiled variants */
+        inline std::size_t count() const { return variants.size(); }
+
+    private:
+        std::unordered_map<std::string, std::unique_ptr<T>> variants;
+};
+
+}}
+
+#endif
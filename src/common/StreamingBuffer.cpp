@@ -0,0 +1,101 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "StreamingBuffer.h"
+
+#include <Utility/Assert.h>
+
+namespace Magnum { namespace Examples {
+
+StreamingBuffer::StreamingBuffer(GLsizeiptr regionSize, Buffer::Target target): ringBuffer(target), target(target), size(regionSize), used(0), region(RegionCount-1), stalls(0), persistent(false), mapped(nullptr), fences() {
+    #ifdef GL_ARB_buffer_storage
+    /* Immutable storage mapped once for the whole lifetime */
+    if(GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT|GL_MAP_PERSISTENT_BIT|GL_MAP_COHERENT_BIT;
+        ringBuffer.bind(target);
+        glBufferStorage(static_cast<GLenum>(target), size*RegionCount, nullptr, flags);
+        mapped = static_cast<char*>(glMapBufferRange(static_cast<GLenum>(target), 0, size*RegionCount, flags));
+        persistent = mapped != nullptr;
+    }
+    #endif
+
+    /* Mutable storage mapped each frame */
+    if(!persistent)
+        ringBuffer.setData(size*RegionCount, nullptr, Buffer::Usage::StreamDraw);
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    for(GLsync fence: fences) if(fence) glDeleteSync(fence);
+
+    if(persistent) ringBuffer.unmap();
+}
+
+void StreamingBuffer::beginFrame() {
+    region = (region+1)%RegionCount;
+    used = 0;
+
+    /* Wait until the GPU is done with the region. The first check doesn't
+       flush, so it is cheap if the fence is already signaled. */
+    if(fences[region]) {
+        if(glClientWaitSync(fences[region], 0, 0) == GL_TIMEOUT_EXPIRED) {
+            ++stalls;
+            while(glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        }
+
+        glDeleteSync(fences[region]);
+        fences[region] = nullptr;
+    }
+
+    if(!persistent)
+        mapped = static_cast<char*>(ringBuffer.mapRange(region*size, size,
+            Buffer::MapFlag::Write|Buffer::MapFlag::Unsynchronized|Buffer::MapFlag::FlushExplicit));
+}
+
+StreamingBuffer::Allocation StreamingBuffer::allocate(GLsizeiptr allocationSize, GLsizeiptr alignment) {
+    CORRADE_ASSERT(mapped, "StreamingBuffer::allocate(): no frame in progress", (Allocation{0, nullptr}));
+
+    const GLsizeiptr regionOffset = region*size;
+    const GLsizeiptr offset = (regionOffset + used + alignment - 1)/alignment*alignment - regionOffset;
+    if(offset + allocationSize > size) return {0, nullptr};
+
+    used = offset + allocationSize;
+    return {regionOffset + offset, persistent ? mapped + regionOffset + offset : mapped + offset};
+}
+
+void StreamingBuffer::commit() {
+    if(persistent) return;
+
+    if(mapped) {
+        ringBuffer.flushMappedRange(0, used);
+        ringBuffer.unmap();
+        mapped = nullptr;
+    }
+}
+
+void StreamingBuffer::endFrame() {
+    commit();
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+}}
@@ -0,0 +1,139 @@
+#ifndef Magnum_Examples_StreamingBuffer_h
+#define Magnum_Examples_StreamingBuffer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Buffer.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Streaming buffer for per-frame data
+
+Buffer divided into @ref RegionCount equally sized regions used as a ring, one
+region per frame. Per-frame vertex, uniform or instance data are written
+directly into the buffer memory via sub-allocations from the current region,
+so there is no driver-side copy as with @ref Buffer::setSubData(). Each
+region is protected by a fence, which is waited for only when the ring wraps
+around and the GPU is still using the region.
+
+If @extension{ARB,buffer_storage} is supported, the whole buffer is mapped
+persistently and coherently once at construction. Otherwise the current region
+is mapped at the beginning of each frame with unsynchronized mapping (the
+fences take care of the synchronization) and unmapped in commit().
+
+Usage per frame:
+@code
+stream.beginFrame();
+StreamingBuffer::Allocation a = stream.allocate(size);
+// write the data into a.data...
+stream.commit();
+// draw using the data at a.offset...
+stream.endFrame();
+@endcode
+*/
+class StreamingBuffer {
+    public:
+        enum: UnsignedInt {
+            RegionCount = 3     /**< @brief Region count (triple buffering) */
+        };
+
+        /** @brief Sub-allocation */
+        struct Allocation {
+            GLintptr offset;    /**< @brief Offset from the buffer beginning */
+            void* data;         /**< @brief Mapped memory, `nullptr` if failed */
+        };
+
+        /**
+         * @brief Constructor
+         * @param regionSize    Size of one region (i.e. max size of data
+         *      written in one frame)
+         * @param target        Target hint for the buffer
+         */
+        explicit StreamingBuffer(GLsizeiptr regionSize, Buffer::Target target = Buffer::Target::Array);
+
+        ~StreamingBuffer();
+
+        /** @brief Underlying buffer */
+        inline Buffer& buffer() { return ringBuffer; }
+
+        /** @brief Size of one region */
+        inline GLsizeiptr regionSize() const { return size; }
+
+        /** @brief Whether the buffer is persistently mapped */
+        inline bool isPersistent() const { return persistent; }
+
+        /**
+         * @brief Count of waits for GPU
+         *
+         * Count of beginFrame() calls, which had to wait for GPU to finish
+         * using the region.
+         */
+        inline UnsignedInt stallCount() const { return stalls; }
+
+        /**
+         * @brief Begin new frame
+         *
+         * Advances to next region and waits until the GPU stops using it.
+         */
+        void beginFrame();
+
+        /**
+         * @brief Allocate memory in current region
+         *
+         * The offset is aligned to given value. Returns allocation with
+         * `nullptr` data if there isn't enough space left in the region.
+         */
+        Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 4);
+
+        /**
+         * @brief Make the written data available to the GPU
+         *
+         * Call after all data for current frame are written and before they
+         * are used for drawing. No allocations can be done after that in
+         * current frame.
+         */
+        void commit();
+
+        /**
+         * @brief End the frame
+         *
+         * Call after all draws using data from current region are submitted,
+         * inserts fence protecting the region.
+         */
+        void endFrame();
+
+    private:
+        Buffer ringBuffer;
+        Buffer::Target target;
+        GLsizeiptr size, used;
+        UnsignedInt region, stalls;
+        bool persistent;
+        char* mapped;
+        GLsync fences[RegionCount];
+};
+
+}}
+
+#endif
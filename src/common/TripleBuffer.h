@@ -0,0 +1,97 @@
+#ifndef Magnum_Examples_TripleBuffer_h
+#define Magnum_Examples_TripleBuffer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Lock-free triple buffer
+
+Passes state from one producer thread to one consumer thread without locking.
+The producer fills the write buffer and publishes it, the consumer picks up
+the latest published state at beginning of each frame and reads it until the
+next update(). Neither of them ever waits for the other, states published
+faster than the consumer can pick them up are dropped.
+
+The third buffer sits between the two and is atomically exchanged with
+producer's or consumer's buffer, the highest bit of its index marks whether it
+contains state which wasn't consumed yet.
+*/
+template<class T> class TripleBuffer {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * All buffers are initialized to @p initial, which is thus available
+         * in readBuffer() before anything is published. update() returns
+         * `false` until the first publish().
+         */
+        explicit TripleBuffer(const T& initial = T()): buffers{initial, initial, initial}, writeIndex(0), middleIndex(1), readIndex(2) {}
+
+        /** @brief Buffer for the producer to write to */
+        inline T& writeBuffer() { return buffers[writeIndex]; }
+
+        /**
+         * @brief Publish contents of write buffer
+         *
+         * The write buffer is swapped with the middle one, which may contain
+         * older unconsumed state. Its contents are thus undefined afterwards.
+         */
+        inline void publish() {
+            writeIndex = middleIndex.exchange(writeIndex|FreshBit, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        /**
+         * @brief Pick up latest published state
+         * @return `true` if new state was published since last call, `false`
+         *      otherwise (the read buffer is then unchanged)
+         */
+        inline bool update() {
+            if(!(middleIndex.load(std::memory_order_relaxed) & FreshBit)) return false;
+            readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        /** @brief Buffer for the consumer to read from */
+        inline const T& readBuffer() const { return buffers[readIndex]; }
+
+    private:
+        enum: UnsignedInt {
+            FreshBit = 1u << 31,
+            IndexMask = ~FreshBit
+        };
+
+        T buffers[3];
+        UnsignedInt writeIndex;
+        std::atomic<UnsignedInt> middleIndex;
+        UnsignedInt readIndex;
+};
+
+}}
+
+#endif
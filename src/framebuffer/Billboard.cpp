@@ -31,28 +31,25 @@
 
 namespace Magnum { namespace Examples {
 
-Billboard::Billboard(Trade::ImageData2D* image, Buffer* colorCorrectionBuffer, Object2D* parent, SceneGraph::DrawableGroup2D<>* group): Object2D(parent), SceneGraph::Drawable2D<>(this, group) {
+Billboard::Billboard(Trade::ImageData2D* image, Object2D* parent, SceneGraph::DrawableGroup2D<>* group): Object2D(parent), SceneGraph::Drawable2D<>(this, group) {
     Trade::MeshData2D square = Primitives::Square::solid();
     buffer.setData(*square.positions(0), Buffer::Usage::StaticDraw);
     mesh.setPrimitive(square.primitive())
         ->setVertexCount(square.positions(0)->size())
-        ->addVertexBuffer(&buffer, 0, ColorCorrectionShader::Position());
+        ->addVertexBuffer(&buffer, 0, BillboardShader::Position());
 
     texture.setWrapping(Texture2D::Wrapping::ClampToBorder)
         ->setMagnificationFilter(Texture2D::Filter::Linear)
         ->setMinificationFilter(Texture2D::Filter::Linear)
         ->setImage(0, Texture2D::InternalFormat::RGBA8, image);
 
-    colorCorrectionTexture.setBuffer(BufferTexture::InternalFormat::R32F, colorCorrectionBuffer);
-
     scale(Vector2::yScale(Float(image->size()[1])/image->size()[0]));
 }
 
 void Billboard::draw(const Matrix3& transformationMatrix, SceneGraph::AbstractCamera2D<>* camera) {
     shader.setTransformationProjectionMatrix(camera->projectionMatrix()*transformationMatrix)
         ->use();
-    texture.bind(ColorCorrectionShader::TextureLayer);
-    colorCorrectionTexture.bind(ColorCorrectionShader::ColorCorrectionTextureLayer);
+    texture.bind(BillboardShader::TextureLayer);
 
     mesh.draw();
 }
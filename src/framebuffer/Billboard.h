@@ -25,21 +25,20 @@
 */
 
 #include <Buffer.h>
-#include <BufferTexture.h>
 #include <Mesh.h>
 #include <Texture.h>
 #include <SceneGraph/Object.h>
 #include <SceneGraph/Drawable.h>
 #include <Trade/ImageData.h>
 
-#include "ColorCorrectionShader.h"
+#include "BillboardShader.h"
 #include "Types.h"
 
 namespace Magnum { namespace Examples {
 
 class Billboard: public Object2D, SceneGraph::Drawable2D<> {
     public:
-        Billboard(Trade::ImageData2D* image, Buffer* colorCorrectionBuffer, Object2D* parent, SceneGraph::DrawableGroup2D<>* group);
+        Billboard(Trade::ImageData2D* image, Object2D* parent, SceneGraph::DrawableGroup2D<>* group);
 
         void draw(const Matrix3& transformationMatrix, SceneGraph::AbstractCamera2D<>* camera) override;
 
@@ -47,8 +46,7 @@ class Billboard: public Object2D, SceneGraph::Drawable2D<> {
         Buffer buffer;
         Mesh mesh;
         Texture2D texture;
-        BufferTexture colorCorrectionTexture;
-        ColorCorrectionShader shader;
+        BillboardShader shader;
 };
 
 }}
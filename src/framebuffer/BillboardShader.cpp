@@ -22,24 +22,23 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include "ColorCorrectionShader.h"
+#include "BillboardShader.h"
 
 #include <Utility/Resource.h>
 #include <Shader.h>
 
 namespace Magnum { namespace Examples {
 
-ColorCorrectionShader::ColorCorrectionShader() {
+BillboardShader::BillboardShader() {
     Corrade::Utility::Resource rs("shader");
-    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("ColorCorrectionShader.vert")));
-    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("ColorCorrectionShader.frag")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("BillboardShader.vert")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("BillboardShader.frag")));
 
     link();
 
     transformationProjectionMatrixUniform = uniformLocation("transformationProjectionMatrix");
 
     setUniform(uniformLocation("textureData"), TextureLayer);
-    setUniform(uniformLocation("colorCorrectionTextureData"), ColorCorrectionTextureLayer);
 }
 
 }}
@@ -22,11 +22,12 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-layout(location = 0) in vec4 vertex;
+uniform sampler2D textureData;
 
-out vec2 textureCoordinate;
+in vec2 textureCoords;
+
+out vec4 color;
 
 void main() {
-    textureCoordinate = (vertex.xy + vec2(1, 1))/2;
-    gl_Position = vertex;
+    color = texture(textureData, textureCoords);
 }
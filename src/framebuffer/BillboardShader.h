@@ -1,5 +1,5 @@
-#ifndef Magnum_Examples_ColorCorrectionShader_h
-#define Magnum_Examples_ColorCorrectionShader_h
+#ifndef Magnum_Examples_BillboardShader_h
+#define Magnum_Examples_BillboardShader_h
 /*
     This file is part of Magnum.
 
@@ -29,24 +29,17 @@
 
 namespace Magnum { namespace Examples {
 
-class ColorCorrectionShader: public AbstractShaderProgram {
+class BillboardShader: public AbstractShaderProgram {
     public:
         typedef Attribute<0, Vector2> Position;
 
-        enum: UnsignedInt {
-            OriginalColorOutput = 0,
-            GrayscaleOutput = 1,
-            ColorCorrectedOutput = 2
-        };
-
         enum: Int {
-            TextureLayer = 0,
-            ColorCorrectionTextureLayer = 1
+            TextureLayer = 0
         };
 
-        ColorCorrectionShader();
+        BillboardShader();
 
-        inline ColorCorrectionShader* setTransformationProjectionMatrix(const Matrix3& matrix) {
+        inline BillboardShader* setTransformationProjectionMatrix(const Matrix3& matrix) {
             setUniform(transformationProjectionMatrixUniform, matrix);
             return this;
         }
@@ -26,24 +26,29 @@
 
 #include <DefaultFramebuffer.h>
 
-#include "ColorCorrectionShader.h"
+#include "common/PostProcessingEffects.h"
 
 namespace Magnum { namespace Examples {
 
-ColorCorrectionCamera::ColorCorrectionCamera(SceneGraph::AbstractObject2D<>* object): Camera2D(object), framebuffer(Rectanglei::fromSize(defaultFramebuffer.viewport().bottomLeft(), defaultFramebuffer.viewport().size()/2)) {
+ColorCorrectionCamera::ColorCorrectionCamera(Buffer* colorCorrectionBuffer, SceneGraph::AbstractObject2D<>* object): Camera2D(object), framebuffer(Rectanglei::fromSize(defaultFramebuffer.viewport().bottomLeft(), defaultFramebuffer.viewport().size()/2)), original(framebuffer.viewport().size()), grayscale(framebuffer.viewport().size()), corrected(framebuffer.viewport().size()) {
     setAspectRatioPolicy(SceneGraph::AspectRatioPolicy::Clip);
 
-    original.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
-    grayscale.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
-    corrected.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
+    /* Original is just copied, the others are one fused pass each. The table
+       size gets to the shader as a define. */
+    grayscale.add(new GrayscaleEffect);
+    corrected.add(new Lut1DEffect(colorCorrectionBuffer, CorrectionTextureSize));
 
-    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(Original), &original);
-    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(Grayscale), &grayscale);
-    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(Corrected), &corrected);
+    createTexture();
+}
 
-    framebuffer.mapForDraw({{ColorCorrectionShader::OriginalColorOutput, Framebuffer::ColorAttachment(Original)},
-                            {ColorCorrectionShader::GrayscaleOutput, Framebuffer::ColorAttachment(Grayscale)},
-                            {ColorCorrectionShader::ColorCorrectedOutput, Framebuffer::ColorAttachment(Corrected)}});
+void ColorCorrectionCamera::createTexture() {
+    /* Immutable storage can't be resized, create new texture */
+    texture.reset(new Texture2D);
+    texture->setMinificationFilter(Texture2D::Filter::Linear)
+        ->setMagnificationFilter(Texture2D::Filter::Linear)
+        ->setWrapping(Texture2D::Wrapping::ClampToEdge)
+        ->setStorage(1, Texture2D::InternalFormat::RGBA8, framebuffer.viewport().size());
+    framebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), texture.get(), 0);
 }
 
 void ColorCorrectionCamera::draw(SceneGraph::DrawableGroup2D<>& group) {
@@ -52,37 +57,28 @@ void ColorCorrectionCamera::draw(SceneGraph::DrawableGroup2D<>& group) {
     framebuffer.bind(AbstractFramebuffer::Target::Draw);
     Camera2D::draw(group);
 
+    const Vector2i size = defaultFramebuffer.viewport().size();
+
     /* Original image at top left */
-    framebuffer.mapForRead(Framebuffer::ColorAttachment(Original));
-    AbstractFramebuffer::blit(framebuffer, defaultFramebuffer,
-        framebuffer.viewport(),
-        {{0, defaultFramebuffer.viewport().height()/2}, {defaultFramebuffer.viewport().width()/2, defaultFramebuffer.viewport().height()}},
-        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Linear);
+    original.draw(texture.get(), defaultFramebuffer, {{0, size.y()/2}, {size.x()/2, size.y()}});
 
     /* Grayscale at top right */
-    framebuffer.mapForRead(Framebuffer::ColorAttachment(Grayscale));
-    AbstractFramebuffer::blit(framebuffer, defaultFramebuffer,
-        framebuffer.viewport(),
-        {defaultFramebuffer.viewport().size()/2, defaultFramebuffer.viewport().size()},
-        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Linear);
+    grayscale.draw(texture.get(), defaultFramebuffer, {size/2, size});
 
     /* Color corrected at bottom */
-    framebuffer.mapForRead(Framebuffer::ColorAttachment(Corrected));
-    AbstractFramebuffer::blit(framebuffer, defaultFramebuffer,
-        framebuffer.viewport(),
-        {{defaultFramebuffer.viewport().width()/4, 0}, {defaultFramebuffer.viewport().width()*3/4, defaultFramebuffer.viewport().height()/2}},
-        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Linear);
+    corrected.draw(texture.get(), defaultFramebuffer, {{size.x()/4, 0}, {size.x()*3/4, size.y()/2}});
 }
 
 void ColorCorrectionCamera::setViewport(const Vector2i& size) {
     Camera2D::setViewport(size/2);
 
-    /* Reset storage for renderbuffer */
+    /* Reset storage for the texture */
     if(framebuffer.viewport().size() != size/2) {
         framebuffer.setViewport({{}, size/2});
-        original.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
-        grayscale.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
-        corrected.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
+        original.setSize(size/2);
+        grayscale.setSize(size/2);
+        corrected.setSize(size/2);
+        createTexture();
     }
 }
 
@@ -24,28 +24,32 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <memory>
 #include <Framebuffer.h>
-#include <Renderbuffer.h>
+#include <Texture.h>
 #include <SceneGraph/Camera2D.h>
 
+#include "common/PostProcessing.h"
+
 namespace Magnum { namespace Examples {
 
 class ColorCorrectionCamera: public SceneGraph::Camera2D<> {
     public:
-        ColorCorrectionCamera(SceneGraph::AbstractObject2D<>* object);
+        enum: UnsignedInt {
+            CorrectionTextureSize = 1024    /**< @brief Size of color correction table */
+        };
+
+        ColorCorrectionCamera(Buffer* colorCorrectionBuffer, SceneGraph::AbstractObject2D<>* object);
 
         void draw(SceneGraph::DrawableGroup2D<>& group) override;
         void setViewport(const Vector2i& size) override;
 
     private:
-        enum { /* Color attachments */
-            Original = 0,
-            Grayscale = 1,
-            Corrected = 2
-        };
+        void createTexture();
 
         Framebuffer framebuffer;
-        Renderbuffer original,
+        std::unique_ptr<Texture2D> texture;
+        PostProcessingChain original,
             grayscale,
             corrected;
 };
@@ -62,8 +62,6 @@ FramebufferExample::FramebufferExample(const Arguments& arguments): GlutApplicat
         std::exit(0);
     }
 
-    camera = new ColorCorrectionCamera(&scene);
-
     /* Load TGA importer plugin */
     PluginManager<Trade::AbstractImporter> manager(MAGNUM_PLUGINS_IMPORTER_DIR);
     Trade::AbstractImporter* importer;
@@ -79,15 +77,17 @@ FramebufferExample::FramebufferExample(const Arguments& arguments): GlutApplicat
     }
 
     /* Create color correction texture */
-    Float texture[1024];
-    for(std::size_t i = 0; i != 1024; ++i) {
-        Float x = i*2/1023.0-1;
+    Float texture[ColorCorrectionCamera::CorrectionTextureSize];
+    for(std::size_t i = 0; i != ColorCorrectionCamera::CorrectionTextureSize; ++i) {
+        Float x = i*2.0/(ColorCorrectionCamera::CorrectionTextureSize - 1)-1;
         texture[i] = (std::sin(x*Constants::pi())/3.7f+x+1)/2;
     }
     colorCorrectionBuffer.setData(sizeof(texture), texture, Buffer::Usage::StaticDraw);
 
+    camera = new ColorCorrectionCamera(&colorCorrectionBuffer, &scene);
+
     /* Add billboard to the scene */
-    billboard = new Billboard(importer->image2D(0), &colorCorrectionBuffer, &scene, &drawables);
+    billboard = new Billboard(importer->image2D(0), &scene, &drawables);
     delete importer;
 }
 
@@ -24,86 +24,59 @@
 
 #include "MotionBlurCamera.h"
 
-#include <sstream>
-#include <Utility/Resource.h>
 #include <DefaultFramebuffer.h>
-#include <Shader.h>
 
-namespace Magnum { namespace Examples {
+#include "common/PostProcessingEffects.h"
 
-MotionBlurCamera::MotionBlurCamera(SceneGraph::AbstractObject3D<>* object): Camera3D(object), framebuffer(AbstractImage::Format::RGB, AbstractImage::Type::UnsignedByte), currentFrame(0), canvas(frames) {
-    for(Int i = 0; i != FrameCount; ++i) {
-        (frames[i] = new Texture2D)
-            ->setWrapping(Texture2D::Wrapping::ClampToEdge)
-            ->setMinificationFilter(Texture2D::Filter::Nearest)
-            ->setMagnificationFilter(Texture2D::Filter::Nearest);
-    }
-}
+namespace Magnum { namespace Examples {
 
-MotionBlurCamera::~MotionBlurCamera() {
-    for(Int i = 0; i != FrameCount; ++i)
-        delete frames[i];
+MotionBlurCamera::MotionBlurCamera(SceneGraph::AbstractObject3D<>* object): Camera3D(object), framebuffer(defaultFramebuffer.viewport()), currentFrame(0), blur(defaultFramebuffer.viewport().size()) {
+    blend = blur.add(new FrameBlendEffect(FrameCount - 1));
 }
 
 void MotionBlurCamera::setViewport(const Vector2i& size) {
     Camera3D::setViewport(size);
 
-    /* Initialize previous frames with black color */
-    std::size_t textureSize = size.product()*AbstractImage::pixelSize(AbstractImage::Format::RGB, AbstractImage::Type::UnsignedByte);
-    UnsignedByte* texture = new UnsignedByte[textureSize]();
-    framebuffer.setData(size, AbstractImage::Format::RGB, AbstractImage::Type::UnsignedByte, nullptr, Buffer::Usage::DynamicDraw);
-    delete texture;
+    framebuffer.setViewport({{}, size});
+    depth.setStorage(Renderbuffer::InternalFormat::DepthComponent24, size);
+    framebuffer.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, &depth);
+    blur.setSize(size);
 
-    Buffer::unbind(Buffer::Target::PixelPack);
-    for(Int i = 0; i != FrameCount; ++i)
-        frames[i]->setImage(0, Texture2D::InternalFormat::RGB8, &framebuffer);
+    /* Immutable storage can't be resized, create new textures. Initialize
+       previous frames with clear color. */
+    for(Int i = 0; i != FrameCount; ++i) {
+        frames[i].reset(new Texture2D);
+        frames[i]->setWrapping(Texture2D::Wrapping::ClampToEdge)
+            ->setMinificationFilter(Texture2D::Filter::Nearest)
+            ->setMagnificationFilter(Texture2D::Filter::Nearest)
+            ->setStorage(1, Texture2D::InternalFormat::RGBA8, size);
+        framebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), frames[i].get(), 0);
+        framebuffer.clear(AbstractFramebuffer::Clear::Color);
+    }
 }
 
 void MotionBlurCamera::draw(SceneGraph::DrawableGroup3D<>& group) {
+    /* Draw the scene into oldest frame */
+    framebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), frames[currentFrame].get(), 0);
+    framebuffer.clear(AbstractFramebuffer::Clear::Color|AbstractFramebuffer::Clear::Depth);
+    framebuffer.bind(AbstractFramebuffer::Target::Draw);
     Camera3D::draw(group);
 
-    defaultFramebuffer.read({0, 0}, viewport(), AbstractImage::Format::RGB, AbstractImage::Type::UnsignedByte, &framebuffer, Buffer::Usage::DynamicDraw);
+    /* Left half without blur */
+    const Vector2i size = viewport();
+    framebuffer.mapForRead(Framebuffer::ColorAttachment(0));
+    AbstractFramebuffer::blit(framebuffer, defaultFramebuffer,
+        {{}, {size.x()/2, size.y()}}, {{}, {size.x()/2, size.y()}},
+        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Nearest);
 
-    frames[currentFrame]->setImage(0, Texture2D::InternalFormat::RGB8, &framebuffer);
+    /* Right half blended with previous frames */
+    std::vector<Texture2D*> previous;
+    for(Int i = 1; i != FrameCount; ++i)
+        previous.push_back(frames[(currentFrame + i)%FrameCount].get());
+    blend->setFrames(std::move(previous));
+    blur.draw(frames[currentFrame].get(), defaultFramebuffer, {{size.x()/2, 0}, size}, {{0.5f, 0.0f}, Vector2(1.0f)});
 
-    canvas.draw(currentFrame);
     currentFrame = (currentFrame+1)%FrameCount;
 }
 
-MotionBlurCamera::MotionBlurShader::MotionBlurShader() {
-    Corrade::Utility::Resource rs("shaders");
-    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("MotionBlurShader.vert")));
-    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("MotionBlurShader.frag")));
-
-    link();
-
-    std::stringstream ss;
-    for(Int i = 0; i != MotionBlurCamera::FrameCount; ++i) {
-        ss.str("");
-        ss << "frame[" << i << "]";
-        setUniform(uniformLocation(ss.str()), i);
-    }
-}
-
-MotionBlurCamera::MotionBlurCanvas::MotionBlurCanvas(Texture2D** frames, Object3D* parent): Object3D(parent), frames(frames) {
-    const Vector2 vertices[] = {
-        {1.0f, -1.0f},
-        {1.0f, 1.0f},
-        {0.0f, -1.0f},
-        {0.0f, 1.0f}
-    };
-
-    buffer.setData(vertices, Buffer::Usage::StaticDraw);
-    mesh.setPrimitive(Mesh::Primitive::TriangleStrip)
-        ->setVertexCount(4)
-        ->addVertexBuffer(&buffer, 0, MotionBlurShader::Position());
-}
-
-void MotionBlurCamera::MotionBlurCanvas::draw(std::size_t currentFrame) {
-    shader.use();
-    for(Int i = 0; i != MotionBlurCamera::FrameCount; ++i)
-        frames[i]->bind((i+currentFrame)%MotionBlurCamera::FrameCount);
-    mesh.draw();
-}
-
 }}
@@ -24,54 +24,37 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include <BufferImage.h>
+#include <memory>
+#include <Framebuffer.h>
+#include <Renderbuffer.h>
 #include <Texture.h>
-#include <AbstractShaderProgram.h>
-#include <Mesh.h>
 #include <SceneGraph/Camera3D.h>
 
+#include "common/PostProcessing.h"
 #include "Types.h"
 
 namespace Magnum { namespace Examples {
 
+class FrameBlendEffect;
+
 class MotionBlurCamera: public SceneGraph::Camera3D<> {
     public:
         static const Int FrameCount = 7;
 
         MotionBlurCamera(SceneGraph::AbstractObject3D<>* object);
 
-        ~MotionBlurCamera();
-
         void setViewport(const Vector2i& size) override;
         void draw(SceneGraph::DrawableGroup3D<>& group) override;
 
     private:
-        class MotionBlurShader: public AbstractShaderProgram {
-            public:
-                typedef Attribute<0, Vector2> Position;
-
-                /* Frame texture layers are from 0 to FrameCount */
-
-                MotionBlurShader();
-        };
-
-        class MotionBlurCanvas: public Object3D {
-            public:
-                MotionBlurCanvas(Texture2D** frames, Object3D* parent = nullptr);
-
-                void draw(std::size_t currentFrame);
-
-            private:
-                MotionBlurShader shader;
-                Buffer buffer;
-                Mesh mesh;
-                Texture2D** frames;
-        };
-
-        BufferImage2D framebuffer;
-        Texture2D* frames[FrameCount];
+        /* Each frame is drawn into next texture in the ring, the blur then
+           averages all of them */
+        Framebuffer framebuffer;
+        Renderbuffer depth;
+        std::unique_ptr<Texture2D> frames[FrameCount];
         std::size_t currentFrame;
-        MotionBlurCanvas canvas;
+        PostProcessingChain blur;
+        FrameBlendEffect* blend;
 };
 
 }}
@@ -22,6 +22,10 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <DefaultFramebuffer.h>
 #include <Renderer.h>
 #include <MeshTools/CompressIndices.h>
@@ -31,6 +35,7 @@
 #include <SceneGraph/Scene.h>
 #include <Shaders/PhongShader.h>
 
+#include "common/TripleBuffer.h"
 #include "MotionBlurCamera.h"
 #include "Icosphere.h"
 
@@ -39,15 +44,31 @@ using namespace Magnum::Shaders;
 
 namespace Magnum { namespace Examples {
 
+namespace {
+    /* Fixed time step of the simulation, independent of rendering speed */
+    const std::chrono::milliseconds SimulationStep(40);
+}
+
 class MotionBlurExample: public Platform::GlutApplication {
     public:
         MotionBlurExample(const Arguments& arguments);
 
+        ~MotionBlurExample();
+
     protected:
         void viewportEvent(const Vector2i& size) override;
         void drawEvent() override;
 
     private:
+        /* Rotations computed by simulation thread at given time */
+        struct SceneState {
+            std::chrono::steady_clock::time_point time;
+            Deg camera;
+            Deg spheres[3];
+        };
+
+        void simulate();
+
         Scene3D scene;
         SceneGraph::DrawableGroup3D<> drawables;
         Object3D* cameraObject;
@@ -57,9 +78,14 @@ class MotionBlurExample: public Platform::GlutApplication {
         Mesh mesh;
         PhongShader shader;
         Object3D* spheres[3];
+
+        TripleBuffer<SceneState> sceneState;
+        SceneState previousState, currentState;
+        std::atomic<bool> running;
+        std::thread simulation;
 };
 
-MotionBlurExample::MotionBlurExample(const Arguments& arguments): GlutApplication(arguments, (new Configuration)->setTitle("Motion blur example")) {
+MotionBlurExample::MotionBlurExample(const Arguments& arguments): GlutApplication(arguments, (new Configuration)->setTitle("Motion blur example")), sceneState({std::chrono::steady_clock::now(), {}, {}}), previousState(sceneState.readBuffer()), currentState(previousState), running(true) {
     (cameraObject = new Object3D(&scene))
         ->translate(Vector3::zAxis(3.0f));
     (camera = new MotionBlurCamera(cameraObject))
@@ -106,6 +132,31 @@ MotionBlurExample::MotionBlurExample(const Arguments& arguments): GlutApplicatio
     (new Icosphere(&mesh, &shader, {0.0f, 0.0f, 1.0f}, spheres[2], &drawables))
         ->translate(Vector3::yAxis(0.75f))
         ->rotateZ(240.0_degf);
+
+    /* Objects are now set up, start the simulation */
+    simulation = std::thread(&MotionBlurExample::simulate, this);
+}
+
+MotionBlurExample::~MotionBlurExample() {
+    running = false;
+    simulation.join();
+}
+
+void MotionBlurExample::simulate() {
+    /* Write buffer contains the initial state */
+    SceneState state = sceneState.writeBuffer();
+
+    while(running) {
+        state.time += SimulationStep;
+        state.camera += 1.0_degf;
+        state.spheres[0] -= 2.0_degf;
+        state.spheres[1] += 1.0_degf;
+        state.spheres[2] -= 0.5_degf;
+
+        std::this_thread::sleep_until(state.time);
+        sceneState.writeBuffer() = state;
+        sceneState.publish();
+    }
 }
 
 void MotionBlurExample::viewportEvent(const Vector2i& size) {
@@ -114,15 +165,29 @@ void MotionBlurExample::viewportEvent(const Vector2i& size) {
 }
 
 void MotionBlurExample::drawEvent() {
+    if(sceneState.update()) {
+        previousState = currentState;
+        currentState = sceneState.readBuffer();
+    }
+
+    /* Render one simulation step behind, so there is usually newer state to
+       interpolate towards and the movement is smooth at any frame rate.
+       Without new state the latest one is drawn. */
+    const std::chrono::steady_clock::time_point renderTime = std::chrono::steady_clock::now() - SimulationStep;
+    Float factor = 1.0f;
+    if(currentState.time > previousState.time && renderTime < currentState.time)
+        factor = std::max(0.0f, std::chrono::duration<Float>(renderTime - previousState.time).count()/
+            std::chrono::duration<Float>(currentState.time - previousState.time).count());
+    auto interpolate = [factor](Deg previous, Deg current) { return previous + (current - previous)*factor; };
+
+    cameraObject->setTransformation(Matrix4::rotationX(interpolate(previousState.camera, currentState.camera))*
+        Matrix4::translation(Vector3::zAxis(3.0f)));
+    for(std::size_t i = 0; i != 3; ++i)
+        spheres[i]->setTransformation(Matrix4::rotationZ(interpolate(previousState.spheres[i], currentState.spheres[i])));
+
     defaultFramebuffer.clear(DefaultFramebuffer::Clear::Color|DefaultFramebuffer::Clear::Depth);
     camera->draw(drawables);
     swapBuffers();
-
-    cameraObject->rotateX(1.0_degf);
-    spheres[0]->rotateZ(-2.0_degf);
-    spheres[1]->rotateZ(1.0_degf);
-    spheres[2]->rotateZ(-0.5_degf);
-    Utility::sleep(40);
     redraw();
 }
 
@@ -0,0 +1,49 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+in vec3 transformedNormal;
+in vec3 lightDirection;
+in vec3 cameraDirection;
+in vec3 diffuseColor;
+
+out vec4 color;
+
+void main() {
+    vec3 normalizedTransformedNormal = normalize(transformedNormal);
+    vec3 normalizedLightDirection = normalize(lightDirection);
+
+    /* Ambient and diffuse color, the same as with PhongShader */
+    color.rgb = diffuseColor*0.3;
+    float intensity = max(0.0, dot(normalizedTransformedNormal, normalizedLightDirection));
+    color.rgb += diffuseColor*intensity;
+
+    /* Specular color, if needed */
+    if(intensity != 0) {
+        vec3 reflection = reflect(-normalizedLightDirection, normalizedTransformedNormal);
+        float specularity = pow(max(0.0, dot(normalize(cameraDirection), reflection)), 80.0);
+        color.rgb += vec3(specularity);
+    }
+
+    color.a = 1.0;
+}
@@ -0,0 +1,64 @@
+#ifndef Magnum_Examples_InstancedShader_h
+#define Magnum_Examples_InstancedShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Phong-like shader drawing many instances of one mesh in a single call.
+ * Besides per-vertex position and normal it takes transformation matrix and
+ * color as per-instance attributes, which are expected to have divisor set
+ * to 1.
+ */
+class InstancedShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector3> Position;       /**< @brief Vertex position */
+        typedef Attribute<1, Vector3> Normal;         /**< @brief Normal direction */
+        typedef Attribute<2, Matrix4> Transformation; /**< @brief Instance transformation */
+        typedef Attribute<6, Vector3> Color;          /**< @brief Instance color */
+
+        InstancedShader();
+
+        inline InstancedShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+        inline InstancedShader* setLightPosition(const Vector3& position) {
+            setUniform(lightPositionUniform, position);
+            return this;
+        }
+
+    private:
+        Int projectionMatrixUniform,
+            lightPositionUniform;
+};
+
+}}
+
+#endif
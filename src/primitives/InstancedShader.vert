@@ -0,0 +1,51 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform mat4 projectionMatrix;
+uniform vec3 lightPosition;
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+
+/* Per-instance attributes, matrix takes locations 2 to 5 */
+layout(location = 2) in mat4 transformationMatrix;
+layout(location = 6) in vec3 color;
+
+out vec3 transformedNormal;
+out vec3 lightDirection;
+out vec3 cameraDirection;
+out vec3 diffuseColor;
+
+void main() {
+    /* The transformations have only uniform scaling, so upper 3x3 part can
+       be used for normals */
+    vec4 transformedPosition4 = transformationMatrix*position;
+    vec3 transformedPosition = transformedPosition4.xyz/transformedPosition4.w;
+    transformedNormal = mat3(transformationMatrix)*normal;
+    lightDirection = normalize(lightPosition - transformedPosition);
+    cameraDirection = -transformedPosition;
+    diffuseColor = color;
+
+    gl_Position = projectionMatrix*transformedPosition4;
+}
@@ -0,0 +1,334 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <Buffer.h>
+#include <DefaultFramebuffer.h>
+#include <Framebuffer.h>
+#include <Mesh.h>
+#include <Query.h>
+#include <Renderbuffer.h>
+#include <Renderer.h>
+#include <MeshTools/Interleave.h>
+#include <MeshTools/CompressIndices.h>
+#include <Platform/GlutApplication.h>
+#include <Primitives/Cube.h>
+#include <Primitives/Icosphere.h>
+#include <Primitives/UVSphere.h>
+#include <Shaders/PhongShader.h>
+#include <Trade/MeshData3D.h>
+
+#include "InstancedShader.h"
+
+namespace Magnum { namespace Examples {
+
+class PrimitivesBenchmark: public Platform::GlutApplication {
+    public:
+        explicit PrimitivesBenchmark(const Arguments& arguments);
+
+        ~PrimitivesBenchmark();
+
+    protected:
+        void viewportEvent(const Vector2i&) override {}
+        void drawEvent() override;
+
+    private:
+        enum: UnsignedInt { ShapeCount = 3 };
+
+        struct Shape {
+            /* Indexed mesh for the per-draw path */
+            Buffer vertexBuffer, indexBuffer;
+            Mesh mesh;
+
+            /* Vertex array with the same buffers and per-instance attributes
+               for the instanced path, Mesh can't do instanced draws */
+            GLuint instancedVertexArray;
+
+            UnsignedInt indexCount, triangleCount;
+            Mesh::IndexType indexType;
+        };
+
+        struct Timing {
+            double submit, gpu, frame;
+        };
+
+        void setupShape(Shape& shape, Trade::MeshData3D& data);
+        void setInstanceCount(UnsignedInt count);
+        void drawPerDraw();
+        void drawInstanced();
+        Timing measure(void(PrimitivesBenchmark::*draw)(), UnsignedInt frames);
+
+        Framebuffer framebuffer;
+        Renderbuffer color, depth;
+        Query timeQuery;
+
+        Shape shapes[ShapeCount];
+        Shaders::PhongShader phongShader;
+        InstancedShader instancedShader;
+        Matrix4 projection;
+
+        /* Instances are sorted by shape, instances of shape i start at
+           instanceOffsets[i] */
+        std::vector<Matrix4> transformations;
+        std::vector<Color3<>> colors;
+        UnsignedInt instanceOffsets[ShapeCount+1];
+        Buffer instanceBuffer;
+
+        UnsignedInt maxInstanceCount, perDrawMaxInstanceCount;
+};
+
+PrimitivesBenchmark::PrimitivesBenchmark(const Arguments& arguments): GlutApplication(arguments, (new Configuration)->setTitle("Primitives benchmark")), framebuffer({{}, {1024, 1024}}), maxInstanceCount(1000000), perDrawMaxInstanceCount(1000000) {
+    for(int i = 1; i < arguments.argc; ++i) {
+        if(std::strcmp(arguments.argv[i], "--max") == 0 && i + 1 < arguments.argc)
+            maxInstanceCount = std::stoul(arguments.argv[++i]);
+        else if(std::strcmp(arguments.argv[i], "--per-draw-max") == 0 && i + 1 < arguments.argc)
+            perDrawMaxInstanceCount = std::stoul(arguments.argv[++i]);
+        else {
+            Debug() << "Usage:" << arguments.argv[0] << "[--max N] [--per-draw-max N]";
+            std::exit(0);
+        }
+    }
+
+    /* Render offscreen, so the results don't depend on window size */
+    color.setStorage(Renderbuffer::InternalFormat::RGBA8, framebuffer.viewport().size());
+    depth.setStorage(Renderbuffer::InternalFormat::DepthComponent24, framebuffer.viewport().size());
+    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(0), &color);
+    framebuffer.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, &depth);
+
+    Renderer::setFeature(Renderer::Feature::FaceCulling, true);
+    Renderer::setFeature(Renderer::Feature::DepthTest, true);
+    Renderer::setClearColor(Color3<>(0.125f));
+
+    Trade::MeshData3D cube = Primitives::Cube::solid();
+    Primitives::Icosphere<1> icosphere;
+    Trade::MeshData3D sphere = Primitives::UVSphere::solid(8, 16);
+    setupShape(shapes[0], cube);
+    setupShape(shapes[1], icosphere);
+    setupShape(shapes[2], sphere);
+
+    projection = Matrix4::perspectiveProjection(Deg(35.0f), 1.0f, 0.01f, 100.0f);
+
+    phongShader.setProjectionMatrix(projection)
+        ->setLightPosition({7.0f, 5.0f, 2.5f})
+        ->setLightColor(Color3<>(1.0f))
+        ->setSpecularColor(Color3<>(1.0f))
+        ->setShininess(80.0f);
+    instancedShader.setProjectionMatrix(projection)
+        ->setLightPosition({7.0f, 5.0f, 2.5f});
+}
+
+PrimitivesBenchmark::~PrimitivesBenchmark() {
+    for(Shape& shape: shapes) glDeleteVertexArrays(1, &shape.instancedVertexArray);
+}
+
+void PrimitivesBenchmark::setupShape(Shape& shape, Trade::MeshData3D& data) {
+    const std::vector<Vector3>& positions = *data.positions(0);
+    const std::vector<Vector3>& normals = *data.normals(0);
+
+    char* indexData;
+    std::size_t indexCount;
+    std::tie(indexCount, shape.indexType, indexData) = MeshTools::compressIndices(*data.indices());
+    shape.indexBuffer.setData(indexCount*Mesh::indexSize(shape.indexType), indexData, Buffer::Usage::StaticDraw);
+    delete[] indexData;
+
+    MeshTools::interleave(&shape.mesh, &shape.vertexBuffer, Buffer::Usage::StaticDraw, positions, normals);
+    shape.mesh.setPrimitive(Mesh::Primitive::Triangles)
+        ->addInterleavedVertexBuffer(&shape.vertexBuffer, 0,
+            Shaders::PhongShader::Position(),
+            Shaders::PhongShader::Normal())
+        ->setIndexCount(indexCount)
+        ->setIndexBuffer(&shape.indexBuffer, 0, shape.indexType, 0, positions.size() - 1);
+
+    /* Per-vertex attributes of the instanced path. Per-instance attributes
+       depend on instance offset of the shape, so they are specified at draw
+       time. Mesh tracks which vertex array is bound, restore it afterwards. */
+    GLint previousVertexArray;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+    glGenVertexArrays(1, &shape.instancedVertexArray);
+    glBindVertexArray(shape.instancedVertexArray);
+    shape.vertexBuffer.bind(Buffer::Target::Array);
+    glEnableVertexAttribArray(InstancedShader::Position::Location);
+    glVertexAttribPointer(InstancedShader::Position::Location, 3, GL_FLOAT, GL_FALSE, 2*sizeof(Vector3), nullptr);
+    glEnableVertexAttribArray(InstancedShader::Normal::Location);
+    glVertexAttribPointer(InstancedShader::Normal::Location, 3, GL_FLOAT, GL_FALSE, 2*sizeof(Vector3), reinterpret_cast<GLvoid*>(sizeof(Vector3)));
+    for(UnsignedInt column = 0; column != 4; ++column) {
+        glEnableVertexAttribArray(InstancedShader::Transformation::Location + column);
+        glVertexAttribDivisor(InstancedShader::Transformation::Location + column, 1);
+    }
+    glEnableVertexAttribArray(InstancedShader::Color::Location);
+    glVertexAttribDivisor(InstancedShader::Color::Location, 1);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, shape.indexBuffer.id());
+    glBindVertexArray(previousVertexArray);
+
+    shape.indexCount = indexCount;
+    shape.triangleCount = indexCount/3;
+}
+
+void PrimitivesBenchmark::setInstanceCount(UnsignedInt count) {
+    /* Place the instances into cubic grid in front of the camera */
+    const UnsignedInt side = UnsignedInt(std::ceil(std::cbrt(Double(count))));
+    const Float spacing = 2.0f/side;
+
+    std::mt19937 random;
+    std::uniform_real_distribution<Float> unit(0.0f, 1.0f);
+
+    transformations.resize(count);
+    colors.resize(count);
+    std::vector<Vector4> instanceData(count*5);
+
+    UnsignedInt instance = 0;
+    for(UnsignedInt shape = 0; shape != ShapeCount; ++shape) {
+        instanceOffsets[shape] = instance;
+
+        /* Every ShapeCount-th grid cell has this shape */
+        for(UnsignedInt i = shape; i < count; i += ShapeCount, ++instance) {
+            const Vector3 cell(Float(i%side), Float(i/side%side), Float(i/(side*side)));
+            const Vector3 axis = Vector3(unit(random), unit(random), unit(random)) + Vector3(0.01f);
+
+            transformations[instance] =
+                Matrix4::translation(Vector3::zAxis(-5.0f) + (cell + Vector3(0.5f))*spacing - Vector3(1.0f))*
+                Matrix4::rotation(Deg(360.0f*unit(random)), axis.normalized())*
+                Matrix4::scaling(Vector3(0.4f*spacing));
+            colors[instance] = Color3<>::fromHSV(Deg(360.0f*unit(random)), 0.8f, 1.0f);
+
+            for(std::size_t column = 0; column != 4; ++column)
+                instanceData[instance*5 + column] = transformations[instance][column];
+            instanceData[instance*5 + 4] = Vector4(colors[instance], 1.0f);
+        }
+    }
+    instanceOffsets[ShapeCount] = instance;
+
+    instanceBuffer.setData(instanceData, Buffer::Usage::StaticDraw);
+}
+
+void PrimitivesBenchmark::drawPerDraw() {
+    for(UnsignedInt shape = 0; shape != ShapeCount; ++shape) {
+        for(UnsignedInt i = instanceOffsets[shape]; i != instanceOffsets[shape+1]; ++i) {
+            phongShader.setDiffuseColor(colors[i])
+                ->setAmbientColor(colors[i]*0.3f)
+                ->setTransformationMatrix(transformations[i])
+                ->use();
+            shapes[shape].mesh.draw();
+        }
+    }
+}
+
+void PrimitivesBenchmark::drawInstanced() {
+    /* Mesh tracks which vertex array is bound, restore it afterwards */
+    GLint previousVertexArray;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+
+    instancedShader.use();
+    instanceBuffer.bind(Buffer::Target::Array);
+
+    for(UnsignedInt shape = 0; shape != ShapeCount; ++shape) {
+        const UnsignedInt count = instanceOffsets[shape+1] - instanceOffsets[shape];
+        if(!count) continue;
+
+        /* Four matrix columns and color, five vectors per instance */
+        glBindVertexArray(shapes[shape].instancedVertexArray);
+        const std::size_t offset = instanceOffsets[shape]*5*sizeof(Vector4);
+        for(UnsignedInt column = 0; column != 4; ++column)
+            glVertexAttribPointer(InstancedShader::Transformation::Location + column, 4, GL_FLOAT, GL_FALSE, 5*sizeof(Vector4), reinterpret_cast<GLvoid*>(offset + column*sizeof(Vector4)));
+        glVertexAttribPointer(InstancedShader::Color::Location, 3, GL_FLOAT, GL_FALSE, 5*sizeof(Vector4), reinterpret_cast<GLvoid*>(offset + 4*sizeof(Vector4)));
+
+        glDrawElementsInstanced(GL_TRIANGLES, shapes[shape].indexCount, static_cast<GLenum>(shapes[shape].indexType), nullptr, count);
+    }
+
+    glBindVertexArray(previousVertexArray);
+}
+
+PrimitivesBenchmark::Timing PrimitivesBenchmark::measure(void(PrimitivesBenchmark::*draw)(), UnsignedInt frames) {
+    Timing timing{0.0, 0.0, 0.0};
+
+    /* One frame to warm up the caches and driver */
+    for(UnsignedInt frame = 0; frame != frames + 1; ++frame) {
+        framebuffer.clear(AbstractFramebuffer::Clear::Color|AbstractFramebuffer::Clear::Depth);
+        framebuffer.bind(AbstractFramebuffer::Target::Draw);
+        Renderer::finish();
+
+        const auto begin = std::chrono::high_resolution_clock::now();
+        timeQuery.begin(Query::Target::TimeElapsed);
+        (this->*draw)();
+        timeQuery.end();
+        const auto submitted = std::chrono::high_resolution_clock::now();
+        Renderer::finish();
+        const auto end = std::chrono::high_resolution_clock::now();
+        const UnsignedLong gpu = timeQuery.result<UnsignedLong>();
+
+        if(!frame) continue;
+        timing.submit += std::chrono::duration<double>(submitted - begin).count();
+        timing.frame += std::chrono::duration<double>(end - begin).count();
+        timing.gpu += gpu*1.0e-9;
+    }
+
+    timing.submit /= frames;
+    timing.frame /= frames;
+    timing.gpu /= frames;
+    return timing;
+}
+
+void PrimitivesBenchmark::drawEvent() {
+    std::cout << std::setw(10) << "instances" << std::setw(10) << "path"
+              << std::setw(12) << "submit ms" << std::setw(12) << "gpu ms"
+              << std::setw(12) << "frame ms" << std::setw(12) << "Mtris/s" << std::endl;
+
+    const UnsignedInt counts[] = {1000, 3000, 10000, 30000, 100000, 300000, 1000000};
+    for(UnsignedInt count: counts) {
+        if(count > maxInstanceCount) break;
+
+        setInstanceCount(count);
+
+        UnsignedLong triangles = 0;
+        for(UnsignedInt shape = 0; shape != ShapeCount; ++shape)
+            triangles += UnsignedLong(instanceOffsets[shape+1] - instanceOffsets[shape])*shapes[shape].triangleCount;
+
+        /* Less frames for larger counts, so the whole run doesn't take ages
+           with software rasterizer */
+        const UnsignedInt frames = std::max(3u, std::min(50u, 1000000u/count));
+
+        for(Int instanced = 0; instanced != 2; ++instanced) {
+            if(!instanced && count > perDrawMaxInstanceCount) continue;
+
+            const Timing timing = measure(instanced ? &PrimitivesBenchmark::drawInstanced : &PrimitivesBenchmark::drawPerDraw, frames);
+
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::setw(10) << count << std::setw(10) << (instanced ? "instanced" : "per-draw")
+                      << std::setw(12) << timing.submit*1000.0 << std::setw(12) << timing.gpu*1000.0
+                      << std::setw(12) << timing.frame*1000.0 << std::setw(12) << triangles/timing.frame*1.0e-6 << std::endl;
+        }
+    }
+
+    std::exit(0);
+}
+
+}}
+
+MAGNUM_APPLICATION_MAIN(Magnum::Examples::PrimitivesBenchmark)
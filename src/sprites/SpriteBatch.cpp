@@ -0,0 +1,107 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SpriteBatch.h"
+
+#include <algorithm>
+
+#include "SpriteShader.h"
+
+namespace Magnum { namespace Examples {
+
+SpriteBatch::SpriteBatch(UnsignedInt capacity): spriteCapacity(0), drawCalls(0) {
+    reserve(capacity);
+}
+
+void SpriteBatch::reserve(UnsignedInt capacity) {
+    spriteCapacity = capacity;
+
+    /* The vertices are always written to one of the ring regions. Instead of
+       changing vertex buffer offset in the mesh, the index buffer spans all
+       regions and the draw uses subrange of it. */
+    const UnsignedInt quadCount = capacity*StreamingBuffer::RegionCount;
+    std::vector<UnsignedInt> indices(quadCount*6);
+    for(UnsignedInt i = 0; i != quadCount; ++i) {
+        indices[i*6 + 0] = i*4 + 0;
+        indices[i*6 + 1] = i*4 + 1;
+        indices[i*6 + 2] = i*4 + 2;
+        indices[i*6 + 3] = i*4 + 2;
+        indices[i*6 + 4] = i*4 + 1;
+        indices[i*6 + 5] = i*4 + 3;
+    }
+    indexBuffer.setData(indices, Buffer::Usage::StaticDraw);
+
+    vertexStream.reset(new StreamingBuffer(capacity*4*sizeof(Vertex)));
+
+    mesh.reset(new Mesh);
+    mesh->setPrimitive(Mesh::Primitive::Triangles)
+        ->setVertexCount(quadCount*4)
+        ->addInterleavedVertexBuffer(&vertexStream->buffer(), 0,
+            SpriteShader::Position(),
+            SpriteShader::TextureCoordinates(),
+            SpriteShader::Color());
+}
+
+void SpriteBatch::draw(SpriteShader& shader, Texture3D& texture) {
+    drawCalls = 0;
+    if(spriteList.empty()) return;
+
+    /* Enlarge the buffers to next power of two, if needed */
+    if(spriteList.size() > spriteCapacity) {
+        UnsignedInt capacity = std::max(spriteCapacity, 1u);
+        while(capacity < spriteList.size()) capacity *= 2;
+        reserve(capacity);
+    }
+
+    /* Convert sprites to quads directly in the mapped memory. The memory is
+       possibly write-combined, so it is only written sequentially, never
+       read. */
+    const GLsizeiptr quadSize = 4*sizeof(Vertex);
+    vertexStream->beginFrame();
+    const StreamingBuffer::Allocation allocation = vertexStream->allocate(spriteList.size()*quadSize, quadSize);
+    Vertex* quad = static_cast<Vertex*>(allocation.data);
+    for(const Sprite& sprite: spriteList) {
+        const Vector2 halfSize = sprite.size/2.0f;
+
+        *quad++ = {sprite.position + Vector2(-halfSize.x(), -halfSize.y()), {0.0f, 0.0f, sprite.layer}, sprite.color};
+        *quad++ = {sprite.position + Vector2( halfSize.x(), -halfSize.y()), {1.0f, 0.0f, sprite.layer}, sprite.color};
+        *quad++ = {sprite.position + Vector2(-halfSize.x(),  halfSize.y()), {0.0f, 1.0f, sprite.layer}, sprite.color};
+        *quad++ = {sprite.position + Vector2( halfSize.x(),  halfSize.y()), {1.0f, 1.0f, sprite.layer}, sprite.color};
+    }
+    vertexStream->commit();
+
+    const UnsignedInt firstQuad = allocation.offset/quadSize;
+    const UnsignedInt count = spriteList.size();
+    mesh->setIndexCount(count*6)
+        ->setIndexBuffer(&indexBuffer, firstQuad*6*sizeof(UnsignedInt), Mesh::IndexType::UnsignedInt, firstQuad*4, (firstQuad + count)*4 - 1);
+
+    shader.use();
+    texture.bind(SpriteShader::TextureLayer);
+    mesh->draw();
+    ++drawCalls;
+
+    vertexStream->endFrame();
+}
+
+}}
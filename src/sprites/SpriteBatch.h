@@ -0,0 +1,109 @@
+#ifndef Magnum_Examples_SpriteBatch_h
+#define Magnum_Examples_SpriteBatch_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include <Buffer.h>
+#include <Color.h>
+#include <Mesh.h>
+#include <Texture.h>
+
+#include "common/StreamingBuffer.h"
+
+namespace Magnum { namespace Examples {
+
+class SpriteShader;
+
+/**
+@brief Batched sprite renderer
+
+Sprites are stored in CPU-side array, which is converted to quads on every
+draw() call. The quads are written directly into persistently mapped
+streaming buffer (see @ref StreamingBuffer), so there is no driver-side copy
+and no implicit synchronization. All sprite images are expected to be layers
+of one 2D texture array, so the whole batch needs only one texture binding and
+one draw call.
+*/
+class SpriteBatch {
+    public:
+        /** @brief Sprite */
+        struct Sprite {
+            Vector2 position;   /**< @brief Center, in pixels */
+            Vector2 size;       /**< @brief Size, in pixels */
+            Float layer;        /**< @brief Texture array layer */
+            Color3<> color;     /**< @brief Color multiplier */
+        };
+
+        /**
+         * @brief Constructor
+         * @param capacity      Initial count of sprites which can be drawn
+         *      in one frame. The capacity is enlarged if more sprites are
+         *      drawn.
+         */
+        explicit SpriteBatch(UnsignedInt capacity = 16384);
+
+        /** @brief Count of sprites which can be drawn in one frame */
+        inline UnsignedInt capacity() const { return spriteCapacity; }
+
+        /** @brief Sprites */
+        inline std::vector<Sprite>& sprites() { return spriteList; }
+
+        /** @brief Draw calls issued during last draw() */
+        inline UnsignedInt drawCallCount() const { return drawCalls; }
+
+        /** @brief Count of frames which had to wait for the GPU */
+        inline UnsignedInt stallCount() const { return vertexStream->stallCount(); }
+
+        /** @brief Whether vertices are written into persistently mapped memory */
+        inline bool isPersistent() const { return vertexStream->isPersistent(); }
+
+        /**
+         * @brief Draw all sprites
+         *
+         * Writes the sprites into streaming buffer, sets up the shader,
+         * binds the texture array and draws all sprites in one call.
+         */
+        void draw(SpriteShader& shader, Texture3D& texture);
+
+    private:
+        struct Vertex {
+            Vector2 position;
+            Vector3 textureCoordinates;
+            Vector3 color;
+        };
+
+        void reserve(UnsignedInt capacity);
+
+        UnsignedInt spriteCapacity, drawCalls;
+        std::vector<Sprite> spriteList;
+        std::unique_ptr<StreamingBuffer> vertexStream;
+        std::unique_ptr<Mesh> mesh;
+        Buffer indexBuffer;
+};
+
+}}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef Magnum_Examples_SpriteShader_h
+#define Magnum_Examples_SpriteShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix3.h>
+#include <AbstractShaderProgram.h>
+#include <Color.h>
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Same as TexturedTriangleShader, but the texture coordinates have a third
+ * component selecting layer of a 2D texture array, so sprites with different
+ * images can be drawn in one call. Vertex color is multiplied with base color.
+ */
+class SpriteShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector2> Position;
+        typedef Attribute<1, Vector3> TextureCoordinates;
+        typedef Attribute<2, Vector3> Color;
+
+        enum: Int {
+            TextureLayer = 0
+        };
+
+        SpriteShader();
+
+        inline SpriteShader* setProjectionMatrix(const Matrix3& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+        inline SpriteShader* setBaseColor(const Color3<>& color) {
+            setUniform(baseColorUniform, color);
+            return this;
+        }
+
+    private:
+        Int projectionMatrixUniform,
+            baseColorUniform;
+};
+
+}}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <DefaultFramebuffer.h>
+#include <Image.h>
+#include <Renderer.h>
+#include <Texture.h>
+#include <Platform/GlutApplication.h>
+
+#include "SpriteBatch.h"
+#include "SpriteShader.h"
+
+namespace Magnum { namespace Examples {
+
+class SpritesExample: public Platform::GlutApplication {
+    public:
+        explicit SpritesExample(const Arguments& arguments);
+
+    protected:
+        void viewportEvent(const Vector2i& size) override;
+        void drawEvent() override;
+
+    private:
+        enum: Int {
+            LayerCount = 8,
+            LayerSize = 64
+        };
+
+        /* Frames skipped after each sprite count change and frames then
+           averaged in benchmark mode */
+        enum: UnsignedInt {
+            WarmupFrames = 30,
+            MeasuredFrames = 120
+        };
+
+        void setSpriteCount(std::size_t count);
+        void advance(Float delta);
+        void benchmarkStep(double frameDuration);
+
+        SpriteShader shader;
+        Texture3D texture;
+        SpriteBatch batch;
+        std::vector<Vector2> velocities;
+        std::mt19937 random;
+        Vector2 viewport;
+
+        bool benchmark;
+        UnsignedInt frames;
+        double measuredDuration;
+        std::size_t lowerCount, upperCount;
+        std::chrono::high_resolution_clock::time_point before;
+};
+
+SpritesExample::SpritesExample(const Arguments& arguments): GlutApplication(arguments, (new Configuration)->setTitle("Sprites example")), texture(Texture3D::Target::Texture2DArray), benchmark(false), frames(0), measuredDuration(0.0), lowerCount(0), upperCount(0) {
+    std::size_t count = 10000;
+    if(arguments.argc == 2 && std::strcmp(arguments.argv[1], "--benchmark") == 0)
+        benchmark = true;
+    else if(arguments.argc == 2)
+        count = std::stoul(arguments.argv[1]);
+    else if(arguments.argc != 1) {
+        Debug() << "Usage:" << arguments.argv[0] << "[count|--benchmark]";
+        std::exit(0);
+    }
+
+    Renderer::setClearColor({0.1f, 0.1f, 0.1f});
+    Renderer::setFeature(Renderer::Feature::Blending, true);
+    Renderer::setBlendFunction(Renderer::BlendFunction::SourceAlpha, Renderer::BlendFunction::OneMinusSourceAlpha);
+
+    /* Generate texture array with a few simple annotation markers, one in
+       each layer: filled disc, ring, square outline, cross... */
+    UnsignedByte* data = new UnsignedByte[LayerCount*LayerSize*LayerSize*4];
+    for(Int layer = 0; layer != LayerCount; ++layer) for(Int y = 0; y != LayerSize; ++y) for(Int x = 0; x != LayerSize; ++x) {
+        const Vector2 position = Vector2(x + 0.5f, y + 0.5f)/(LayerSize/2.0f) - Vector2(1.0f);
+        const Float distance = position.length();
+        const Float border = std::max(std::abs(position.x()), std::abs(position.y()));
+
+        bool covered;
+        switch(layer%4) {
+            case 0: covered = distance < 0.9f; break;
+            case 1: covered = distance < 0.9f && distance > 0.6f; break;
+            case 2: covered = border < 0.9f && border > 0.7f; break;
+            default: covered = std::min(std::abs(position.x()), std::abs(position.y())) < 0.15f; break;
+        }
+
+        /* Second half of the layers is dimmer */
+        UnsignedByte* pixel = data + ((layer*LayerSize + y)*LayerSize + x)*4;
+        pixel[0] = pixel[1] = pixel[2] = layer < LayerCount/2 ? 255 : 160;
+        pixel[3] = covered ? 255 : 0;
+    }
+    Image3D image({LayerSize, LayerSize, LayerCount}, AbstractImage::Format::RGBA, AbstractImage::Type::UnsignedByte, data);
+    texture.setWrapping(Texture3D::Wrapping::ClampToEdge)
+        ->setMagnificationFilter(Texture3D::Filter::Linear)
+        ->setMinificationFilter(Texture3D::Filter::Linear, Texture3D::Mipmap::Linear)
+        ->setImage(0, Texture3D::InternalFormat::RGBA8, &image)
+        ->generateMipmap();
+
+    viewport = Vector2(defaultFramebuffer.viewport().size());
+    setSpriteCount(benchmark ? 1000 : count);
+
+    if(benchmark) {
+        Debug() << "Vertices are uploaded via" << (batch.isPersistent() ? "persistently mapped buffer" : "buffer mapped each frame");
+        Debug() << "Searching for max sprite count drawable at 60 FPS, make sure VSync is disabled...";
+    }
+
+    before = std::chrono::high_resolution_clock::now();
+}
+
+void SpritesExample::viewportEvent(const Vector2i& size) {
+    defaultFramebuffer.setViewport({{}, size});
+    viewport = Vector2(size);
+
+    /* Sprite positions are in pixels with origin in bottom left corner */
+    shader.setProjectionMatrix(Matrix3::projection(viewport)*Matrix3::translation(-viewport/2.0f));
+}
+
+void SpritesExample::drawEvent() {
+    std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
+    const double duration = std::chrono::duration<double>(now-before).count();
+    before = now;
+
+    /* Updating the sprites is part of the measured frame cost */
+    advance(std::min(duration, 0.1));
+
+    defaultFramebuffer.clear(DefaultFramebuffer::Clear::Color);
+    batch.draw(shader, texture);
+    swapBuffers();
+
+    if(benchmark) benchmarkStep(duration);
+    redraw();
+}
+
+void SpritesExample::setSpriteCount(std::size_t count) {
+    std::vector<SpriteBatch::Sprite>& sprites = batch.sprites();
+    const std::size_t previousCount = sprites.size();
+    sprites.resize(count);
+    velocities.resize(count);
+
+    std::uniform_real_distribution<Float> unit(0.0f, 1.0f);
+    for(std::size_t i = previousCount; i < count; ++i) {
+        sprites[i].position = Vector2(unit(random), unit(random))*viewport;
+        sprites[i].size = Vector2(8.0f + 24.0f*unit(random));
+        sprites[i].layer = Float(i%LayerCount);
+        sprites[i].color = Color3<>::fromHSV(Deg(360.0f*unit(random)), 0.8f, 1.0f);
+        velocities[i] = (Vector2(unit(random), unit(random)) - Vector2(0.5f))*200.0f;
+    }
+}
+
+void SpritesExample::advance(Float delta) {
+    std::vector<SpriteBatch::Sprite>& sprites = batch.sprites();
+    for(std::size_t i = 0; i != sprites.size(); ++i) {
+        Vector2& position = sprites[i].position;
+        position += velocities[i]*delta;
+
+        /* Bounce off window edges */
+        if(position.x() < 0.0f || position.x() > viewport.x()) velocities[i].x() *= -1.0f;
+        if(position.y() < 0.0f || position.y() > viewport.y()) velocities[i].y() *= -1.0f;
+    }
+}
+
+void SpritesExample::benchmarkStep(double frameDuration) {
+    if(++frames <= WarmupFrames) return;
+    measuredDuration += frameDuration;
+    if(frames < WarmupFrames + MeasuredFrames) return;
+
+    const std::size_t count = batch.sprites().size();
+    const double average = measuredDuration/MeasuredFrames;
+    std::cout << std::setw(10) << count << " sprites " << std::fixed << std::setprecision(2)
+              << std::setw(8) << average*1000.0 << " ms/frame "
+              << std::setw(6) << batch.drawCallCount() << " draw calls "
+              << std::setw(6) << batch.stallCount() << " stalls" << std::endl;
+
+    frames = 0;
+    measuredDuration = 0.0;
+
+    /* Double the count until the frame takes longer than 1/60 s, then bisect
+       until the interval is small enough */
+    if(average <= 1.0/60.0) lowerCount = count;
+    else upperCount = count;
+
+    if(!upperCount) setSpriteCount(count*2);
+    else if(upperCount - lowerCount > std::max(lowerCount/50, std::size_t(1000)))
+        setSpriteCount((lowerCount + upperCount)/2);
+    else {
+        std::cout << lowerCount << " sprites/frame at 60 FPS" << std::endl;
+        std::exit(0);
+    }
+}
+
+}}
+
+MAGNUM_APPLICATION_MAIN(Magnum::Examples::SpritesExample)
@@ -0,0 +1,201 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <Math/Vector3.h>
+#include <Buffer.h>
+#include <DefaultFramebuffer.h>
+#include <Image.h>
+#include <Mesh.h>
+#include <Renderer.h>
+#include <Texture.h>
+#include <Platform/GlutApplication.h>
+#include <Shaders/FlatShader.h>
+#include <Shaders/VertexColorShader.h>
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Measures cost of common state changes and draw calls, all done on the same
+ * tiny triangle as in TriangleExample, so the rasterization cost is
+ * negligible. Magnum skips redundant state changes (e.g. binding already
+ * bound texture), so the measured operations always alternate between two
+ * objects.
+ */
+class ApiOverheadBenchmark: public Platform::GlutApplication {
+    public:
+        explicit ApiOverheadBenchmark(const Arguments& arguments);
+
+    protected:
+        void viewportEvent(const Vector2i& size) override;
+        void drawEvent() override;
+
+    private:
+        struct Test {
+            std::string name;
+            std::function<void(UnsignedInt)> operation;
+        };
+
+        /* Returns median submit and total (including glFinish()) time in
+           nanoseconds per operation */
+        std::pair<double, double> measure(const Test& test, UnsignedInt batchSize);
+
+        Buffer buffer;
+        Mesh meshes[2];
+        Shaders::VertexColorShader3D vertexColorShaders[2];
+        Shaders::FlatShader3D flatShader;
+        Texture2D textures[2];
+
+        Buffer uploadBuffer;
+        std::vector<char> uploadData;
+};
+
+ApiOverheadBenchmark::ApiOverheadBenchmark(const Arguments& arguments): Platform::GlutApplication(arguments, (new Configuration)->setTitle("API overhead benchmark")), uploadData(1 << 20) {
+    constexpr static Vector3 data[] = {
+        {-0.01f, -0.01f, 0.0f}, {1.0f, 0.0f, 0.0f},
+        { 0.01f, -0.01f, 0.0f}, {0.0f, 1.0f, 0.0f},
+        { 0.0f,   0.01f, 0.0f}, {0.0f, 0.0f, 1.0f}
+    };
+
+    buffer.setData(data, Buffer::Usage::StaticDraw);
+
+    /* Two meshes with the same data to measure VAO switching */
+    for(Mesh& mesh: meshes) {
+        mesh.setPrimitive(Mesh::Primitive::Triangles)
+            ->setVertexCount(3)
+            ->addInterleavedVertexBuffer(&buffer, 0,
+                Shaders::VertexColorShader3D::Position(),
+                Shaders::VertexColorShader3D::Color());
+    }
+
+    /* Two small textures to measure texture binding */
+    for(Texture2D& texture: textures) {
+        Image2D image({4, 4}, AbstractImage::Format::RGBA, AbstractImage::Type::UnsignedByte, new UnsignedByte[4*4*4]());
+        texture.setMagnificationFilter(Texture2D::Filter::Nearest)
+            ->setMinificationFilter(Texture2D::Filter::Nearest)
+            ->setImage(0, Texture2D::InternalFormat::RGBA8, &image);
+    }
+
+    uploadBuffer.setData(uploadData.size(), nullptr, Buffer::Usage::DynamicDraw);
+}
+
+void ApiOverheadBenchmark::viewportEvent(const Vector2i& size) {
+    defaultFramebuffer.setViewport({{}, size});
+}
+
+std::pair<double, double> ApiOverheadBenchmark::measure(const Test& test, UnsignedInt batchSize) {
+    /* Repeat until at least 50 ms is spent or 101 repetitions are done */
+    std::vector<double> submitTimes, totalTimes;
+    double spent = 0.0;
+    while(spent < 0.05 && submitTimes.size() != 101) {
+        Renderer::finish();
+
+        const auto begin = std::chrono::high_resolution_clock::now();
+        for(UnsignedInt i = 0; i != batchSize; ++i) test.operation(i);
+        const auto submitted = std::chrono::high_resolution_clock::now();
+        Renderer::finish();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        submitTimes.push_back(std::chrono::duration<double>(submitted - begin).count());
+        totalTimes.push_back(std::chrono::duration<double>(end - begin).count());
+        spent += totalTimes.back();
+    }
+
+    std::sort(submitTimes.begin(), submitTimes.end());
+    std::sort(totalTimes.begin(), totalTimes.end());
+    return {submitTimes[submitTimes.size()/2]*1.0e9/batchSize,
+            totalTimes[totalTimes.size()/2]*1.0e9/batchSize};
+}
+
+void ApiOverheadBenchmark::drawEvent() {
+    defaultFramebuffer.bind(DefaultFramebuffer::Target::Draw);
+    defaultFramebuffer.clear(DefaultFramebuffer::Clear::Color);
+
+    std::vector<Test> tests{
+        {"draw", [this](UnsignedInt) {
+            vertexColorShaders[0].use();
+            meshes[0].draw();
+        }},
+        {"program switch + draw", [this](UnsignedInt i) {
+            vertexColorShaders[i%2].use();
+            meshes[0].draw();
+        }},
+        {"uniform upload + draw", [this](UnsignedInt i) {
+            flatShader.setTransformationProjectionMatrix(Matrix4::translation(Vector3::xAxis(Float(i%2)*0.01f)))
+                ->setColor(Color3<>(1.0f))
+                ->use();
+            meshes[0].draw();
+        }},
+        {"texture bind + draw", [this](UnsignedInt i) {
+            vertexColorShaders[0].use();
+            textures[i%2].bind(0);
+            meshes[0].draw();
+        }},
+        {"VAO switch + draw", [this](UnsignedInt i) {
+            vertexColorShaders[0].use();
+            meshes[i%2].draw();
+        }}
+    };
+
+    /* Buffer uploads of various sizes */
+    for(std::size_t size: {std::size_t(64), std::size_t(4096), std::size_t(262144)}) {
+        tests.push_back({"setData " + std::to_string(size) + " B", [this, size](UnsignedInt) {
+            uploadBuffer.setData(size, uploadData.data(), Buffer::Usage::DynamicDraw);
+        }});
+        tests.push_back({"setSubData " + std::to_string(size) + " B", [this, size](UnsignedInt) {
+            uploadBuffer.setSubData(0, size, uploadData.data());
+        }});
+    }
+
+    const UnsignedInt batchSizes[] = {1, 10, 100, 1000, 10000};
+
+    std::cout << "Median ns/op, submit time / time including glFinish()" << std::endl;
+    std::cout << std::setw(24) << std::left << "operation" << std::right;
+    for(UnsignedInt batchSize: batchSizes)
+        std::cout << std::setw(20) << (std::to_string(batchSize) + " ops");
+    std::cout << std::endl;
+
+    for(const Test& test: tests) {
+        std::cout << std::setw(24) << std::left << test.name << std::right;
+        for(UnsignedInt batchSize: batchSizes) {
+            const std::pair<double, double> result = measure(test, batchSize);
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(0) << result.first << " / " << result.second;
+            std::cout << std::setw(20) << out.str() << std::flush;
+        }
+        std::cout << std::endl;
+    }
+
+    swapBuffers();
+    std::exit(0);
+}
+
+}}
+
+MAGNUM_APPLICATION_MAIN(Magnum::Examples::ApiOverheadBenchmark)
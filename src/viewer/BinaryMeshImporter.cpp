@@ -0,0 +1,510 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "BinaryMeshImporter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <utility>
+#include <Math/Vector3.h>
+#include <Trade/MeshData3D.h>
+#include <Trade/MeshObjectData3D.h>
+#include <Trade/SceneData.h>
+
+#include "common/JobSystem.h"
+#include "common/MappedFile.h"
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+/* Items processed in one job when copying the arrays */
+constexpr std::size_t GrainSize = 65536;
+
+/* Runs in parallel if there is a job system, serially otherwise */
+void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& function) {
+    if(JobSystem::instance()) JobSystem::instance()->parallelFor(0, count, GrainSize, function);
+    else function(0, count);
+}
+
+bool isHostBigEndian() {
+    const UnsignedShort value = 1;
+    return *reinterpret_cast<const UnsignedByte*>(&value) == 0;
+}
+
+template<class T> inline T read(const char* data, bool swap) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    if(swap) {
+        char* bytes = reinterpret_cast<char*>(&value);
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    return value;
+}
+
+enum class PlyType: UnsignedByte {
+    Int8, UnsignedInt8, Int16, UnsignedInt16, Int32, UnsignedInt32, Float, Double
+};
+
+bool plyType(const std::string& name, PlyType& type) {
+    if(name == "char" || name == "int8") type = PlyType::Int8;
+    else if(name == "uchar" || name == "uint8") type = PlyType::UnsignedInt8;
+    else if(name == "short" || name == "int16") type = PlyType::Int16;
+    else if(name == "ushort" || name == "uint16") type = PlyType::UnsignedInt16;
+    else if(name == "int" || name == "int32") type = PlyType::Int32;
+    else if(name == "uint" || name == "uint32") type = PlyType::UnsignedInt32;
+    else if(name == "float" || name == "float32") type = PlyType::Float;
+    else if(name == "double" || name == "float64") type = PlyType::Double;
+    else return false;
+    return true;
+}
+
+std::size_t plyTypeSize(PlyType type) {
+    switch(type) {
+        case PlyType::Int8:
+        case PlyType::UnsignedInt8: return 1;
+        case PlyType::Int16:
+        case PlyType::UnsignedInt16: return 2;
+        case PlyType::Int32:
+        case PlyType::UnsignedInt32:
+        case PlyType::Float: return 4;
+        case PlyType::Double: return 8;
+    }
+
+    return 0;
+}
+
+Double readPly(const char* data, PlyType type, bool swap) {
+    switch(type) {
+        case PlyType::Int8: return read<Byte>(data, swap);
+        case PlyType::UnsignedInt8: return read<UnsignedByte>(data, swap);
+        case PlyType::Int16: return read<Short>(data, swap);
+        case PlyType::UnsignedInt16: return read<UnsignedShort>(data, swap);
+        case PlyType::Int32: return read<Int>(data, swap);
+        case PlyType::UnsignedInt32: return read<UnsignedInt>(data, swap);
+        case PlyType::Float: return read<Float>(data, swap);
+        case PlyType::Double: return read<Double>(data, swap);
+    }
+
+    return 0.0;
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type;
+    bool isList;
+    PlyType countType;
+
+    /* Offset in the element, valid only if the element has no lists */
+    std::size_t offset;
+};
+
+struct PlyElement {
+    std::string name;
+    std::size_t count;
+    std::vector<PlyProperty> properties;
+
+    /* Size of one item, zero if the element has lists */
+    std::size_t stride;
+};
+
+/* Parses PLY header, returns offset of the data or zero on failure */
+std::size_t parsePlyHeader(const char* data, std::size_t size, bool& bigEndian, std::vector<PlyElement>& elements) {
+    /* Header is text ending with end_header line */
+    static const char end[] = "\nend_header";
+    const char* const headerEnd = std::search(data, data + size, end, end + sizeof(end) - 1);
+    const char* const dataBegin = headerEnd == data + size ? nullptr :
+        static_cast<const char*>(std::memchr(headerEnd + 1, '\n', data + size - headerEnd - 1));
+    if(!dataBegin) {
+        Error() << "BinaryMeshImporter: PLY header end not found";
+        return 0;
+    }
+
+    std::istringstream header(std::string(data, headerEnd));
+    std::string line;
+    while(std::getline(header, line)) {
+        std::istringstream in(line);
+        std::string keyword;
+        in >> keyword;
+
+        if(keyword == "format") {
+            std::string format;
+            in >> format;
+            if(format == "binary_little_endian") bigEndian = false;
+            else if(format == "binary_big_endian") bigEndian = true;
+            else {
+                Error() << "BinaryMeshImporter: unsupported PLY format" << format;
+                return 0;
+            }
+
+        } else if(keyword == "element") {
+            PlyElement element{{}, 0, {}, 0};
+            in >> element.name >> element.count;
+            elements.push_back(element);
+
+        } else if(keyword == "property") {
+            if(elements.empty()) {
+                Error() << "BinaryMeshImporter: PLY property without element";
+                return 0;
+            }
+            PlyElement& element = elements.back();
+
+            PlyProperty property{{}, PlyType::Float, false, PlyType::UnsignedInt8, element.stride};
+            std::string type;
+            in >> type;
+            if(type == "list") {
+                std::string countType;
+                in >> countType >> type;
+                if(!plyType(countType, property.countType)) {
+                    Error() << "BinaryMeshImporter: unsupported PLY type" << countType;
+                    return 0;
+                }
+                property.isList = true;
+            }
+            if(!plyType(type, property.type)) {
+                Error() << "BinaryMeshImporter: unsupported PLY type" << type;
+                return 0;
+            }
+            in >> property.name;
+
+            /* Elements with lists don't have fixed size */
+            if(property.isList || (!element.properties.empty() && !element.stride))
+                element.stride = 0;
+            else element.stride += plyTypeSize(property.type);
+            element.properties.push_back(property);
+        }
+    }
+
+    return dataBegin + 1 - data;
+}
+
+/* Size of one item of element with lists */
+std::size_t plyItemSize(const char* data, const PlyElement& element, bool swap) {
+    std::size_t size = 0;
+    for(const PlyProperty& property: element.properties) {
+        if(!property.isList) {
+            size += plyTypeSize(property.type);
+            continue;
+        }
+
+        const std::size_t count = readPly(data + size, property.countType, swap);
+        size += plyTypeSize(property.countType) + count*plyTypeSize(property.type);
+    }
+    return size;
+}
+
+const PlyProperty* findProperty(const PlyElement& element, const char* name) {
+    for(const PlyProperty& property: element.properties)
+        if(property.name == name) return &property;
+    return nullptr;
+}
+
+/* Area-weighted smooth normals */
+std::vector<Vector3>* generateNormals(const std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions) {
+    std::vector<Vector3>* normals = new std::vector<Vector3>(positions.size());
+    for(std::size_t i = 0; i < indices.size(); i += 3) {
+        const Vector3 normal = Vector3::cross(positions[indices[i+1]] - positions[indices[i]], positions[indices[i+2]] - positions[indices[i]]);
+        for(std::size_t j = 0; j != 3; ++j)
+            (*normals)[indices[i+j]] += normal;
+    }
+
+    parallelFor(normals->size(), [normals](std::size_t first, std::size_t last) {
+        for(std::size_t i = first; i != last; ++i) {
+            const Float length = (*normals)[i].length();
+            (*normals)[i] = length > 0.0f ? (*normals)[i]/length : Vector3::zAxis();
+        }
+    });
+
+    return normals;
+}
+
+}
+
+BinaryMeshImporter::BinaryMeshImporter(): format(Format::Ply) {}
+
+BinaryMeshImporter::~BinaryMeshImporter() = default;
+
+bool BinaryMeshImporter::openFile(const std::string& filename) {
+    close();
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile(filename));
+    if(!mapped->isOpen()) return false;
+
+    /* PLY has magic, binary STL has 80-byte free-form header followed by
+       triangle count, check that the size matches */
+    if(mapped->size() >= 4 && std::strncmp(mapped->data(), "ply\n", 4) == 0)
+        format = Format::Ply;
+    else if(mapped->size() >= 84 && 84 + std::size_t(read<UnsignedInt>(mapped->data() + 80, isHostBigEndian()))*50 == mapped->size())
+        format = Format::Stl;
+    else {
+        Error() << "BinaryMeshImporter:" << filename << "is not binary PLY or STL file";
+        return false;
+    }
+
+    file = std::move(mapped);
+    return true;
+}
+
+void BinaryMeshImporter::close() {
+    file.reset();
+}
+
+UnsignedInt BinaryMeshImporter::sceneCount() const {
+    return file ? 1 : 0;
+}
+
+Trade::SceneData* BinaryMeshImporter::scene(UnsignedInt id) {
+    if(!file || id != 0) return nullptr;
+    return new Trade::SceneData({}, {0});
+}
+
+UnsignedInt BinaryMeshImporter::object3DCount() const {
+    return file ? 1 : 0;
+}
+
+Trade::ObjectData3D* BinaryMeshImporter::object3D(UnsignedInt id) {
+    if(!file || id != 0) return nullptr;
+    return new Trade::MeshObjectData3D({}, Matrix4(), 0, 0);
+}
+
+UnsignedInt BinaryMeshImporter::mesh3DCount() const {
+    return file ? 1 : 0;
+}
+
+Trade::MeshData3D* BinaryMeshImporter::mesh3D(UnsignedInt id) {
+    if(!file || id != 0) return nullptr;
+    return format == Format::Ply ? plyMesh() : stlMesh();
+}
+
+Trade::MeshData3D* BinaryMeshImporter::plyMesh() {
+    bool bigEndian = false;
+    std::vector<PlyElement> elements;
+    std::size_t offset = parsePlyHeader(file->data(), file->size(), bigEndian, elements);
+    if(!offset) return nullptr;
+    const bool swap = bigEndian != isHostBigEndian();
+
+    std::unique_ptr<std::vector<Vector3>> positions, normals;
+    std::unique_ptr<std::vector<UnsignedInt>> indices;
+    for(const PlyElement& element: elements) {
+        const char* const data = file->data() + offset;
+
+        /* Vertices */
+        if(element.name == "vertex") {
+            const PlyProperty* const x = findProperty(element, "x");
+            const PlyProperty* const y = findProperty(element, "y");
+            const PlyProperty* const z = findProperty(element, "z");
+            const PlyProperty* const nx = findProperty(element, "nx");
+            const PlyProperty* const ny = findProperty(element, "ny");
+            const PlyProperty* const nz = findProperty(element, "nz");
+            if(!element.stride || !x || !y || !z) {
+                Error() << "BinaryMeshImporter: PLY vertex element needs x, y, z properties and no lists";
+                return nullptr;
+            }
+            if(offset + element.count*element.stride > file->size()) {
+                Error() << "BinaryMeshImporter: PLY file is too short";
+                return nullptr;
+            }
+            file->adviseSequential(offset, element.count*element.stride);
+
+            positions.reset(new std::vector<Vector3>(element.count));
+            if(nx && ny && nz) normals.reset(new std::vector<Vector3>(element.count));
+
+            /* Most common case, three floats at the beginning, can be copied
+               directly */
+            const std::size_t stride = element.stride;
+            const bool direct = !swap && x->type == PlyType::Float && y->type == PlyType::Float && z->type == PlyType::Float &&
+                x->offset == 0 && y->offset == 4 && z->offset == 8;
+            std::vector<Vector3>* const p = positions.get();
+            std::vector<Vector3>* const n = normals.get();
+            parallelFor(element.count, [=](std::size_t first, std::size_t last) {
+                if(direct && stride == sizeof(Vector3))
+                    std::memcpy(p->data() + first, data + first*stride, (last - first)*stride);
+                else if(direct) for(std::size_t i = first; i != last; ++i)
+                    std::memcpy(&(*p)[i], data + i*stride, sizeof(Vector3));
+                else for(std::size_t i = first; i != last; ++i) {
+                    const char* const item = data + i*stride;
+                    (*p)[i] = Vector3(readPly(item + x->offset, x->type, swap),
+                                      readPly(item + y->offset, y->type, swap),
+                                      readPly(item + z->offset, z->type, swap));
+                }
+
+                if(n) for(std::size_t i = first; i != last; ++i) {
+                    const char* const item = data + i*stride;
+                    (*n)[i] = Vector3(readPly(item + nx->offset, nx->type, swap),
+                                      readPly(item + ny->offset, ny->type, swap),
+                                      readPly(item + nz->offset, nz->type, swap));
+                }
+            });
+
+            offset += element.count*stride;
+
+        /* Faces */
+        } else if(element.name == "face") {
+            if(!positions) {
+                Error() << "BinaryMeshImporter: PLY faces are expected after vertices";
+                return nullptr;
+            }
+
+            const PlyProperty* list = findProperty(element, "vertex_indices");
+            if(!list) list = findProperty(element, "vertex_index");
+            if(!list || !list->isList || element.properties.size() != 1) {
+                Error() << "BinaryMeshImporter: PLY face element needs to have only vertex_indices list";
+                return nullptr;
+            }
+            const PlyType countType = list->countType;
+            const PlyType indexType = list->type;
+            const std::size_t countSize = plyTypeSize(countType);
+            const std::size_t indexSize = plyTypeSize(indexType);
+            const std::size_t vertexCount = positions->size();
+
+            /* Triangle-only files have fixed face size, so the indices can be
+               copied in parallel. Face sizes are verified during the copy. */
+            const std::size_t stride = countSize + 3*indexSize;
+            if(offset + element.count*stride <= file->size()) {
+                file->adviseSequential(offset, element.count*stride);
+
+                indices.reset(new std::vector<UnsignedInt>(element.count*3));
+                std::vector<UnsignedInt>* const out = indices.get();
+                std::atomic<bool> triangles(true), valid(true);
+                parallelFor(element.count, [&](std::size_t first, std::size_t last) {
+                    for(std::size_t i = first; i != last; ++i) {
+                        const char* const face = data + i*stride;
+                        if(!triangles || readPly(face, countType, swap) != 3) {
+                            triangles = false;
+                            return;
+                        }
+                        for(std::size_t j = 0; j != 3; ++j) {
+                            const UnsignedInt index = readPly(face + countSize + j*indexSize, indexType, swap);
+                            if(index >= vertexCount) valid = false;
+                            (*out)[i*3 + j] = index;
+                        }
+                    }
+                });
+
+                if(triangles && !valid) {
+                    Error() << "BinaryMeshImporter: PLY face index out of bounds";
+                    return nullptr;
+                }
+                if(triangles) {
+                    offset += element.count*stride;
+                    if(positions && indices) break;
+                    continue;
+                }
+            }
+
+            /* Polygons, triangulate them as fans */
+            indices.reset(new std::vector<UnsignedInt>);
+            indices->reserve(element.count*3);
+            for(std::size_t i = 0; i != element.count; ++i) {
+                if(offset + countSize > file->size()) {
+                    Error() << "BinaryMeshImporter: PLY file is too short";
+                    return nullptr;
+                }
+                const char* const face = file->data() + offset;
+                const std::size_t count = readPly(face, countType, swap);
+                offset += countSize + count*indexSize;
+                if(offset > file->size()) {
+                    Error() << "BinaryMeshImporter: PLY file is too short";
+                    return nullptr;
+                }
+
+                /* Points and lines don't produce any triangle, don't touch
+                   their (possibly nonexistent) indices */
+                if(count < 3) continue;
+
+                const UnsignedInt first = readPly(face + countSize, indexType, swap);
+                for(std::size_t j = 2; j < count; ++j) {
+                    const UnsignedInt second = readPly(face + countSize + (j - 1)*indexSize, indexType, swap);
+                    const UnsignedInt third = readPly(face + countSize + j*indexSize, indexType, swap);
+                    if(first >= vertexCount || second >= vertexCount || third >= vertexCount) {
+                        Error() << "BinaryMeshImporter: PLY face index out of bounds";
+                        return nullptr;
+                    }
+                    indices->push_back(first);
+                    indices->push_back(second);
+                    indices->push_back(third);
+                }
+            }
+
+        /* Skip other elements */
+        } else if(element.stride) offset += element.count*element.stride;
+        else for(std::size_t i = 0; i != element.count; ++i) {
+            if(offset >= file->size()) break;
+            offset += plyItemSize(file->data() + offset, element, swap);
+        }
+
+        if(positions && indices) break;
+    }
+
+    if(!positions || !indices || indices->empty()) {
+        Error() << "BinaryMeshImporter: PLY file has no triangles";
+        return nullptr;
+    }
+
+    if(!normals) normals.reset(generateNormals(*indices, *positions));
+
+    return new Trade::MeshData3D(Mesh::Primitive::Triangles, indices.release(), {positions.release()}, {normals.release()}, {});
+}
+
+Trade::MeshData3D* BinaryMeshImporter::stlMesh() {
+    /* Triangle count was verified in openFile(), each triangle has normal,
+       three vertices and two-byte attribute */
+    const bool swap = isHostBigEndian();
+    const std::size_t triangleCount = (file->size() - 84)/50;
+    const char* const data = file->data() + 84;
+    file->adviseSequential(84, triangleCount*50);
+
+    std::vector<UnsignedInt>* indices = new std::vector<UnsignedInt>(triangleCount*3);
+    std::vector<Vector3>* positions = new std::vector<Vector3>(triangleCount*3);
+    std::vector<Vector3>* normals = new std::vector<Vector3>(triangleCount*3);
+    parallelFor(triangleCount, [=](std::size_t first, std::size_t last) {
+        for(std::size_t i = first; i != last; ++i) {
+            const char* const triangle = data + i*50;
+            Vector3 v[4];
+            if(swap) for(std::size_t j = 0; j != 12; ++j)
+                v[j/3][j%3] = read<Float>(triangle + j*4, true);
+            else std::memcpy(v, triangle, sizeof(v));
+
+            /* Some exporters leave the normal zero */
+            Vector3 normal = v[0];
+            if(normal.length() == 0.0f) {
+                normal = Vector3::cross(v[2] - v[1], v[3] - v[1]);
+                normal = normal.length() > 0.0f ? normal.normalized() : Vector3::zAxis();
+            }
+
+            for(std::size_t j = 0; j != 3; ++j) {
+                (*indices)[i*3 + j] = i*3 + j;
+                (*positions)[i*3 + j] = v[j + 1];
+                (*normals)[i*3 + j] = normal;
+            }
+        }
+    });
+
+    return new Trade::MeshData3D(Mesh::Primitive::Triangles, indices, {positions}, {normals}, {});
+}
+
+}}
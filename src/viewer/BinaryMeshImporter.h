@@ -0,0 +1,90 @@
+#ifndef Magnum_Examples_BinaryMeshImporter_h
+#define Magnum_Examples_BinaryMeshImporter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <Trade/AbstractImporter.h>
+
+namespace Magnum { namespace Examples {
+
+class MappedFile;
+
+/**
+@brief Importer for binary PLY and STL files
+
+Intended for large scans, which are slow to load with XML-based formats. The
+file is memory-mapped and vertex and index arrays are copied out of it
+directly, in parallel using JobSystem, if there is an instance. Only the
+header is parsed as text.
+
+Supported are binary little- and big-endian PLY files with `vertex` element
+having `x`, `y`, `z` and optionally `nx`, `ny`, `nz` properties of any scalar
+type and `face` element with `vertex_indices` (or `vertex_index`) list.
+Polygons with more than three vertices are triangulated as fans. If the file
+has no normals, smooth normals are generated.
+
+STL files are binary only. As STL has no vertex sharing, each triangle has its
+own three vertices with the face normal.
+
+The file contains one scene with one object instancing the only mesh, without
+material.
+*/
+class BinaryMeshImporter: public Trade::AbstractImporter {
+    public:
+        explicit BinaryMeshImporter();
+        ~BinaryMeshImporter();
+
+        inline Features features() const override { return Feature::OpenFile; }
+
+        /**
+         * @brief Open file
+         *
+         * Format is detected from file contents, not from extension.
+         */
+        bool openFile(const std::string& filename) override;
+
+        void close() override;
+
+        inline Int defaultScene() override { return 0; }
+        UnsignedInt sceneCount() const override;
+        Trade::SceneData* scene(UnsignedInt id) override;
+        UnsignedInt object3DCount() const override;
+        Trade::ObjectData3D* object3D(UnsignedInt id) override;
+        UnsignedInt mesh3DCount() const override;
+        Trade::MeshData3D* mesh3D(UnsignedInt id) override;
+
+    private:
+        enum class Format: UnsignedByte { Ply, Stl };
+
+        Trade::MeshData3D* plyMesh();
+        Trade::MeshData3D* stlMesh();
+
+        std::unique_ptr<MappedFile> file;
+        Format format;
+};
+
+}}
+
+#endif
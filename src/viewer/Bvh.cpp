@@ -0,0 +1,368 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Bvh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "common/JobSystem.h"
+
+namespace Magnum { namespace Examples {
+
+namespace {
+    constexpr std::size_t BinCount = 16;
+
+    /* Smallest subtree worth building on another thread */
+    constexpr std::size_t ParallelThreshold = 4096;
+
+    /* Deeper nodes are made leaves, so the traversal stack can't overflow */
+    constexpr std::size_t MaxDepth = 60;
+    constexpr std::size_t StackSize = MaxDepth + 4;
+
+    inline void extend(Vector3& min, Vector3& max, const Vector3& otherMin, const Vector3& otherMax) {
+        for(std::size_t i = 0; i != 3; ++i) {
+            min[i] = std::min(min[i], otherMin[i]);
+            max[i] = std::max(max[i], otherMax[i]);
+        }
+    }
+
+    inline Float halfArea(const Vector3& min, const Vector3& max) {
+        const Vector3 size = max - min;
+        return size.x()*size.y() + size.y()*size.z() + size.z()*size.x();
+    }
+
+    class Builder {
+        public:
+            explicit Builder(const std::vector<BvhBounds>& bounds, std::size_t maxLeafSize, std::vector<UnsignedInt>& order): bounds(bounds), order(order), nodes(bounds.size()*2), nodeCount(1), maxLeafSize(std::max(maxLeafSize, std::size_t(1))), jobs(JobSystem::instance()) {
+                centroids.reserve(bounds.size());
+                for(const BvhBounds& b: bounds) centroids.push_back((b.min + b.max)*0.5f);
+            }
+
+            std::vector<BvhNode> build() {
+                buildNode(0, 0, bounds.size(), 0);
+                nodes.resize(nodeCount);
+                return std::move(nodes);
+            }
+
+        private:
+            void buildNode(std::size_t id, std::size_t begin, std::size_t end, std::size_t depth);
+
+            const std::vector<BvhBounds>& bounds;
+            std::vector<Vector3> centroids;
+            std::vector<UnsignedInt>& order;
+            std::vector<BvhNode> nodes;
+            std::atomic<std::size_t> nodeCount;
+            std::size_t maxLeafSize;
+            JobSystem* jobs;
+    };
+
+    void Builder::buildNode(const std::size_t id, const std::size_t begin, const std::size_t end, const std::size_t depth) {
+        /* Node bounds and bounds of primitive centroids */
+        BvhNode& node = nodes[id];
+        node.min = bounds[order[begin]].min;
+        node.max = bounds[order[begin]].max;
+        Vector3 centroidMin = centroids[order[begin]];
+        Vector3 centroidMax = centroidMin;
+        for(std::size_t i = begin + 1; i != end; ++i) {
+            extend(node.min, node.max, bounds[order[i]].min, bounds[order[i]].max);
+            extend(centroidMin, centroidMax, centroids[order[i]], centroids[order[i]]);
+        }
+
+        node.first = begin;
+        node.count = end - begin;
+        if(end - begin <= maxLeafSize || depth == MaxDepth) return;
+
+        /* Bin the primitives on all axes at once, so they are traversed
+           only once */
+        Float scale[3];
+        for(std::size_t axis = 0; axis != 3; ++axis) {
+            const Float extent = centroidMax[axis] - centroidMin[axis];
+            scale[axis] = extent > 0.0f ? BinCount/extent : 0.0f;
+        }
+        std::size_t binCounts[3][BinCount]{};
+        Vector3 binMins[3][BinCount], binMaxs[3][BinCount];
+        for(std::size_t i = begin; i != end; ++i) {
+            const UnsignedInt primitive = order[i];
+            for(std::size_t axis = 0; axis != 3; ++axis) {
+                if(scale[axis] == 0.0f) continue;
+                const std::size_t bin = std::min(std::size_t((centroids[primitive][axis] - centroidMin[axis])*scale[axis]), BinCount - 1);
+                if(!binCounts[axis][bin]++) {
+                    binMins[axis][bin] = bounds[primitive].min;
+                    binMaxs[axis][bin] = bounds[primitive].max;
+                } else extend(binMins[axis][bin], binMaxs[axis][bin], bounds[primitive].min, bounds[primitive].max);
+            }
+        }
+
+        /* Find split with the lowest SAH cost */
+        Float bestCost = std::numeric_limits<Float>::infinity();
+        std::size_t bestAxis = 0, bestSplit = 0;
+        for(std::size_t axis = 0; axis != 3; ++axis) {
+            if(scale[axis] == 0.0f) continue;
+            const std::size_t* counts = binCounts[axis];
+            const Vector3* binMin = binMins[axis];
+            const Vector3* binMax = binMaxs[axis];
+
+            /* Area and count left of each split, then sweep from the right */
+            Float leftArea[BinCount - 1];
+            std::size_t leftCount[BinCount - 1];
+            Vector3 min, max;
+            std::size_t count = 0;
+            for(std::size_t i = 0; i != BinCount - 1; ++i) {
+                if(counts[i]) {
+                    if(!count) {
+                        min = binMin[i];
+                        max = binMax[i];
+                    } else extend(min, max, binMin[i], binMax[i]);
+                    count += counts[i];
+                }
+                leftArea[i] = count ? halfArea(min, max) : 0.0f;
+                leftCount[i] = count;
+            }
+
+            count = 0;
+            for(std::size_t i = BinCount - 1; i != 0; --i) {
+                if(counts[i]) {
+                    if(!count) {
+                        min = binMin[i];
+                        max = binMax[i];
+                    } else extend(min, max, binMin[i], binMax[i]);
+                    count += counts[i];
+                }
+                if(!count || !leftCount[i - 1]) continue;
+
+                const Float cost = leftCount[i - 1]*leftArea[i - 1] + count*halfArea(min, max);
+                if(cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        /* All centroids at the same place, nothing to split */
+        if(bestCost == std::numeric_limits<Float>::infinity()) return;
+
+        const std::size_t middle = std::partition(order.begin() + begin, order.begin() + end, [&](UnsignedInt primitive) {
+            return std::min(std::size_t((centroids[primitive][bestAxis] - centroidMin[bestAxis])*scale[bestAxis]), BinCount - 1) < bestSplit;
+        }) - order.begin();
+
+        /* Children are allocated next to each other, possibly from more
+           threads at once */
+        const std::size_t left = nodeCount.fetch_add(2);
+        node.first = left;
+        node.count = 0;
+
+        if(jobs && end - begin >= ParallelThreshold) {
+            JobSystem::JobHandle job = jobs->add([this, left, begin, middle, depth]() {
+                buildNode(left, begin, middle, depth + 1);
+            });
+            buildNode(left + 1, middle, end, depth + 1);
+            jobs->wait(job);
+        } else {
+            buildNode(left, begin, middle, depth + 1);
+            buildNode(left + 1, middle, end, depth + 1);
+        }
+    }
+
+    /* Slab test, returns entry distance in near */
+    inline bool intersectBounds(const Vector3& min, const Vector3& max, const Vector3& origin, const Vector3& inverseDirection, Float maxDistance, Float& near) {
+        Float far = maxDistance;
+        near = 0.0f;
+        for(std::size_t i = 0; i != 3; ++i) {
+            const Float a = (min[i] - origin[i])*inverseDirection[i];
+            const Float b = (max[i] - origin[i])*inverseDirection[i];
+            near = std::max(near, std::min(a, b));
+            far = std::min(far, std::max(a, b));
+        }
+        return near <= far;
+    }
+
+    /* Möller-Trumbore */
+    inline bool intersectTriangle(const Vector3& origin, const Vector3& direction, const Vector3* vertices, Float& distance) {
+        const Vector3 edge1 = vertices[1] - vertices[0];
+        const Vector3 edge2 = vertices[2] - vertices[0];
+        const Vector3 p = Vector3::cross(direction, edge2);
+        const Float determinant = Vector3::dot(edge1, p);
+        if(determinant == 0.0f) return false;
+
+        const Float inverseDeterminant = 1.0f/determinant;
+        const Vector3 s = origin - vertices[0];
+        const Float u = Vector3::dot(s, p)*inverseDeterminant;
+        if(u < 0.0f || u > 1.0f) return false;
+
+        const Vector3 q = Vector3::cross(s, edge1);
+        const Float v = Vector3::dot(direction, q)*inverseDeterminant;
+        if(v < 0.0f || u + v > 1.0f) return false;
+
+        distance = Vector3::dot(edge2, q)*inverseDeterminant;
+        return distance >= 0.0f;
+    }
+
+    inline Vector3 inverse(const Vector3& direction) {
+        return {1.0f/direction.x(), 1.0f/direction.y(), 1.0f/direction.z()};
+    }
+
+    /* Traverse the hierarchy front to back, calls leaf(first, count) for
+       each leaf hit closer than current distance, which the function
+       updates */
+    template<class Leaf> bool traverse(const std::vector<BvhNode>& nodes, const Vector3& origin, const Vector3& direction, Float& distance, Leaf leaf) {
+        if(nodes.empty()) return false;
+
+        const Vector3 inverseDirection = inverse(direction);
+        Float near;
+        if(!intersectBounds(nodes[0].min, nodes[0].max, origin, inverseDirection, distance, near))
+            return false;
+
+        /* Nodes to visit with their entry distance, so the ones farther than
+           a hit found meanwhile can be skipped */
+        std::pair<UnsignedInt, Float> stack[StackSize];
+        std::size_t stackSize = 0;
+        stack[stackSize++] = {0, near};
+        bool hit = false;
+        while(stackSize) {
+            const std::pair<UnsignedInt, Float> entry = stack[--stackSize];
+            if(entry.second > distance) continue;
+
+            const BvhNode& node = nodes[entry.first];
+            if(node.count) {
+                if(leaf(node.first, node.count)) hit = true;
+                continue;
+            }
+
+            /* Push farther child first, so the nearer is processed first and
+               shortens the distance for the farther one */
+            Float nearA, nearB;
+            const bool hitA = intersectBounds(nodes[node.first].min, nodes[node.first].max, origin, inverseDirection, distance, nearA);
+            const bool hitB = intersectBounds(nodes[node.first + 1].min, nodes[node.first + 1].max, origin, inverseDirection, distance, nearB);
+            if(hitA && hitB) {
+                if(nearA <= nearB) {
+                    stack[stackSize++] = {node.first + 1, nearB};
+                    stack[stackSize++] = {node.first, nearA};
+                } else {
+                    stack[stackSize++] = {node.first, nearA};
+                    stack[stackSize++] = {node.first + 1, nearB};
+                }
+            } else if(hitA) stack[stackSize++] = {node.first, nearA};
+            else if(hitB) stack[stackSize++] = {node.first + 1, nearB};
+        }
+
+        return hit;
+    }
+}
+
+std::vector<BvhNode> buildBvh(const std::vector<BvhBounds>& bounds, std::size_t maxLeafSize, std::vector<UnsignedInt>& order) {
+    order.resize(bounds.size());
+    for(std::size_t i = 0; i != order.size(); ++i) order[i] = i;
+    if(bounds.empty()) return {};
+
+    return Builder(bounds, maxLeafSize, order).build();
+}
+
+MeshBvh::MeshBvh(const std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions) {
+    std::vector<BvhBounds> bounds(indices.size()/3);
+    for(std::size_t i = 0; i != bounds.size(); ++i) {
+        bounds[i].min = bounds[i].max = positions[indices[i*3]];
+        for(std::size_t j = 1; j != 3; ++j)
+            extend(bounds[i].min, bounds[i].max, positions[indices[i*3 + j]], positions[indices[i*3 + j]]);
+    }
+
+    nodes = buildBvh(bounds, 4, triangleIds);
+
+    /* Triangle vertices in BVH order */
+    vertices.reserve(triangleIds.size()*3);
+    for(UnsignedInt triangle: triangleIds)
+        for(std::size_t j = 0; j != 3; ++j)
+            vertices.push_back(positions[indices[triangle*3 + j]]);
+}
+
+std::size_t MeshBvh::memorySize() const {
+    return nodes.size()*sizeof(BvhNode) + vertices.size()*sizeof(Vector3) + triangleIds.size()*sizeof(UnsignedInt);
+}
+
+BvhBounds MeshBvh::bounds() const {
+    if(nodes.empty()) return {};
+    return {nodes[0].min, nodes[0].max};
+}
+
+bool MeshBvh::intersect(const Vector3& origin, const Vector3& direction, Float& distance, UnsignedInt& triangle) const {
+    return traverse(nodes, origin, direction, distance, [&](UnsignedInt first, UnsignedInt count) {
+        bool hit = false;
+        for(std::size_t i = first; i != first + count; ++i) {
+            Float triangleDistance;
+            if(intersectTriangle(origin, direction, vertices.data() + i*3, triangleDistance) && triangleDistance < distance) {
+                distance = triangleDistance;
+                triangle = triangleIds[i];
+                hit = true;
+            }
+        }
+        return hit;
+    });
+}
+
+void SceneBvh::addInstance(const MeshBvh* bvh, const Matrix4& transformation, ViewedObject* object) {
+    /* World bounds from transformed corners of mesh bounds */
+    const BvhBounds meshBounds = bvh->bounds();
+    BvhBounds bounds;
+    for(std::size_t i = 0; i != 8; ++i) {
+        const Vector3 corner = transformation.transformPoint({
+            i & 1 ? meshBounds.max.x() : meshBounds.min.x(),
+            i & 2 ? meshBounds.max.y() : meshBounds.min.y(),
+            i & 4 ? meshBounds.max.z() : meshBounds.min.z()});
+        if(!i) bounds.min = bounds.max = corner;
+        else extend(bounds.min, bounds.max, corner, corner);
+    }
+
+    instances.push_back({bvh, transformation.inverted(), object, bounds});
+}
+
+void SceneBvh::build() {
+    std::vector<BvhBounds> bounds;
+    bounds.reserve(instances.size());
+    for(const Instance& instance: instances) bounds.push_back(instance.bounds);
+    nodes = buildBvh(bounds, 1, order);
+}
+
+bool SceneBvh::intersect(const Vector3& origin, const Vector3& direction, Hit& hit) const {
+    Float distance = std::numeric_limits<Float>::infinity();
+    return traverse(nodes, origin, direction, distance, [&](UnsignedInt first, UnsignedInt count) {
+        bool found = false;
+        for(std::size_t i = first; i != first + count; ++i) {
+            /* Distance is preserved, as the direction is not normalized after
+               the transformation */
+            const Instance& instance = instances[order[i]];
+            if(instance.bvh->intersect(instance.inverted.transformPoint(origin), instance.inverted.transformVector(direction), distance, hit.triangle)) {
+                hit.object = instance.object;
+                hit.distance = distance;
+                found = true;
+            }
+        }
+        return found;
+    });
+}
+
+}}
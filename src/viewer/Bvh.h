@@ -0,0 +1,175 @@
+#ifndef Magnum_Examples_Bvh_h
+#define Magnum_Examples_Bvh_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <Math/Matrix4.h>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+class ViewedObject;
+
+/** @brief Axis-aligned bounding box */
+struct BvhBounds {
+    Vector3 min;    /**< @brief Minimum */
+    Vector3 max;    /**< @brief Maximum */
+};
+
+/** @brief BVH node */
+struct BvhNode {
+    Vector3 min;        /**< @brief Bounds minimum */
+
+    /**
+     * @brief First child or first primitive
+     *
+     * For inner nodes index of first child node, the second child is right
+     * after it. For leaf nodes index of first primitive in primitive order.
+     */
+    UnsignedInt first;
+
+    Vector3 max;        /**< @brief Bounds maximum */
+    UnsignedInt count;  /**< @brief Primitive count, `0` for inner nodes */
+};
+
+/**
+@brief Build bounding volume hierarchy
+@param bounds       Primitive bounds
+@param maxLeafSize  Max primitive count in leaf node
+@param order        Primitive order, leaf nodes reference ranges in it
+
+Splits are chosen with surface area heuristic over 16 bins of primitive
+centroids on each axis. Large subtrees are built in parallel using
+@ref JobSystem, if there is an instance. Root node has index `0`. Returns
+empty list if there are no primitives.
+*/
+std::vector<BvhNode> buildBvh(const std::vector<BvhBounds>& bounds, std::size_t maxLeafSize, std::vector<UnsignedInt>& order);
+
+/**
+@brief Mesh BVH
+
+BVH over triangles of one mesh in its own coordinate system. Triangle
+vertices are stored in BVH order, so the leaf tests don't need to go through
+the index buffer.
+*/
+class MeshBvh {
+    public:
+        /**
+         * @brief Constructor
+         * @param indices       Triangle indices
+         * @param positions     Vertex positions
+         */
+        explicit MeshBvh(const std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions);
+
+        /** @brief Triangle count */
+        inline std::size_t triangleCount() const { return triangleIds.size(); }
+
+        /** @brief Node count */
+        inline std::size_t nodeCount() const { return nodes.size(); }
+
+        /** @brief Memory used by the BVH in bytes */
+        std::size_t memorySize() const;
+
+        /** @brief Bounds of all triangles */
+        BvhBounds bounds() const;
+
+        /**
+         * @brief Intersect ray with the triangles
+         * @param origin        Ray origin
+         * @param direction     Ray direction, doesn't need to be normalized
+         * @param distance      Max distance in multiples of @p direction,
+         *      set to distance of the hit if there is any
+         * @param triangle      Set to index of the hit triangle, if there is
+         *      any
+         *
+         * Returns `true` if the ray hits any triangle closer than
+         * @p distance. Both sides of the triangles are hit.
+         */
+        bool intersect(const Vector3& origin, const Vector3& direction, Float& distance, UnsignedInt& triangle) const;
+
+    private:
+        std::vector<BvhNode> nodes;
+        std::vector<Vector3> vertices;
+        std::vector<UnsignedInt> triangleIds;
+};
+
+/**
+@brief Scene BVH
+
+Top-level BVH over instances of meshes with @ref MeshBvh. Rays are
+transformed into coordinate system of each instance, so the mesh BVH is
+shared by all its instances.
+*/
+class SceneBvh {
+    public:
+        /** @brief Ray hit */
+        struct Hit {
+            ViewedObject* object;   /**< @brief Hit object */
+            UnsignedInt triangle;   /**< @brief Triangle in object mesh */
+            Float distance;         /**< @brief Distance from ray origin */
+        };
+
+        /**
+         * @brief Add instance
+         * @param bvh               Mesh BVH
+         * @param transformation    Instance transformation
+         * @param object            Object to report in hits
+         *
+         * The instances are not searched until build() is called.
+         */
+        void addInstance(const MeshBvh* bvh, const Matrix4& transformation, ViewedObject* object);
+
+        /** @brief Build the BVH over added instances */
+        void build();
+
+        /** @brief Instance count */
+        inline std::size_t instanceCount() const { return instances.size(); }
+
+        /**
+         * @brief Intersect ray with the scene
+         * @param origin        Ray origin
+         * @param direction     Ray direction, doesn't need to be normalized
+         * @param hit           Nearest hit, if there is any
+         *
+         * Distance in the hit is in multiples of @p direction.
+         */
+        bool intersect(const Vector3& origin, const Vector3& direction, Hit& hit) const;
+
+    private:
+        struct Instance {
+            const MeshBvh* bvh;
+            Matrix4 inverted;
+            ViewedObject* object;
+            BvhBounds bounds;
+        };
+
+        std::vector<Instance> instances;
+        std::vector<BvhNode> nodes;
+        std::vector<UnsignedInt> order;
+};
+
+}}
+
+#endif
@@ -0,0 +1,248 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <PluginManager/PluginManager.h>
+#include <Trade/AbstractImporter.h>
+#include <Trade/MeshData3D.h>
+#include <Trade/MeshObjectData3D.h>
+#include <Trade/SceneData.h>
+
+#include "common/JobSystem.h"
+#include "BinaryMeshImporter.h"
+#include "Bvh.h"
+#include "configure.h"
+
+using namespace Corrade::PluginManager;
+using namespace Magnum::Trade;
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Builds the same BVHs as the viewer does for picking on all meshes in given
+ * file, first on one thread and then with the job system, and measures
+ * throughput of random rays through the scene bounding box, again on one
+ * thread and with the job system. The rays are incoherent, so it is closer to
+ * the worst case than to picking rays, which are all from the same origin.
+ */
+namespace {
+
+struct Scene {
+    std::unordered_map<UnsignedInt, std::vector<UnsignedInt>> indices;
+    std::unordered_map<UnsignedInt, std::vector<Vector3>> positions;
+    std::vector<std::pair<UnsignedInt, Matrix4>> instances;
+};
+
+struct Ray {
+    Vector3 origin, direction;
+};
+
+bool addObject(AbstractImporter* importer, Scene& scene, UnsignedInt objectId, const Matrix4& parentTransformation) {
+    std::unique_ptr<ObjectData3D> object(importer->object3D(objectId));
+    if(!object) return false;
+    const Matrix4 transformation = parentTransformation*object->transformation();
+
+    if(object->instanceType() == ObjectData3D::InstanceType::Mesh) {
+        const UnsignedInt meshId = object->instanceId();
+        if(scene.indices.find(meshId) == scene.indices.end()) {
+            std::unique_ptr<MeshData3D> data(importer->mesh3D(meshId));
+            if(!data || !data->indices() || !data->positionArrayCount()) return false;
+            scene.indices[meshId] = *data->indices();
+            scene.positions[meshId] = *data->positions(0);
+        }
+        scene.instances.emplace_back(meshId, transformation);
+    }
+
+    for(UnsignedInt id: object->children())
+        if(!addObject(importer, scene, id, transformation)) return false;
+    return true;
+}
+
+Double buildAll(const Scene& scene, std::unordered_map<UnsignedInt, std::unique_ptr<MeshBvh>>& meshes, SceneBvh& sceneBvh) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(const auto& mesh: scene.indices)
+        meshes[mesh.first].reset(new MeshBvh(mesh.second, scene.positions.at(mesh.first)));
+    for(const auto& instance: scene.instances)
+        sceneBvh.addInstance(meshes[instance.first].get(), instance.second, nullptr);
+    sceneBvh.build();
+    return std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+std::size_t castRays(const SceneBvh& bvh, const std::vector<Ray>& rays, std::size_t begin, std::size_t end) {
+    std::size_t hits = 0;
+    SceneBvh::Hit hit;
+    for(std::size_t i = begin; i != end; ++i)
+        if(bvh.intersect(rays[i].origin, rays[i].direction, hit)) ++hits;
+    return hits;
+}
+
+}
+
+int benchmark(int argc, char** argv) {
+    const char* filename = nullptr;
+    std::size_t rayCount = 1000000;
+    for(int i = 1; i != argc; ++i) {
+        if(std::strcmp(argv[i], "--rays") == 0 && i + 1 != argc && std::atoi(argv[i + 1]) > 0)
+            rayCount = std::atoi(argv[++i]);
+        else if(argv[i][0] != '-' && !filename) filename = argv[i];
+        else {
+            filename = nullptr;
+            break;
+        }
+    }
+    if(!filename) {
+        std::cout << "Usage: " << argv[0] << " [--rays N] file.dae|file.ply|file.stl" << std::endl;
+        return 0;
+    }
+
+    /* Same importers as in the viewer */
+    std::string extension = filename;
+    extension = extension.substr(std::min(extension.size(), extension.rfind('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    PluginManager<AbstractImporter> manager(MAGNUM_PLUGINS_IMPORTER_DIR);
+    std::unique_ptr<AbstractImporter> importer;
+    if(extension == ".ply" || extension == ".stl") importer.reset(new BinaryMeshImporter);
+    else {
+        if(manager.load("ColladaImporter") != LoadState::Loaded) {
+            Error() << "Could not load ColladaImporter plugin";
+            return 1;
+        }
+        importer.reset(manager.instance("ColladaImporter"));
+    }
+    if(!importer || !importer->openFile(filename) || !importer->sceneCount()) {
+        Error() << "Could not open" << filename;
+        return 2;
+    }
+
+    Scene scene;
+    std::unique_ptr<SceneData> sceneData(importer->scene(importer->defaultScene()));
+    for(UnsignedInt id: sceneData->children3D()) if(!addObject(importer.get(), scene, id, Matrix4())) {
+        Error() << "Cannot import object" << id << "from" << filename;
+        return 3;
+    }
+    if(scene.instances.empty()) {
+        Error() << "No indexed meshes in" << filename;
+        return 3;
+    }
+
+    std::size_t triangleCount = 0, instancedTriangleCount = 0;
+    for(const auto& mesh: scene.indices) triangleCount += mesh.second.size()/3;
+    for(const auto& instance: scene.instances) instancedTriangleCount += scene.indices.at(instance.first).size()/3;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << scene.indices.size() << " meshes with " << triangleCount << " triangles, " << scene.instances.size() << " instances with " << instancedTriangleCount << " triangles" << std::endl;
+
+    /* Build without job system first, the builder uses it if it exists */
+    std::unordered_map<UnsignedInt, std::unique_ptr<MeshBvh>> meshes;
+    std::unique_ptr<SceneBvh> bvh(new SceneBvh);
+    const Double serialBuildTime = buildAll(scene, meshes, *bvh);
+
+    JobSystem jobs;
+    meshes.clear();
+    bvh.reset(new SceneBvh);
+    const Double parallelBuildTime = buildAll(scene, meshes, *bvh);
+
+    std::size_t nodeCount = 0, memorySize = 0;
+    for(const auto& mesh: meshes) {
+        nodeCount += mesh.second->nodeCount();
+        memorySize += mesh.second->memorySize();
+    }
+    std::cout << "Build: " << serialBuildTime << " ms on one thread, " << parallelBuildTime << " ms with " << jobs.workerCount() << " workers, "
+              << nodeCount << " nodes, " << memorySize/1024 << " kB" << std::endl;
+
+    /* Rays between random points on bounding sphere of the scene and random
+       points inside its bounding box, generated upfront so only the traversal
+       is measured */
+    BvhBounds bounds{Vector3(std::numeric_limits<Float>::max()), Vector3(-std::numeric_limits<Float>::max())};
+    for(const auto& instance: scene.instances) {
+        const BvhBounds meshBounds = meshes[instance.first]->bounds();
+        for(std::size_t corner = 0; corner != 8; ++corner) {
+            const Vector3 point = instance.second.transformPoint({
+                (corner & 1 ? meshBounds.max : meshBounds.min).x(),
+                (corner & 2 ? meshBounds.max : meshBounds.min).y(),
+                (corner & 4 ? meshBounds.max : meshBounds.min).z()});
+            for(std::size_t i = 0; i != 3; ++i) {
+                bounds.min[i] = std::min(bounds.min[i], point[i]);
+                bounds.max[i] = std::max(bounds.max[i], point[i]);
+            }
+        }
+    }
+    const Vector3 center = (bounds.min + bounds.max)/2.0f;
+    const Float radius = (bounds.max - bounds.min).length()/2.0f;
+
+    std::mt19937 random(17);
+    std::uniform_real_distribution<Float> unit(0.0f, 1.0f);
+    std::normal_distribution<Float> normal;
+    std::vector<Ray> rays(rayCount);
+    for(Ray& ray: rays) {
+        Vector3 onSphere;
+        do onSphere = Vector3(normal(random), normal(random), normal(random));
+        while(onSphere.length() < 1.0e-6f);
+        ray.origin = center + onSphere.normalized()*radius;
+
+        Vector3 target;
+        for(std::size_t i = 0; i != 3; ++i)
+            target[i] = bounds.min[i] + (bounds.max[i] - bounds.min[i])*unit(random);
+        ray.direction = target - ray.origin;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const std::size_t hits = castRays(*bvh, rays, 0, rays.size());
+    const Double serialTime = std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::atomic<std::size_t> parallelHits{0};
+    start = std::chrono::high_resolution_clock::now();
+    jobs.parallelFor(0, rays.size(), 4096, [&](std::size_t begin, std::size_t end) {
+        parallelHits += castRays(*bvh, rays, begin, end);
+    });
+    const Double parallelTime = std::chrono::duration<Double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    if(hits != parallelHits) {
+        Error() << "Parallel traversal found" << parallelHits << "hits instead of" << hits;
+        return 4;
+    }
+
+    std::cout << "Rays: " << rays.size() << ", " << hits*100.0/rays.size() << "% hit" << std::endl
+              << "  one thread: " << rays.size()/serialTime/1.0e6 << " Mrays/s, " << serialTime*1.0e6/rays.size() << " us per ray" << std::endl
+              << "  " << jobs.workerCount() << " workers: " << rays.size()/parallelTime/1.0e6 << " Mrays/s, " << parallelTime*1.0e6/rays.size() << " us per ray" << std::endl;
+
+    return 0;
+}
+
+}}
+
+int main(int argc, char** argv) {
+    return Magnum::Examples::benchmark(argc, argv);
+}
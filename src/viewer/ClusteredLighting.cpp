@@ -0,0 +1,393 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "common/JobSystem.h"
+#include "ClusteredPhongShader.h"
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+/* Four lights at once. Comparisons return lanes with all bits set, which are
+   then used for branch-free selection. Without SSE2 or NEON the same code
+   runs on plain arrays. */
+#if defined(__SSE2__)
+typedef __m128 Float4;
+
+inline Float4 load(const Float* data) { return _mm_loadu_ps(data); }
+inline Float4 splat(Float value) { return _mm_set1_ps(value); }
+inline Float4 add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 lessEqual(Float4 a, Float4 b) { return _mm_cmple_ps(a, b); }
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline Float4 truncate(Float4 a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+inline void storeInt(Int* data, Float4 a) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_cvttps_epi32(a));
+}
+inline void decompose(Float4 a, Float4& exponent, Float4& mantissa) {
+    const __m128i bits = _mm_castps_si128(a);
+    exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+typedef float32x4_t Float4;
+
+inline Float4 load(const Float* data) { return vld1q_f32(data); }
+inline Float4 splat(Float value) { return vdupq_n_f32(value); }
+inline Float4 add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 div(Float4 a, Float4 b) {
+    #ifdef __aarch64__
+    return vdivq_f32(a, b);
+    #else
+    /* No division on ARMv7, reciprocal estimate with two refinement steps */
+    Float4 reciprocal = vrecpeq_f32(b);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    reciprocal = vmulq_f32(vrecpsq_f32(b, reciprocal), reciprocal);
+    return vmulq_f32(a, reciprocal);
+    #endif
+}
+inline Float4 min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 lessEqual(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+    return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+}
+inline Float4 truncate(Float4 a) { return vcvtq_f32_s32(vcvtq_s32_f32(a)); }
+inline void storeInt(Int* data, Float4 a) { vst1q_s32(data, vcvtq_s32_f32(a)); }
+inline void decompose(Float4 a, Float4& exponent, Float4& mantissa) {
+    const uint32x4_t bits = vreinterpretq_u32_f32(a);
+    exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+    mantissa = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f800000)));
+}
+#else
+struct Float4 { Float data[4]; };
+
+template<class F> inline Float4 apply(Float4 a, Float4 b, F f) {
+    Float4 out;
+    for(std::size_t i = 0; i != 4; ++i) out.data[i] = f(a.data[i], b.data[i]);
+    return out;
+}
+
+inline Float4 load(const Float* data) { return {{data[0], data[1], data[2], data[3]}}; }
+inline Float4 splat(Float value) { return {{value, value, value, value}}; }
+inline Float4 add(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return x + y; }); }
+inline Float4 sub(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return x - y; }); }
+inline Float4 mul(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return x*y; }); }
+inline Float4 div(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return x/y; }); }
+inline Float4 min(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return y < x ? y : x; }); }
+inline Float4 max(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return y > x ? y : x; }); }
+inline Float4 lessEqual(Float4 a, Float4 b) { return apply(a, b, [](Float x, Float y) { return x <= y ? 1.0f : 0.0f; }); }
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+    Float4 out;
+    for(std::size_t i = 0; i != 4; ++i) out.data[i] = mask.data[i] != 0.0f ? a.data[i] : b.data[i];
+    return out;
+}
+inline Float4 truncate(Float4 a) { return apply(a, a, [](Float x, Float) { return Float(Int(x)); }); }
+inline void storeInt(Int* data, Float4 a) {
+    for(std::size_t i = 0; i != 4; ++i) data[i] = Int(a.data[i]);
+}
+inline void decompose(Float4 a, Float4& exponent, Float4& mantissa) {
+    for(std::size_t i = 0; i != 4; ++i) {
+        int e;
+        mantissa.data[i] = std::frexp(a.data[i], &e)*2.0f;
+        exponent.data[i] = e - 1;
+    }
+}
+#endif
+
+inline Float4 gather(const Float* table, const Int* indices) {
+    const Float values[] = {table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]]};
+    return load(values);
+}
+
+/* Base-2 logarithm of positive numbers with error below 0.001, cubic
+   polynomial approximates the logarithm of mantissa */
+inline Float4 log2(Float4 a) {
+    Float4 exponent, mantissa;
+    decompose(a, exponent, mantissa);
+    const Float4 t = sub(mantissa, splat(1.0f));
+    const Float4 polynomial = add(mul(add(mul(add(mul(splat(0.152700f), t), splat(-0.568704f)), t), splat(1.415653f)), t), splat(0.000825f));
+    return add(exponent, polynomial);
+}
+
+}
+
+ShaderDefines ClusteredLighting::shaderDefines() {
+    ShaderDefines defines;
+    defines.define("CLUSTER_COUNT_X", TileCountX)
+        ->define("CLUSTER_COUNT_Y", TileCountY)
+        ->define("SLICE_COUNT", SliceCount);
+    return defines;
+}
+
+ClusteredLighting::ClusteredLighting(): sliceIndices(SliceCount), clusters(ClusterCount*2), sliceScale(0.0f), sliceBias(0.0f), clusterOffset(0), indexOffset(0), lightOffset(0), time(0.0), maxLights(0) {}
+
+void ClusteredLighting::setLights(std::vector<PointLight> lights) {
+    this->lights = std::move(lights);
+
+    /* Bounds are computed for four lights at once, bounds of the padding
+       are ignored */
+    const std::size_t count = this->lights.size();
+    const std::size_t paddedCount = (count + 3)/4*4;
+    for(std::vector<Float>* array: {&lightX, &lightY, &lightZ, &lightRadius})
+        array->assign(paddedCount, 0.0f);
+    for(std::vector<Int>* array: {&sliceMin, &sliceMax, &tileMinX, &tileMaxX, &tileMinY, &tileMaxY})
+        array->resize(paddedCount);
+    lightData.resize(count*2);
+}
+
+void ClusteredLighting::update(const Matrix4& lightTransformation, const Matrix4& projectionMatrix, Float near, Float far) {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    /* Slice of depth z is log(z/near)/log(far/near)*SliceCount */
+    const Float scale = SliceCount/std::log(far/near);
+    const Float bias = -std::log(near)*scale;
+    sliceScale = scale;
+    sliceBias = bias;
+
+    /* Lights in camera space */
+    const std::size_t count = lights.size();
+    for(std::size_t i = 0; i != count; ++i) {
+        const Vector3 position = lightTransformation.transformPoint(lights[i].position);
+        lightX[i] = position.x();
+        lightY[i] = position.y();
+        lightZ[i] = position.z();
+        lightRadius[i] = lights[i].radius;
+        lightData[i*2] = Vector4(position, lights[i].radius);
+        lightData[i*2 + 1] = Vector4(lights[i].color, 0.0f);
+    }
+
+    /* Depth slice range. The slice is computed from approximate logarithm
+       and then corrected by comparing with the slice boundaries, which is
+       the same as using the precise logarithm. Lights outside of the frustum
+       depth range get empty range. */
+    Float boundaries[SliceCount + 1];
+    boundaries[0] = 0.0f;
+    for(std::size_t slice = 1; slice != SliceCount; ++slice)
+        boundaries[slice] = std::exp((slice - bias)/scale);
+    boundaries[SliceCount] = std::numeric_limits<Float>::infinity();
+
+    const Float4 nearPlane = splat(near), farPlane = splat(far);
+    const Float4 zero = splat(0.0f), one = splat(1.0f), minusOne = splat(-1.0f);
+    const Float4 log2Scale = splat(scale*std::log(2.0f)), sliceOffset = splat(bias);
+    const Float4 lastSlice = splat(SliceCount - 1);
+    auto findSlice = [&](Float4 depth) {
+        const Float4 approximate = truncate(min(max(add(mul(log2(depth), log2Scale), sliceOffset), zero), lastSlice));
+        Int index[4], nextIndex[4];
+        storeInt(index, approximate);
+        for(std::size_t j = 0; j != 4; ++j) nextIndex[j] = index[j] + 1;
+        return add(sub(approximate, select(lessEqual(gather(boundaries, index), depth), zero, one)),
+                   select(lessEqual(gather(boundaries, nextIndex), depth), one, zero));
+    };
+    for(std::size_t i = 0; i < count; i += 4) {
+        const Float4 z = load(lightZ.data() + i), radius = load(lightRadius.data() + i);
+        const Float4 depthMin = max(sub(sub(zero, z), radius), nearPlane);
+        const Float4 depthMax = min(add(sub(zero, z), radius), farPlane);
+
+        storeInt(sliceMin.data() + i, findSlice(depthMin));
+        storeInt(sliceMax.data() + i, select(lessEqual(depthMin, depthMax), findSlice(depthMax), minusOne));
+    }
+
+    /* Screen tile range from projected corners of the bounding box. The
+       projection is linear, so the corners are the projected center plus or
+       minus projected radius along each axis. If the box reaches behind the
+       near plane, the whole screen is covered. */
+    const Float4 countX = splat(TileCountX), countY = splat(TileCountY);
+    const Float4 lastX = splat(TileCountX - 1), lastY = splat(TileCountY - 1);
+    const Float4 half = splat(0.5f);
+    for(std::size_t i = 0; i < count; i += 4) {
+        const Float4 x = load(lightX.data() + i), y = load(lightY.data() + i), z = load(lightZ.data() + i);
+        const Float4 radius = load(lightRadius.data() + i);
+
+        /* Projected center and projected radius along each axis, only the
+           X, Y and W rows are needed */
+        auto row = [&](Int component, Float4& center, Float4& axisX, Float4& axisY, Float4& axisZ) {
+            axisX = mul(splat(projectionMatrix[0][component]), radius);
+            axisY = mul(splat(projectionMatrix[1][component]), radius);
+            axisZ = mul(splat(projectionMatrix[2][component]), radius);
+            center = add(add(mul(splat(projectionMatrix[0][component]), x),
+                             mul(splat(projectionMatrix[1][component]), y)),
+                         add(mul(splat(projectionMatrix[2][component]), z),
+                             splat(projectionMatrix[3][component])));
+        };
+        Float4 centerX, xAxisX, xAxisY, xAxisZ;
+        Float4 centerY, yAxisX, yAxisY, yAxisZ;
+        Float4 centerW, wAxisX, wAxisY, wAxisZ;
+        row(0, centerX, xAxisX, xAxisY, xAxisZ);
+        row(1, centerY, yAxisX, yAxisY, yAxisZ);
+        row(3, centerW, wAxisX, wAxisY, wAxisZ);
+
+        Float4 minX = one, minY = one, maxX = minusOne, maxY = minusOne;
+        for(Int corner = 0; corner != 8; ++corner) {
+            const Float4 signX = splat(corner & 1 ? 1.0f : -1.0f);
+            const Float4 signY = splat(corner & 2 ? 1.0f : -1.0f);
+            const Float4 signZ = splat(corner & 4 ? 1.0f : -1.0f);
+            const Float4 projectedX = add(add(centerX, mul(signX, xAxisX)), add(mul(signY, xAxisY), mul(signZ, xAxisZ)));
+            const Float4 projectedY = add(add(centerY, mul(signX, yAxisX)), add(mul(signY, yAxisY), mul(signZ, yAxisZ)));
+            const Float4 projectedW = add(add(centerW, mul(signX, wAxisX)), add(mul(signY, wAxisY), mul(signZ, wAxisZ)));
+
+            const Float4 inverseW = div(one, projectedW);
+            const Float4 ndcX = mul(projectedX, inverseW), ndcY = mul(projectedY, inverseW);
+            minX = min(minX, ndcX);
+            minY = min(minY, ndcY);
+            maxX = max(maxX, ndcX);
+            maxY = max(maxY, ndcY);
+        }
+
+        /* Tile coordinates are clamped before conversion to integers, so
+           values far outside of the screen don't overflow. Lights outside of
+           the screen get empty range. */
+        const Float4 behindNear = lessEqual(sub(sub(zero, z), radius), nearPlane);
+        auto tile = [&](Float4 ndc, Float4 tileCount, Float4 lower, Float4 upper, Float4 fallback) {
+            const Float4 position = min(max(mul(add(mul(ndc, half), half), tileCount), lower), upper);
+            return select(behindNear, fallback, position);
+        };
+        storeInt(tileMinX.data() + i, tile(minX, countX, zero, countX, zero));
+        storeInt(tileMaxX.data() + i, tile(maxX, countX, minusOne, lastX, lastX));
+        storeInt(tileMinY.data() + i, tile(minY, countY, zero, countY, zero));
+        storeInt(tileMaxY.data() + i, tile(maxY, countY, minusOne, lastY, lastY));
+    }
+
+    /* Fill each slice separately. Cluster light lists in a slice are
+       contiguous, cluster offsets are relative to the slice for now. */
+    auto fillSlices = [this, count](std::size_t first, std::size_t last) {
+        for(std::size_t slice = first; slice != last; ++slice) {
+            UnsignedInt* sliceClusters = clusters.data() + slice*TileCountX*TileCountY*2;
+            std::fill(sliceClusters, sliceClusters + TileCountX*TileCountY*2, 0);
+
+            /* Count lights in each cluster */
+            for(std::size_t i = 0; i != count; ++i) {
+                if(Int(slice) < sliceMin[i] || Int(slice) > sliceMax[i]) continue;
+                for(Int y = tileMinY[i]; y <= tileMaxY[i]; ++y)
+                    for(Int x = tileMinX[i]; x <= tileMaxX[i]; ++x)
+                        ++sliceClusters[(y*TileCountX + x)*2 + 1];
+            }
+
+            /* Offsets, the counts are then used as fill position */
+            UnsignedInt offset = 0;
+            for(std::size_t i = 0; i != TileCountX*TileCountY; ++i) {
+                sliceClusters[i*2] = offset;
+                offset += sliceClusters[i*2 + 1];
+                sliceClusters[i*2 + 1] = 0;
+            }
+
+            std::vector<UnsignedInt>& sliceList = sliceIndices[slice];
+            sliceList.resize(offset);
+            for(std::size_t i = 0; i != count; ++i) {
+                if(Int(slice) < sliceMin[i] || Int(slice) > sliceMax[i]) continue;
+                for(Int y = tileMinY[i]; y <= tileMaxY[i]; ++y) for(Int x = tileMinX[i]; x <= tileMaxX[i]; ++x) {
+                    UnsignedInt* cluster = sliceClusters + (y*TileCountX + x)*2;
+                    sliceList[cluster[0] + cluster[1]++] = i;
+                }
+            }
+        }
+    };
+    if(JobSystem* jobs = JobSystem::instance()) jobs->parallelFor(0, SliceCount, 1, fillSlices);
+    else fillSlices(0, SliceCount);
+
+    /* Merge the slice lists and make the offsets global */
+    indices.clear();
+    maxLights = 0;
+    for(std::size_t slice = 0; slice != SliceCount; ++slice) {
+        UnsignedInt* sliceClusters = clusters.data() + slice*TileCountX*TileCountY*2;
+        for(std::size_t i = 0; i != TileCountX*TileCountY; ++i) {
+            sliceClusters[i*2] += indices.size();
+            maxLights = std::max(maxLights, sliceClusters[i*2 + 1]);
+        }
+        indices.insert(indices.end(), sliceIndices[slice].begin(), sliceIndices[slice].end());
+    }
+
+    time = std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    upload();
+}
+
+void ClusteredLighting::upload() {
+    /* Each array is aligned to the largest texel size, so its offset can be
+       expressed in texels of its own format */
+    const GLsizeiptr clusterSize = clusters.size()*sizeof(UnsignedInt);
+    const GLsizeiptr indexSize = indices.size()*sizeof(UnsignedInt);
+    const GLsizeiptr lightSize = lightData.size()*sizeof(Vector4);
+    const GLsizeiptr size = (clusterSize + 15)/16*16 + (indexSize + 15)/16*16 + lightSize;
+
+    /* Enlarge the stream to next power of two, if needed, and point the
+       buffer textures to the new buffer */
+    if(!stream || stream->regionSize() < size) {
+        GLsizeiptr regionSize = stream ? stream->regionSize() : 65536;
+        while(regionSize < size) regionSize *= 2;
+        stream.reset(new StreamingBuffer(regionSize));
+        clusterTexture.setBuffer(BufferTexture::InternalFormat::RG32UI, &stream->buffer());
+        indexTexture.setBuffer(BufferTexture::InternalFormat::R32UI, &stream->buffer());
+        lightTexture.setBuffer(BufferTexture::InternalFormat::RGBA32F, &stream->buffer());
+    }
+
+    stream->beginFrame();
+    const StreamingBuffer::Allocation clusterAllocation = stream->allocate(clusterSize, 16);
+    const StreamingBuffer::Allocation indexAllocation = stream->allocate(indexSize, 16);
+    const StreamingBuffer::Allocation lightAllocation = stream->allocate(lightSize, 16);
+    std::copy(clusters.begin(), clusters.end(), static_cast<UnsignedInt*>(clusterAllocation.data));
+    std::copy(indices.begin(), indices.end(), static_cast<UnsignedInt*>(indexAllocation.data));
+    std::copy(lightData.begin(), lightData.end(), static_cast<Vector4*>(lightAllocation.data));
+    stream->commit();
+
+    clusterOffset = clusterAllocation.offset/(2*sizeof(UnsignedInt));
+    indexOffset = indexAllocation.offset/sizeof(UnsignedInt);
+    lightOffset = lightAllocation.offset/sizeof(Vector4);
+}
+
+void ClusteredLighting::endFrame() {
+    stream->endFrame();
+}
+
+void ClusteredLighting::bind(ClusteredPhongShader* shader, const Vector2i& viewport) {
+    clusterTexture.bind(ClusteredPhongShader::ClusterTextureLayer);
+    indexTexture.bind(ClusteredPhongShader::LightIndexTextureLayer);
+    lightTexture.bind(ClusteredPhongShader::LightTextureLayer);
+
+    shader->setClusterGrid(Vector2(viewport)/Vector2(TileCountX, TileCountY), sliceScale, sliceBias)
+        ->setDataOffsets(clusterOffset, indexOffset, lightOffset);
+}
+
+}}
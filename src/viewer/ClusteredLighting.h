@@ -0,0 +1,141 @@
+#ifndef Magnum_Examples_ClusteredLighting_h
+#define Magnum_Examples_ClusteredLighting_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include <Math/Matrix4.h>
+#include <BufferTexture.h>
+
+#include "common/ShaderVariants.h"
+#include "common/StreamingBuffer.h"
+#include "Lights.h"
+
+namespace Magnum { namespace Examples {
+
+class ClusteredPhongShader;
+
+/**
+@brief Clustered light assignment
+
+Divides the view frustum into @ref TileCountX times @ref TileCountY screen
+tiles and @ref SliceCount depth slices with exponential spacing. Each frame
+the lights are assigned to all clusters their bounding box overlaps and the
+per-cluster light lists are written into @ref StreamingBuffer, which is
+accessed through buffer textures by @ref ClusteredPhongShader.
+
+Light bounds are computed from separate arrays of light components, four
+lights at once with SSE2 or NEON and without branches. Depth slice is found
+from approximate logarithm corrected by a table of slice boundaries. Each
+depth slice is then filled in a separate @ref JobSystem job, so no
+synchronization is needed.
+*/
+class ClusteredLighting {
+    public:
+        enum: UnsignedInt {
+            TileCountX = 16,    /**< Cluster count in X */
+            TileCountY = 9,     /**< Cluster count in Y */
+            SliceCount = 24,    /**< Cluster count in depth */
+
+            /** Total cluster count */
+            ClusterCount = TileCountX*TileCountY*SliceCount
+        };
+
+        /**
+         * @brief Defines for @ref ClusteredPhongShader
+         *
+         * Cluster count in each dimension, so the shader uses the same
+         * values as the light assignment.
+         */
+        static ShaderDefines shaderDefines();
+
+        explicit ClusteredLighting();
+
+        /** @brief Light count */
+        inline std::size_t lightCount() const { return lights.size(); }
+
+        /** @brief Set lights */
+        void setLights(std::vector<PointLight> lights);
+
+        /**
+         * @brief Assign lights to clusters and upload the data
+         * @param lightTransformation   Transformation of the lights relative
+         *      to camera
+         * @param projectionMatrix      Camera projection matrix
+         * @param near                  Near clipping plane distance
+         * @param far                   Far clipping plane distance
+         */
+        void update(const Matrix4& lightTransformation, const Matrix4& projectionMatrix, Float near, Float far);
+
+        /**
+         * @brief Bind the data and set cluster grid for given shader
+         * @param shader        Shader
+         * @param viewport      Viewport size
+         */
+        void bind(ClusteredPhongShader* shader, const Vector2i& viewport);
+
+        /**
+         * @brief End the frame
+         *
+         * Call after all draws using the data from last update() are
+         * submitted.
+         */
+        void endFrame();
+
+        /** @brief CPU time of last update() in milliseconds */
+        inline Double assignmentTime() const { return time; }
+
+        /** @brief Total count of light indices in last update() */
+        inline std::size_t lightIndexCount() const { return indices.size(); }
+
+        /** @brief Max count of lights in one cluster in last update() */
+        inline UnsignedInt maxLightsPerCluster() const { return maxLights; }
+
+    private:
+        void upload();
+
+        std::vector<PointLight> lights;
+
+        /* View-space light bounds, separate arrays padded to multiple of
+           four for vectorization */
+        std::vector<Float> lightX, lightY, lightZ, lightRadius;
+        std::vector<Int> sliceMin, sliceMax, tileMinX, tileMaxX, tileMinY, tileMaxY;
+
+        /* Per-slice light lists, merged into one array after filling */
+        std::vector<std::vector<UnsignedInt>> sliceIndices;
+        std::vector<UnsignedInt> clusters, indices;
+        std::vector<Vector4> lightData;
+
+        std::unique_ptr<StreamingBuffer> stream;
+        BufferTexture clusterTexture, indexTexture, lightTexture;
+        Float sliceScale, sliceBias;
+        Int clusterOffset, indexOffset, lightOffset;
+        Double time;
+        UnsignedInt maxLights;
+};
+
+}}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ClusteredPhongShader.h"
+
+#include <Utility/Resource.h>
+#include <Shader.h>
+
+namespace Magnum { namespace Examples {
+
+ClusteredPhongShader::ClusteredPhongShader(const ShaderDefines& defines) {
+    Corrade::Utility::Resource rs("shaders");
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("ClusteredPhongShader.vert")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, defines.source() + rs.get("ClusteredPhongShader.frag")));
+
+    link();
+
+    transformationMatrixUniform = uniformLocation("transformationMatrix");
+    projectionMatrixUniform = uniformLocation("projectionMatrix");
+    ambientColorUniform = uniformLocation("ambientColor");
+    diffuseColorUniform = uniformLocation("diffuseColor");
+    specularColorUniform = uniformLocation("specularColor");
+    shininessUniform = uniformLocation("shininess");
+    tileSizeUniform = uniformLocation("tileSize");
+    sliceScaleUniform = uniformLocation("sliceScale");
+    sliceBiasUniform = uniformLocation("sliceBias");
+    clusterOffsetUniform = uniformLocation("clusterOffset");
+    lightIndexOffsetUniform = uniformLocation("lightIndexOffset");
+    lightOffsetUniform = uniformLocation("lightOffset");
+
+    setUniform(uniformLocation("clusterTextureData"), ClusterTextureLayer);
+    setUniform(uniformLocation("lightIndexTextureData"), LightIndexTextureLayer);
+    setUniform(uniformLocation("lightTextureData"), LightTextureLayer);
+}
+
+}}
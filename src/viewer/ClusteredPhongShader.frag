@@ -0,0 +1,82 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform vec3 ambientColor;
+uniform vec3 diffuseColor;
+uniform vec3 specularColor;
+uniform float shininess;
+
+/* CLUSTER_COUNT_X, CLUSTER_COUNT_Y and SLICE_COUNT are defined by
+   ClusteredLighting::shaderDefines() */
+const ivec3 clusterCount = ivec3(CLUSTER_COUNT_X, CLUSTER_COUNT_Y, SLICE_COUNT);
+uniform vec2 tileSize;
+uniform float sliceScale;
+uniform float sliceBias;
+
+/* The data are in a streaming buffer, starting at given offsets */
+uniform usamplerBuffer clusterTextureData;
+uniform usamplerBuffer lightIndexTextureData;
+uniform samplerBuffer lightTextureData;
+uniform int clusterOffset;
+uniform int lightIndexOffset;
+uniform int lightOffset;
+
+in vec3 transformedPosition;
+in vec3 transformedNormal;
+
+out vec4 color;
+
+void main() {
+    /* Cluster of this fragment, the same computation as in ClusteredLighting */
+    ivec2 tile = min(ivec2(gl_FragCoord.xy/tileSize), clusterCount.xy - 1);
+    int slice = clamp(int(log(-transformedPosition.z)*sliceScale + sliceBias), 0, clusterCount.z - 1);
+    uvec2 lights = texelFetch(clusterTextureData, clusterOffset + (slice*clusterCount.y + tile.y)*clusterCount.x + tile.x).rg;
+
+    vec3 normalizedNormal = normalize(transformedNormal);
+    vec3 viewDirection = normalize(-transformedPosition);
+
+    color = vec4(ambientColor, 1.0);
+    for(uint i = 0u; i != lights.y; ++i) {
+        int light = int(texelFetch(lightIndexTextureData, lightIndexOffset + int(lights.x + i)).r);
+        vec4 lightPositionRadius = texelFetch(lightTextureData, lightOffset + light*2);
+        vec3 lightColor = texelFetch(lightTextureData, lightOffset + light*2 + 1).rgb;
+
+        vec3 lightDirection = lightPositionRadius.xyz - transformedPosition;
+        float distance = length(lightDirection);
+        if(distance >= lightPositionRadius.w) continue;
+        lightDirection /= distance;
+
+        /* Same falloff as in deferred path */
+        float attenuation = 1.0 - distance*distance/(lightPositionRadius.w*lightPositionRadius.w);
+        attenuation *= attenuation;
+
+        float intensity = max(dot(normalizedNormal, lightDirection), 0.0);
+        color.rgb += diffuseColor*lightColor*intensity*attenuation;
+        if(intensity > 0.0) {
+            vec3 reflection = reflect(-lightDirection, normalizedNormal);
+            float specular = pow(max(dot(viewDirection, reflection), 0.0), shininess);
+            color.rgb += specularColor*lightColor*specular*attenuation;
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef Magnum_Examples_ClusteredPhongShader_h
+#define Magnum_Examples_ClusteredPhongShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+#include <Color.h>
+
+#include "common/ShaderVariants.h"
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Clustered Phong shader
+
+Phong shader looping only over lights in the cluster of given fragment. The
+light data and cluster light lists are set up by @ref ClusteredLighting.
+Cluster count is compiled into the shader from
+@ref ClusteredLighting::shaderDefines(), so the shader should be created
+through @ref ShaderVariants.
+*/
+class ClusteredPhongShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector3> Position; /**< @brief Vertex position */
+        typedef Attribute<1, Vector3> Normal;   /**< @brief Normal direction */
+
+        enum: Int {
+            /** Offset and count of lights in each cluster, RG32UI */
+            ClusterTextureLayer = 0,
+
+            /** Light indices of all clusters, R32UI */
+            LightIndexTextureLayer = 1,
+
+            /**
+             * Light data, two RGBA32F texels per light: view-space position
+             * with radius and color
+             */
+            LightTextureLayer = 2
+        };
+
+        /**
+         * @brief Constructor
+         * @param defines   Defines from @ref ClusteredLighting::shaderDefines()
+         */
+        explicit ClusteredPhongShader(const ShaderDefines& defines);
+
+        /** @brief Set transformation matrix */
+        inline ClusteredPhongShader* setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set projection matrix */
+        inline ClusteredPhongShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set ambient color */
+        inline ClusteredPhongShader* setAmbientColor(const Color3<>& color) {
+            setUniform(ambientColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set diffuse color */
+        inline ClusteredPhongShader* setDiffuseColor(const Color3<>& color) {
+            setUniform(diffuseColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set specular color */
+        inline ClusteredPhongShader* setSpecularColor(const Color3<>& color) {
+            setUniform(specularColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set shininess */
+        inline ClusteredPhongShader* setShininess(Float shininess) {
+            setUniform(shininessUniform, shininess);
+            return this;
+        }
+
+        /**
+         * @brief Set cluster grid
+         * @param tileSize      Size of cluster in pixels
+         * @param sliceScale    Scale of depth slice computation
+         * @param sliceBias     Bias of depth slice computation
+         *
+         * Depth slice of view-space depth `z` is `log(z)*sliceScale + sliceBias`.
+         */
+        inline ClusteredPhongShader* setClusterGrid(const Vector2& tileSize, Float sliceScale, Float sliceBias) {
+            setUniform(tileSizeUniform, tileSize);
+            setUniform(sliceScaleUniform, sliceScale);
+            setUniform(sliceBiasUniform, sliceBias);
+            return this;
+        }
+
+        /**
+         * @brief Set offsets of the data in the buffer textures
+         * @param clusterOffset     Offset of the first cluster in
+         *      @ref ClusterTextureLayer
+         * @param lightIndexOffset  Offset of the first light index in
+         *      @ref LightIndexTextureLayer
+         * @param lightOffset       Offset of the first light in
+         *      @ref LightTextureLayer
+         *
+         * All offsets are in texels.
+         */
+        inline ClusteredPhongShader* setDataOffsets(Int clusterOffset, Int lightIndexOffset, Int lightOffset) {
+            setUniform(clusterOffsetUniform, clusterOffset);
+            setUniform(lightIndexOffsetUniform, lightIndexOffset);
+            setUniform(lightOffsetUniform, lightOffset);
+            return this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            ambientColorUniform,
+            diffuseColorUniform,
+            specularColorUniform,
+            shininessUniform,
+            tileSizeUniform,
+            sliceScaleUniform,
+            sliceBiasUniform,
+            clusterOffsetUniform,
+            lightIndexOffsetUniform,
+            lightOffsetUniform;
+};
+
+}}
+
+#endif
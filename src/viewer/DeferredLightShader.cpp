@@ -0,0 +1,53 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "DeferredLightShader.h"
+
+#include <Utility/Resource.h>
+#include <Shader.h>
+
+namespace Magnum { namespace Examples {
+
+DeferredLightShader::DeferredLightShader() {
+    Corrade::Utility::Resource rs("shaders");
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("DeferredLightShader.vert")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("DeferredLightShader.frag")));
+
+    link();
+
+    projectionMatrixUniform = uniformLocation("projectionMatrix");
+    inverseProjectionMatrixUniform = uniformLocation("inverseProjectionMatrix");
+    viewportSizeUniform = uniformLocation("viewportSize");
+    volumeVertexCountUniform = uniformLocation("volumeVertexCount");
+    lightOffsetUniform = uniformLocation("lightOffset");
+    shininessUniform = uniformLocation("shininess");
+
+    setUniform(uniformLocation("albedoSpecularTextureData"), AlbedoSpecularTextureLayer);
+    setUniform(uniformLocation("normalTextureData"), NormalTextureLayer);
+    setUniform(uniformLocation("depthTextureData"), DepthTextureLayer);
+    setUniform(uniformLocation("lightTextureData"), LightTextureLayer);
+    setUniform(uniformLocation("volumeTextureData"), VolumeTextureLayer);
+}
+
+}}
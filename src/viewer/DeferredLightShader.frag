@@ -0,0 +1,74 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform mat4 inverseProjectionMatrix;
+uniform vec2 viewportSize;
+uniform float shininess;
+uniform sampler2D albedoSpecularTextureData;
+uniform sampler2D normalTextureData;
+uniform sampler2D depthTextureData;
+
+flat in vec4 lightPositionRadius;
+flat in vec3 lightColor;
+
+out vec4 color;
+
+vec3 decodeNormal(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if(n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx))*vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    /* Nothing drawn here */
+    float depth = texelFetch(depthTextureData, pixel, 0).r;
+    if(depth == 1.0) discard;
+
+    /* View-space position from depth */
+    vec4 position = inverseProjectionMatrix*vec4(vec3(gl_FragCoord.xy/viewportSize, depth)*2.0 - 1.0, 1.0);
+    position.xyz /= position.w;
+
+    /* Outside of light radius */
+    vec3 lightDirection = lightPositionRadius.xyz - position.xyz;
+    float distance = length(lightDirection);
+    if(distance >= lightPositionRadius.w) discard;
+    lightDirection /= distance;
+
+    float attenuation = 1.0 - distance*distance/(lightPositionRadius.w*lightPositionRadius.w);
+    attenuation *= attenuation;
+
+    vec4 albedoSpecular = texelFetch(albedoSpecularTextureData, pixel, 0);
+    vec3 normal = decodeNormal(texelFetch(normalTextureData, pixel, 0).rg);
+
+    float intensity = max(dot(normal, lightDirection), 0.0);
+    color = vec4(albedoSpecular.rgb*lightColor*intensity*attenuation, 1.0);
+    if(intensity > 0.0) {
+        vec3 reflection = reflect(-lightDirection, normal);
+        float specular = pow(max(dot(normalize(-position.xyz), reflection), 0.0), shininess);
+        color.rgb += lightColor*albedoSpecular.a*specular*attenuation;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef Magnum_Examples_DeferredLightShader_h
+#define Magnum_Examples_DeferredLightShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Deferred light shader
+
+Draws light volumes of all lights in one draw call. Volume vertices and light
+data are fetched from buffer textures based on `gl_VertexID`, so there are no
+vertex attributes and the mesh needs only vertex count set to light count
+times volume vertex count. Position is reconstructed from depth.
+*/
+class DeferredLightShader: public AbstractShaderProgram {
+    public:
+        enum: Int {
+            AlbedoSpecularTextureLayer = 0, /**< Albedo and specular intensity */
+            NormalTextureLayer = 1,         /**< Octahedral-encoded normals */
+            DepthTextureLayer = 2,          /**< Depth */
+
+            /**
+             * Light data, two RGBA32F texels per light: view-space position
+             * with radius and color
+             */
+            LightTextureLayer = 3,
+
+            /** Light volume, one RGBA32F texel per non-indexed vertex */
+            VolumeTextureLayer = 4
+        };
+
+        DeferredLightShader();
+
+        /** @brief Set projection matrix */
+        inline DeferredLightShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            setUniform(inverseProjectionMatrixUniform, matrix.inverted());
+            return this;
+        }
+
+        /** @brief Set viewport size */
+        inline DeferredLightShader* setViewportSize(const Vector2& size) {
+            setUniform(viewportSizeUniform, size);
+            return this;
+        }
+
+        /** @brief Set count of vertices of light volume */
+        inline DeferredLightShader* setVolumeVertexCount(Int count) {
+            setUniform(volumeVertexCountUniform, count);
+            return this;
+        }
+
+        /** @brief Set offset of the first light in @ref LightTextureLayer in texels */
+        inline DeferredLightShader* setLightOffset(Int offset) {
+            setUniform(lightOffsetUniform, offset);
+            return this;
+        }
+
+        /** @brief Set specular exponent used for all materials */
+        inline DeferredLightShader* setShininess(Float shininess) {
+            setUniform(shininessUniform, shininess);
+            return this;
+        }
+
+    private:
+        Int projectionMatrixUniform,
+            inverseProjectionMatrixUniform,
+            viewportSizeUniform,
+            volumeVertexCountUniform,
+            lightOffsetUniform,
+            shininessUniform;
+};
+
+}}
+
+#endif
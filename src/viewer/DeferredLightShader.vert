@@ -0,0 +1,41 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform mat4 projectionMatrix;
+uniform int volumeVertexCount;
+uniform samplerBuffer lightTextureData;
+uniform int lightOffset;
+uniform samplerBuffer volumeTextureData;
+
+flat out vec4 lightPositionRadius;
+flat out vec3 lightColor;
+
+void main() {
+    int light = gl_VertexID/volumeVertexCount;
+    lightPositionRadius = texelFetch(lightTextureData, lightOffset + light*2);
+    lightColor = texelFetch(lightTextureData, lightOffset + light*2 + 1).rgb;
+
+    vec3 vertex = texelFetch(volumeTextureData, gl_VertexID%volumeVertexCount).xyz;
+    gl_Position = projectionMatrix*vec4(lightPositionRadius.xyz + vertex*lightPositionRadius.w, 1.0);
+}
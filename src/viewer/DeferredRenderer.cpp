@@ -0,0 +1,176 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "DeferredRenderer.h"
+
+#include <algorithm>
+#include <DefaultFramebuffer.h>
+#include <Renderer.h>
+#include <Primitives/Icosphere.h>
+#include <Trade/MeshData3D.h>
+
+#include "DrawListCamera.h"
+#include "ViewedObject.h"
+
+namespace Magnum { namespace Examples {
+
+DeferredRenderer::DeferredRenderer(const Vector2i& size): geometryFramebuffer({{}, size}), lightFramebuffer({{}, size}), specularExponent(80.0f) {
+    /* Light volume, non-indexed for fetching with gl_VertexID. Icosphere
+       vertices are on unit sphere, scale it so the faces enclose it. */
+    Primitives::Icosphere<1> icosphere;
+    const std::vector<UnsignedInt>& indices = *icosphere.indices();
+    const std::vector<Vector3>& positions = *icosphere.positions(0);
+    std::vector<Vector4> volume;
+    volume.reserve(indices.size());
+    for(UnsignedInt index: indices) volume.push_back(Vector4(positions[index]*1.2f, 1.0f));
+    volumeVertexCount = volume.size();
+    volumeBuffer.setData(volume, Buffer::Usage::StaticDraw);
+    volumeTexture.setBuffer(BufferTexture::InternalFormat::RGBA32F, &volumeBuffer);
+    volumeMesh.setPrimitive(Mesh::Primitive::Triangles);
+    setLights({});
+
+    geometryFramebuffer.mapForDraw({{GBufferShader::AlbedoSpecularOutput, Framebuffer::ColorAttachment(0)},
+                                    {GBufferShader::NormalOutput, Framebuffer::ColorAttachment(1)},
+                                    {GBufferShader::LightOutput, Framebuffer::ColorAttachment(2)}});
+    createTextures();
+}
+
+void DeferredRenderer::setLights(std::vector<PointLight> lights) {
+    this->lights = std::move(lights);
+    volumeMesh.setVertexCount(this->lights.size()*volumeVertexCount);
+
+    /* Light data of one frame, two RGBA32F texels per light */
+    lightStream.reset(new StreamingBuffer(std::max(this->lights.size(), std::size_t(1))*2*sizeof(Vector4)));
+    lightDataTexture.setBuffer(BufferTexture::InternalFormat::RGBA32F, &lightStream->buffer());
+}
+
+void DeferredRenderer::setViewport(const Vector2i& size) {
+    if(geometryFramebuffer.viewport().size() == size) return;
+
+    geometryFramebuffer.setViewport({{}, size});
+    lightFramebuffer.setViewport({{}, size});
+    createTextures();
+}
+
+void DeferredRenderer::createTextures() {
+    const Vector2i size = geometryFramebuffer.viewport().size();
+
+    /* Immutable storage can't be resized, create new textures */
+    albedoSpecularTexture.reset(new Texture2D);
+    normalTexture.reset(new Texture2D);
+    depthTexture.reset(new Texture2D);
+    lightTexture.reset(new Texture2D);
+    for(Texture2D* texture: {albedoSpecularTexture.get(), normalTexture.get(), depthTexture.get(), lightTexture.get()}) {
+        texture->setMinificationFilter(Texture2D::Filter::Nearest)
+            ->setMagnificationFilter(Texture2D::Filter::Nearest)
+            ->setWrapping(Texture2D::Wrapping::ClampToEdge);
+    }
+    albedoSpecularTexture->setStorage(1, Texture2D::InternalFormat::RGBA8, size);
+    normalTexture->setStorage(1, Texture2D::InternalFormat::RG16F, size);
+    depthTexture->setStorage(1, Texture2D::InternalFormat::DepthComponent24, size);
+    lightTexture->setStorage(1, Texture2D::InternalFormat::RGBA8, size);
+
+    geometryFramebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), albedoSpecularTexture.get(), 0);
+    geometryFramebuffer.attachTexture2D(Framebuffer::ColorAttachment(1), normalTexture.get(), 0);
+    geometryFramebuffer.attachTexture2D(Framebuffer::ColorAttachment(2), lightTexture.get(), 0);
+    geometryFramebuffer.attachTexture2D(Framebuffer::BufferAttachment::Depth, depthTexture.get(), 0);
+    lightFramebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), lightTexture.get(), 0);
+}
+
+void DeferredRenderer::draw(DrawListCamera* camera, const Matrix4& lightTransformation) {
+    /* G-buffer pass. The clear color is zero, so the light target starts
+       black and the normals invalid, which doesn't matter as pixels without
+       depth are skipped. */
+    geometryQuery.begin(Query::Target::TimeElapsed);
+    geometryFramebuffer.clear(AbstractFramebuffer::Clear::Color|AbstractFramebuffer::Clear::Depth);
+    geometryFramebuffer.bind(AbstractFramebuffer::Target::Draw);
+    geometryShader.setProjectionMatrix(camera->projectionMatrix());
+    for(const DrawCommand& command: camera->drawList())
+        command.object->drawGBuffer(&geometryShader, command.transformationMatrix);
+    geometryQuery.end();
+
+    /* Light positions in camera space, written sequentially directly into
+       the streaming buffer */
+    lightStream->beginFrame();
+    const StreamingBuffer::Allocation allocation = lightStream->allocate(lights.size()*2*sizeof(Vector4), sizeof(Vector4));
+    Vector4* lightData = static_cast<Vector4*>(allocation.data);
+    for(const PointLight& light: lights) {
+        *lightData++ = Vector4(lightTransformation.transformPoint(light.position), light.radius);
+        *lightData++ = Vector4(light.color, 0.0f);
+    }
+    lightStream->commit();
+
+    /* Lighting pass. Back faces of the volumes are drawn, so the light is
+       applied also if the camera is inside the volume. Depth test is off,
+       the shader compares the depth itself. */
+    lightingQuery.begin(Query::Target::TimeElapsed);
+    sampleQuery.begin(SampleQuery::Target::SamplesPassed);
+    lightFramebuffer.bind(AbstractFramebuffer::Target::Draw);
+    Renderer::setFeature(Renderer::Feature::DepthTest, false);
+    Renderer::setFeature(Renderer::Feature::Blending, true);
+    Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::One);
+    Renderer::setFaceCullingMode(Renderer::PolygonFacing::Front);
+
+    albedoSpecularTexture->bind(DeferredLightShader::AlbedoSpecularTextureLayer);
+    normalTexture->bind(DeferredLightShader::NormalTextureLayer);
+    depthTexture->bind(DeferredLightShader::DepthTextureLayer);
+    lightDataTexture.bind(DeferredLightShader::LightTextureLayer);
+    volumeTexture.bind(DeferredLightShader::VolumeTextureLayer);
+    lightShader.setProjectionMatrix(camera->projectionMatrix())
+        ->setViewportSize(Vector2(geometryFramebuffer.viewport().size()))
+        ->setVolumeVertexCount(volumeVertexCount)
+        ->setShininess(specularExponent)
+        ->setLightOffset(allocation.offset/sizeof(Vector4))
+        ->use();
+    if(!lights.empty()) volumeMesh.draw();
+    lightStream->endFrame();
+
+    Renderer::setFaceCullingMode(Renderer::PolygonFacing::Back);
+    Renderer::setFeature(Renderer::Feature::Blending, false);
+    Renderer::setFeature(Renderer::Feature::DepthTest, true);
+    sampleQuery.end();
+    lightingQuery.end();
+
+    /* Copy the result to the screen */
+    lightFramebuffer.mapForRead(Framebuffer::ColorAttachment(0));
+    AbstractFramebuffer::blit(lightFramebuffer, defaultFramebuffer,
+        lightFramebuffer.viewport(), defaultFramebuffer.viewport(),
+        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Linear);
+    defaultFramebuffer.bind(AbstractFramebuffer::Target::Draw);
+}
+
+DeferredRenderer::Timing DeferredRenderer::timing() {
+    Timing timing;
+    timing.geometryTime = geometryQuery.result<UnsignedLong>()/1.0e6;
+    timing.lightingTime = lightingQuery.result<UnsignedLong>()/1.0e6;
+    timing.lightSamples = sampleQuery.result<UnsignedInt>();
+
+    /* Albedo, normal, depth and light written once, albedo, normal and
+       depth read and light blended for each light sample */
+    const UnsignedLong pixels = geometryFramebuffer.viewport().size().product();
+    timing.bandwidth = pixels*16 + timing.lightSamples*(12 + 8);
+    return timing;
+}
+
+}}
@@ -0,0 +1,143 @@
+#ifndef Magnum_Examples_DeferredRenderer_h
+#define Magnum_Examples_DeferredRenderer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include <Buffer.h>
+#include <BufferTexture.h>
+#include <Framebuffer.h>
+#include <Mesh.h>
+#include <Query.h>
+#include <Texture.h>
+
+#include "common/StreamingBuffer.h"
+#include "DeferredLightShader.h"
+#include "GBufferShader.h"
+#include "Lights.h"
+
+namespace Magnum { namespace Examples {
+
+class DrawListCamera;
+
+/**
+@brief Deferred renderer
+
+Draws the camera draw list into compact G-buffer and then accumulates light
+from light volumes into the light target, which is copied to the default
+framebuffer at the end. The G-buffer has 12 bytes per pixel:
+
+-   RGBA8 albedo and specular intensity (specular exponent is the same for
+    all materials, see setShininess())
+-   RG16F view-space normal in octahedral encoding
+-   24-bit depth, from which the view-space position is reconstructed
+
+plus RGBA8 light accumulation target, which is initialized to ambient color
+in the G-buffer pass.
+*/
+class DeferredRenderer {
+    public:
+        /** @brief Timing of last frame */
+        struct Timing {
+            Double geometryTime;    /**< @brief G-buffer pass GPU time in milliseconds */
+            Double lightingTime;    /**< @brief Lighting pass GPU time in milliseconds */
+            UnsignedLong lightSamples;  /**< @brief Samples shaded in lighting pass */
+
+            /**
+             * @brief Estimated G-buffer traffic in bytes
+             *
+             * Written once per pixel, read and light target blended once
+             * per shaded light sample.
+             */
+            UnsignedLong bandwidth;
+        };
+
+        /**
+         * @brief Constructor
+         * @param size      Viewport size
+         */
+        explicit DeferredRenderer(const Vector2i& size);
+
+        /** @brief Specular exponent used for all materials */
+        inline Float shininess() const { return specularExponent; }
+
+        /**
+         * @brief Set specular exponent used for all materials
+         *
+         * Default is `80`.
+         */
+        inline DeferredRenderer* setShininess(Float shininess) {
+            specularExponent = shininess;
+            return this;
+        }
+
+        /** @brief Light count */
+        inline std::size_t lightCount() const { return lights.size(); }
+
+        /** @brief Set lights */
+        void setLights(std::vector<PointLight> lights);
+
+        /** @brief Set viewport size */
+        void setViewport(const Vector2i& size);
+
+        /**
+         * @brief Draw current camera draw list
+         * @param camera            Camera with draw list built with
+         *      DrawListCamera::buildDrawList()
+         * @param lightTransformation   Transformation of the lights relative
+         *      to camera
+         */
+        void draw(DrawListCamera* camera, const Matrix4& lightTransformation);
+
+        /**
+         * @brief Timing of last draw() call
+         *
+         * Waits for the query results, thus stalls the pipeline.
+         */
+        Timing timing();
+
+    private:
+        void createTextures();
+
+        Framebuffer geometryFramebuffer, lightFramebuffer;
+        std::unique_ptr<Texture2D> albedoSpecularTexture, normalTexture, depthTexture, lightTexture;
+        GBufferShader geometryShader;
+        DeferredLightShader lightShader;
+
+        std::vector<PointLight> lights;
+        std::unique_ptr<StreamingBuffer> lightStream;
+        Buffer volumeBuffer;
+        BufferTexture lightDataTexture, volumeTexture;
+        Mesh volumeMesh;
+        UnsignedInt volumeVertexCount;
+        Float specularExponent;
+
+        Query geometryQuery, lightingQuery;
+        SampleQuery sampleQuery;
+};
+
+}}
+
+#endif
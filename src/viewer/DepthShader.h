@@ -0,0 +1,64 @@
+#ifndef Magnum_Examples_DepthShader_h
+#define Magnum_Examples_DepthShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Depth-only shader
+
+Used for depth pre-pass. The vertex position is declared `invariant`, the
+same as in @ref ForwardPhongShader, so the depths match bit-for-bit and the
+main pass can use @ref Renderer::DepthFunction "DepthFunction::Equal".
+*/
+class DepthShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector3> Position; /**< @brief Vertex position */
+
+        DepthShader();
+
+        /** @brief Set transformation matrix */
+        inline DepthShader* setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set projection matrix */
+        inline DepthShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform;
+};
+
+}}
+
+#endif
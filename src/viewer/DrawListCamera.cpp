@@ -0,0 +1,236 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "DrawListCamera.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <Renderer.h>
+
+#include "common/JobSystem.h"
+#ifndef MAGNUM_TARGET_GLES
+#include "DepthShader.h"
+#endif
+#include "SceneStreamer.h"
+#include "ViewedObject.h"
+
+namespace Magnum { namespace Examples {
+
+namespace {
+    /* Smallest count of drawables worth sending to another thread */
+    constexpr std::size_t MinimalChunkSize = 256;
+
+    bool compareSortKeys(const DrawCommand& a, const DrawCommand& b) {
+        return a.sortKey < b.sortKey;
+    }
+}
+
+DrawListCamera::DrawListCamera(SceneGraph::AbstractObject3D<>* object): Camera3D(object), culled(0), uploadBudget(16*1024*1024), pendingUploads(0), uploaded(0), streamer(nullptr), prepass(DepthPrepass::Off), prepassActive(false), queryPending(false), enableThreshold(1.5f), disableThreshold(1.2f), samples(0.0f) {}
+
+DrawListCamera::~DrawListCamera() = default;
+
+DrawListCamera* DrawListCamera::setDepthPrepass(DepthPrepass mode) {
+    #ifndef MAGNUM_TARGET_GLES
+    prepass = mode;
+    prepassActive = mode == DepthPrepass::On;
+
+    /* Created lazily, most of the time the pre-pass isn't needed */
+    if(mode != DepthPrepass::Off && !depthShader) depthShader.reset(new DepthShader);
+    if(mode == DepthPrepass::Automatic && !sampleQuery) sampleQuery.reset(new SampleQuery);
+    #else
+    static_cast<void>(mode);
+    #endif
+    return this;
+}
+
+void DrawListCamera::buildDrawList(SceneGraph::DrawableGroup3D<>& group) {
+    /* Frustum planes in camera space, extracted from projection matrix rows
+       (Gribb & Hartmann). Plane normals point inside. */
+    const Matrix4& projection = projectionMatrix();
+    const Vector4 rows[] = {projection.row(0), projection.row(1), projection.row(2), projection.row(3)};
+    for(std::size_t i = 0; i != 3; ++i) {
+        frustumPlanes[i*2 + 0] = rows[3] + rows[i];
+        frustumPlanes[i*2 + 1] = rows[3] - rows[i];
+    }
+    for(Vector4& plane: frustumPlanes)
+        plane /= plane.xyz().length();
+
+    /* The camera matrix is computed lazily, make sure it is done on this
+       thread before the workers use it */
+    camera = cameraMatrix();
+
+    /* Split the group into chunks, each chunk has at least a few hundred
+       drawables so it's worth the scheduling overhead */
+    JobSystem* jobs = JobSystem::instance();
+    const std::size_t maxChunkCount = jobs ? jobs->workerCount() + 1 : 1;
+    const std::size_t chunkCount = std::max(std::size_t(1), std::min(maxChunkCount, group.size()/MinimalChunkSize));
+    const std::size_t chunkSize = (group.size() + chunkCount - 1)/chunkCount;
+    chunkCommands.resize(chunkCount);
+
+    auto processChunks = [&](std::size_t first, std::size_t last) {
+        for(std::size_t i = first; i != last; ++i)
+            processChunk(group, std::min(i*chunkSize, group.size()), std::min((i + 1)*chunkSize, group.size()), chunkCommands[i]);
+    };
+    if(jobs) jobs->parallelFor(0, chunkCount, 1, processChunks);
+    else processChunks(0, chunkCount);
+
+    /* Merge the sorted per-chunk lists */
+    commands.clear();
+    for(const std::vector<DrawCommand>& list: chunkCommands) {
+        const std::size_t middle = commands.size();
+        commands.insert(commands.end(), list.begin(), list.end());
+        std::inplace_merge(commands.begin(), commands.begin() + middle, commands.end(), compareSortKeys);
+    }
+
+    culled = group.size() - commands.size();
+
+    /* Upload meshes visible for the first time, the ones over the budget are
+       not drawn in this frame */
+    std::size_t budget = uploadBudget;
+    bool first = true;
+    pendingUploads = 0;
+    commands.erase(std::remove_if(commands.begin(), commands.end(), [&](const DrawCommand& command) {
+        ViewerMesh* mesh = command.object->viewerMesh();
+        if(mesh->isUploaded()) return false;
+
+        if(first || budget) {
+            const std::size_t size = streamer ? streamer->upload(mesh) : mesh->upload();
+            uploaded += size;
+            budget -= std::min(budget, size);
+            first = false;
+            return false;
+        }
+
+        ++pendingUploads;
+        return true;
+    }), commands.end());
+}
+
+void DrawListCamera::processChunk(SceneGraph::DrawableGroup3D<>& group, std::size_t begin, std::size_t end, std::vector<DrawCommand>& out) const {
+    out.clear();
+
+    for(std::size_t i = begin; i != end; ++i) {
+        ViewedObject* object = static_cast<ViewedObject*>(group[i]);
+        const ViewerMesh* mesh = object->viewerMesh();
+        const Matrix4 transformationMatrix = camera*object->absoluteTransformation();
+
+        /* Bounding sphere in camera space, the radius is scaled by the
+           largest axis scale */
+        const Vector3 center = transformationMatrix.transformPoint(mesh->center);
+        const Float scale = std::sqrt(std::max({
+            transformationMatrix.right().dot(),
+            transformationMatrix.up().dot(),
+            transformationMatrix.backward().dot()}));
+        const Float radius = mesh->radius*scale;
+
+        /* Frustum culling */
+        bool visible = true;
+        for(const Vector4& plane: frustumPlanes) if(Vector3::dot(plane.xyz(), center) + plane.w() < -radius) {
+            visible = false;
+            break;
+        }
+        if(!visible) continue;
+
+        /* Positive floats compare the same as their bit representation */
+        const Float depth = std::max(0.0f, -center.z());
+        UnsignedInt depthBits;
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+        out.push_back({(UnsignedLong(mesh->id) << 32)|depthBits, object, transformationMatrix});
+    }
+
+    std::sort(out.begin(), out.end(), compareSortKeys);
+}
+
+void DrawListCamera::executeDrawList() {
+    #ifndef MAGNUM_TARGET_GLES
+    if(prepass == DepthPrepass::Automatic) updateDepthPrepass();
+
+    /* Count samples of the pass writing depth, if the previous result was
+       already read */
+    const bool measure = prepass == DepthPrepass::Automatic && !queryPending;
+    if(measure) sampleQuery->begin(SampleQuery::Target::SamplesPassed);
+
+    if(prepassActive) {
+        drawDepth();
+        if(measure) {
+            sampleQuery->end();
+            queryPending = true;
+        }
+
+        /* Shade only fragments with the same depth as in the pre-pass */
+        Renderer::setDepthMask(false);
+        Renderer::setDepthFunction(Renderer::DepthFunction::Equal);
+        for(const DrawCommand& command: commands)
+            command.object->draw(command.transformationMatrix, this);
+        Renderer::setDepthFunction(Renderer::DepthFunction::Less);
+        Renderer::setDepthMask(true);
+        return;
+    }
+    #endif
+
+    for(const DrawCommand& command: commands)
+        command.object->draw(command.transformationMatrix, this);
+
+    #ifndef MAGNUM_TARGET_GLES
+    if(measure) {
+        sampleQuery->end();
+        queryPending = true;
+    }
+    #endif
+}
+
+#ifndef MAGNUM_TARGET_GLES
+void DrawListCamera::updateDepthPrepass() {
+    /* Don't stall waiting for the result, use it when it's ready */
+    if(!queryPending || !sampleQuery->resultAvailable()) return;
+
+    samples = Float(sampleQuery->result<UnsignedInt>())/viewport().product();
+    queryPending = false;
+
+    if(!prepassActive && samples > enableThreshold) prepassActive = true;
+    else if(prepassActive && samples < disableThreshold) prepassActive = false;
+}
+
+void DrawListCamera::drawDepth() {
+    Renderer::setColorMask(false, false, false, false);
+
+    depthShader->setProjectionMatrix(projectionMatrix());
+    for(const DrawCommand& command: commands) {
+        depthShader->setTransformationMatrix(command.transformationMatrix)
+            ->use();
+        command.object->viewerMesh()->drawPositions();
+    }
+
+    Renderer::setColorMask(true, true, true, true);
+}
+#endif
+
+void DrawListCamera::draw(SceneGraph::DrawableGroup3D<>& group) {
+    buildDrawList(group);
+    executeDrawList();
+}
+
+}}
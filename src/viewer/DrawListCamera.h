@@ -0,0 +1,209 @@
+#ifndef Magnum_Examples_DrawListCamera_h
+#define Magnum_Examples_DrawListCamera_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include <Query.h>
+#include <SceneGraph/Camera3D.h>
+
+#include "Types.h"
+
+namespace Magnum { namespace Examples {
+
+class DepthShader;
+class SceneStreamer;
+class ViewedObject;
+
+/** @brief Draw command */
+struct DrawCommand {
+    /**
+     * @brief Sort key
+     *
+     * Mesh ID in upper 32 bits, so the objects with the same mesh are drawn
+     * together, distance from the camera in lower 32 bits, so they are
+     * drawn front to back.
+     */
+    UnsignedLong sortKey;
+
+    ViewedObject* object;           /**< @brief Object to draw */
+    Matrix4 transformationMatrix;   /**< @brief Transformation relative to camera */
+};
+
+/**
+@brief Camera building draw list in parallel
+
+Camera-relative transformation computation, frustum culling and sort key
+generation is split into chunks of the drawable group, which are processed by
+@ref JobSystem workers into per-chunk draw lists. The lists are then merged
+and executed on the calling (GL) thread. If there is no @ref JobSystem
+instance, everything is done on the calling thread. All drawables in the group
+are expected to be @ref ViewedObject instances.
+
+The draw list can be preceded by depth-only pre-pass using position-only
+meshes, the main pass then shades only the visible fragments. In automatic
+mode the pre-pass is enabled when samples passing depth test per pixel exceed
+given threshold, see setDepthPrepassThresholds(). The samples are counted
+with a query, so the mode can't be used together with sample counter in
+@ref FpsCounterExample. Depth pre-pass is not available on OpenGL ES.
+
+Meshes which are not yet on the GPU are uploaded when they pass culling for
+the first time, limited by per-frame budget, see setUploadBudget(). With
+@ref SceneStreamer set, the meshes are uploaded from memory-mapped scene
+package, see setStreamer().
+*/
+class DrawListCamera: public SceneGraph::Camera3D<> {
+    public:
+        /** @brief Depth pre-pass mode */
+        enum class DepthPrepass {
+            Off,        /**< Never */
+            On,         /**< Always */
+            Automatic   /**< Based on measured samples per pixel */
+        };
+
+        explicit DrawListCamera(SceneGraph::AbstractObject3D<>* object);
+
+        ~DrawListCamera();
+
+        /** @brief Depth pre-pass mode */
+        inline DepthPrepass depthPrepass() const { return prepass; }
+
+        /**
+         * @brief Set depth pre-pass mode
+         *
+         * Default is @ref DepthPrepass "DepthPrepass::Off".
+         */
+        DrawListCamera* setDepthPrepass(DepthPrepass mode);
+
+        /**
+         * @brief Set thresholds for automatic depth pre-pass
+         * @param enable    Samples per pixel above which the pre-pass is
+         *      enabled
+         * @param disable   Samples per pixel below which the pre-pass is
+         *      disabled
+         *
+         * The gap between the values prevents switching back and forth.
+         * Default is `1.5` and `1.2`.
+         */
+        inline DrawListCamera* setDepthPrepassThresholds(Float enable, Float disable) {
+            enableThreshold = enable;
+            disableThreshold = disable;
+            return this;
+        }
+
+        /** @brief Whether depth pre-pass is currently done */
+        inline bool isDepthPrepassActive() const { return prepassActive; }
+
+        /**
+         * @brief Samples passing depth test per pixel
+         *
+         * Measured only in automatic depth pre-pass mode, with a delay of a
+         * few frames. Without pre-pass these are all shaded samples, with
+         * pre-pass these are the samples which would be shaded without it.
+         */
+        inline Float samplesPerPixel() const { return samples; }
+
+        /**
+         * @brief Set per-frame upload budget
+         *
+         * Visible meshes which are not yet uploaded are uploaded in
+         * buildDrawList() until given amount of bytes is exceeded, at least
+         * one mesh per frame. Visible meshes over the budget are not drawn
+         * until uploaded in some of the following frames, see
+         * pendingUploadCount(). Default is 16 MB.
+         */
+        inline DrawListCamera* setUploadBudget(std::size_t bytes) {
+            uploadBudget = bytes;
+            return this;
+        }
+
+        /**
+         * @brief Count of visible drawables waiting for upload
+         *
+         * Drawables skipped in last buildDrawList() call because their mesh
+         * was over the upload budget.
+         */
+        inline std::size_t pendingUploadCount() const { return pendingUploads; }
+
+        /**
+         * @brief Set scene streamer
+         *
+         * If set, meshes are uploaded with SceneStreamer::upload() instead of
+         * from their host data. Default is `nullptr`.
+         */
+        inline DrawListCamera* setStreamer(SceneStreamer* streamer) {
+            this->streamer = streamer;
+            return this;
+        }
+
+        /** @brief Total size of data uploaded in buildDrawList() */
+        inline std::size_t uploadedSize() const { return uploaded; }
+
+        /** @brief Draw list built in last buildDrawList() call */
+        inline const std::vector<DrawCommand>& drawList() const { return commands; }
+
+        /** @brief Count of drawables culled in last buildDrawList() call */
+        inline std::size_t culledCount() const { return culled; }
+
+        /** @brief Build sorted list of visible drawables */
+        void buildDrawList(SceneGraph::DrawableGroup3D<>& group);
+
+        /** @brief Draw everything in current draw list */
+        void executeDrawList();
+
+        /**
+         * @brief Draw
+         *
+         * Calls buildDrawList() and executeDrawList().
+         */
+        void draw(SceneGraph::DrawableGroup3D<>& group) override;
+
+    private:
+        #ifndef MAGNUM_TARGET_GLES
+        void updateDepthPrepass();
+        void drawDepth();
+        #endif
+
+        void processChunk(SceneGraph::DrawableGroup3D<>& group, std::size_t begin, std::size_t end, std::vector<DrawCommand>& out) const;
+
+        std::size_t culled, uploadBudget, pendingUploads, uploaded;
+        Matrix4 camera;
+        Vector4 frustumPlanes[6];
+        std::vector<std::vector<DrawCommand>> chunkCommands;
+        std::vector<DrawCommand> commands;
+        SceneStreamer* streamer;
+
+        DepthPrepass prepass;
+        bool prepassActive, queryPending;
+        Float enableThreshold, disableThreshold, samples;
+        #ifndef MAGNUM_TARGET_GLES
+        std::unique_ptr<DepthShader> depthShader;
+        std::unique_ptr<SampleQuery> sampleQuery;
+        #endif
+};
+
+}}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <DefaultFramebuffer.h>
+
+namespace Magnum { namespace Examples {
+
+DynamicResolution::DynamicResolution(const Vector2i& size): framebuffer({{}, size}), currentQuery(0), windowSize(size), target(16.6), lastFrameTime(0.0), minScale(0.5f), maxScale(1.0f), currentScale(1.0f), filteredScale(1.0f) {
+    createStorage();
+}
+
+DynamicResolution* DynamicResolution::setScaleRange(Float min, Float max) {
+    const bool resize = max != maxScale;
+    minScale = min;
+    maxScale = max;
+    currentScale = filteredScale = std::min(std::max(currentScale, minScale), maxScale);
+    if(resize) createStorage();
+    else applyScale();
+    return this;
+}
+
+void DynamicResolution::setViewport(const Vector2i& size) {
+    if(windowSize == size) return;
+
+    windowSize = size;
+    createStorage();
+}
+
+void DynamicResolution::createStorage() {
+    /* Renderbuffer storage is mutable, so it can be just set again */
+    const Vector2i size(Int(std::ceil(windowSize.x()*maxScale)), Int(std::ceil(windowSize.y()*maxScale)));
+    color.setStorage(Renderbuffer::InternalFormat::RGBA8, size);
+    depth.setStorage(Renderbuffer::InternalFormat::DepthComponent24, size);
+    framebuffer.attachRenderbuffer(Framebuffer::ColorAttachment(0), &color);
+    framebuffer.attachRenderbuffer(Framebuffer::BufferAttachment::Depth, &depth);
+    applyScale();
+}
+
+void DynamicResolution::applyScale() {
+    const Vector2i size(std::max(Int(windowSize.x()*currentScale), 1), std::max(Int(windowSize.y()*currentScale), 1));
+    framebuffer.setViewport({{}, size});
+}
+
+void DynamicResolution::begin() {
+    updateScale();
+
+    /* If the result of the oldest query still isn't available, this frame
+       is not measured rather than waiting for it */
+    FrameQuery& frame = queries[currentQuery];
+    if(!frame.pending) {
+        frame.query.begin(Query::Target::TimeElapsed);
+        frame.scale = currentScale;
+    }
+
+    framebuffer.clear(AbstractFramebuffer::Clear::Color|AbstractFramebuffer::Clear::Depth);
+    framebuffer.bind(AbstractFramebuffer::Target::Draw);
+}
+
+void DynamicResolution::end() {
+    framebuffer.mapForRead(Framebuffer::ColorAttachment(0));
+    AbstractFramebuffer::blit(framebuffer, defaultFramebuffer,
+        framebuffer.viewport(), defaultFramebuffer.viewport(),
+        AbstractFramebuffer::Blit::ColorBuffer, AbstractFramebuffer::BlitFilter::Linear);
+    defaultFramebuffer.bind(AbstractFramebuffer::Target::Draw);
+
+    FrameQuery& frame = queries[currentQuery];
+    if(!frame.pending) {
+        frame.query.end();
+        frame.pending = true;
+    }
+    currentQuery = (currentQuery + 1)%QueryCount;
+}
+
+void DynamicResolution::updateScale() {
+    /* Oldest first, so the newest available result is used in the end */
+    const FrameQuery* newest = nullptr;
+    for(std::size_t i = 0; i != QueryCount; ++i) {
+        FrameQuery& frame = queries[(currentQuery + i)%QueryCount];
+        if(!frame.pending || !frame.query.resultAvailable()) continue;
+
+        lastFrameTime = frame.query.result<UnsignedLong>()/1.0e6;
+        frame.pending = false;
+        newest = &frame;
+    }
+    if(!newest || lastFrameTime <= 0.0) return;
+
+    /* Cost is proportional to pixel count, i.e. square of the scale */
+    const Float desired = newest->scale*std::sqrt(target/lastFrameTime);
+    filteredScale = std::min(std::max(filteredScale*0.7f + desired*0.3f, minScale), maxScale);
+
+    /* Small changes are ignored, except for reaching the range bounds */
+    const bool atBound = filteredScale == minScale || filteredScale == maxScale;
+    if(filteredScale == currentScale || (std::abs(filteredScale - currentScale) <= 0.02f && !atBound))
+        return;
+
+    currentScale = filteredScale;
+    applyScale();
+}
+
+}}
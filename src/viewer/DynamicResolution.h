@@ -0,0 +1,136 @@
+#ifndef Magnum_Examples_DynamicResolution_h
+#define Magnum_Examples_DynamicResolution_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Framebuffer.h>
+#include <Query.h>
+#include <Renderbuffer.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Dynamic resolution
+
+Offscreen color and depth target for the scene, whose resolution is adjusted
+each frame to keep GPU frame time at given target. The rendered image is then
+upscaled to the default framebuffer with linear filtering.
+
+GPU time of each frame is measured with time elapsed query. The results are
+read a few frames later when they are available, so measuring doesn't stall
+the pipeline. Fill cost is assumed to be proportional to pixel count, so the
+scale is adjusted by square root of the ratio between target and measured
+time. The new scale is smoothed over a few frames and changed only if it
+differs by more than two percent, so it doesn't oscillate with noise in the
+measurement.
+
+The renderbuffers are allocated for the largest scale, so changing the scale
+only changes the framebuffer viewport and doesn't reallocate anything.
+*/
+class DynamicResolution {
+    public:
+        /**
+         * @brief Constructor
+         * @param size      Window size
+         */
+        explicit DynamicResolution(const Vector2i& size);
+
+        /** @brief Target GPU frame time in milliseconds */
+        inline Double targetFrameTime() const { return target; }
+
+        /**
+         * @brief Set target GPU frame time
+         *
+         * Default is `16.6` ms.
+         */
+        inline DynamicResolution* setTargetFrameTime(Double milliseconds) {
+            target = milliseconds;
+            return this;
+        }
+
+        /**
+         * @brief Set scale range
+         *
+         * Default is `0.5` to `1.0`. Max scale larger than `1.0` renders the
+         * scene supersampled.
+         */
+        DynamicResolution* setScaleRange(Float min, Float max);
+
+        /** @brief Current scale */
+        inline Float scale() const { return currentScale; }
+
+        /** @brief Current render size */
+        inline Vector2i renderSize() const { return framebuffer.viewport().size(); }
+
+        /** @brief GPU time of last measured frame in milliseconds */
+        inline Double frameTime() const { return lastFrameTime; }
+
+        /** @brief Set window size */
+        void setViewport(const Vector2i& size);
+
+        /**
+         * @brief Begin frame
+         *
+         * Updates the scale from measured frame times, clears the offscreen
+         * target and binds it for drawing.
+         */
+        void begin();
+
+        /**
+         * @brief End frame
+         *
+         * Upscales the rendered image to default framebuffer and binds it
+         * for drawing.
+         */
+        void end();
+
+    private:
+        /* Queries of the last few frames, the results are read back when
+           available */
+        enum: std::size_t { QueryCount = 4 };
+
+        struct FrameQuery {
+            inline FrameQuery(): pending(false), scale(1.0f) {}
+
+            Query query;
+            bool pending;
+            Float scale;
+        };
+
+        void createStorage();
+        void updateScale();
+        void applyScale();
+
+        Framebuffer framebuffer;
+        Renderbuffer color, depth;
+        FrameQuery queries[QueryCount];
+        std::size_t currentQuery;
+        Vector2i windowSize;
+        Double target, lastFrameTime;
+        Float minScale, maxScale, currentScale, filteredScale;
+};
+
+}}
+
+#endif
@@ -0,0 +1,49 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform vec3 ambientColor;
+uniform vec3 diffuseColor;
+uniform vec3 specularColor;
+uniform float shininess;
+
+in vec3 transformedNormal;
+in vec3 lightDirection;
+in vec3 cameraDirection;
+
+out vec4 color;
+
+void main() {
+    vec3 normalizedNormal = normalize(transformedNormal);
+    vec3 normalizedLightDirection = normalize(lightDirection);
+
+    color = vec4(ambientColor, 1.0);
+
+    float intensity = max(dot(normalizedNormal, normalizedLightDirection), 0.0);
+    color.rgb += diffuseColor*intensity;
+    if(intensity > 0.0) {
+        vec3 reflection = reflect(-normalizedLightDirection, normalizedNormal);
+        float specular = pow(max(dot(normalize(cameraDirection), reflection), 0.0), shininess);
+        color.rgb += specularColor*specular;
+    }
+}
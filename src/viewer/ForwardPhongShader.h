@@ -0,0 +1,102 @@
+#ifndef Magnum_Examples_ForwardPhongShader_h
+#define Magnum_Examples_ForwardPhongShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+#include <Color.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Phong shader for forward rendering
+
+Same lighting as Shaders::PhongShader with one point light. The position is
+declared `invariant`, the same as in @ref DepthShader, so depth of the main
+pass is guaranteed to match depth written by the pre-pass and the main pass
+can use @ref Renderer::DepthFunction "DepthFunction::Equal".
+*/
+class ForwardPhongShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector3> Position; /**< @brief Vertex position */
+        typedef Attribute<1, Vector3> Normal;   /**< @brief Normal direction */
+
+        ForwardPhongShader();
+
+        /** @brief Set transformation matrix */
+        inline ForwardPhongShader* setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set projection matrix */
+        inline ForwardPhongShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set light position in camera space */
+        inline ForwardPhongShader* setLightPosition(const Vector3& position) {
+            setUniform(lightPositionUniform, position);
+            return this;
+        }
+
+        /** @brief Set ambient color */
+        inline ForwardPhongShader* setAmbientColor(const Color3<>& color) {
+            setUniform(ambientColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set diffuse color */
+        inline ForwardPhongShader* setDiffuseColor(const Color3<>& color) {
+            setUniform(diffuseColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set specular color */
+        inline ForwardPhongShader* setSpecularColor(const Color3<>& color) {
+            setUniform(specularColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set shininess */
+        inline ForwardPhongShader* setShininess(Float shininess) {
+            setUniform(shininessUniform, shininess);
+            return this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            lightPositionUniform,
+            ambientColorUniform,
+            diffuseColorUniform,
+            specularColorUniform,
+            shininessUniform;
+};
+
+}}
+
+#endif
@@ -22,28 +22,29 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#define CORRECTION_TEXTURE_SIZE 1024
+uniform mat4 transformationMatrix;
+uniform mat4 projectionMatrix;
+uniform vec3 lightPosition;
 
-uniform sampler2D textureData;
-uniform samplerBuffer colorCorrectionTextureData;
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
 
-in vec2 textureCoords;
+out vec3 transformedNormal;
+out vec3 lightDirection;
+out vec3 cameraDirection;
 
-layout(location = 0) out vec4 original;
-layout(location = 1) out vec4 grayscale;
-layout(location = 2) out vec4 corrected;
+/* Depth has to match the pre-pass done with DepthShader */
+invariant gl_Position;
 
 void main() {
-    /* Original color */
-    vec4 color = texture(textureData, textureCoords);
-    original = color;
-
-    /* Grayscale */
-    float gray = dot(color.rgb, vec3(0.3, 0.59, 0.11));
-    grayscale = vec4(gray, gray, gray, 1.0);
-
-    /* Color corrected */
-    corrected.r = texelFetch(colorCorrectionTextureData, int(color.r*CORRECTION_TEXTURE_SIZE-1)).r;
-    corrected.g = texelFetch(colorCorrectionTextureData, int(color.g*CORRECTION_TEXTURE_SIZE-1)).r;
-    corrected.b = texelFetch(colorCorrectionTextureData, int(color.b*CORRECTION_TEXTURE_SIZE-1)).r;
+    vec4 transformedPosition4 = transformationMatrix*position;
+    vec3 transformedPosition = transformedPosition4.xyz/transformedPosition4.w;
+
+    /* Assumes uniform scaling */
+    transformedNormal = mat3(transformationMatrix)*normal;
+
+    lightDirection = normalize(lightPosition - transformedPosition);
+    cameraDirection = -transformedPosition;
+
+    gl_Position = projectionMatrix*transformedPosition4;
 }
@@ -31,7 +31,7 @@ using namespace Magnum;
 
 namespace Magnum { namespace Examples {
 
-FpsCounterExample::FpsCounterExample(const Arguments& arguments, Configuration* configuration): Application(arguments, configuration), frames(0), totalFrames(0), minimalDuration(3.5), totalDuration(0.0), fpsEnabled(false)
+FpsCounterExample::FpsCounterExample(const Arguments& arguments, Configuration* configuration): Application(arguments, configuration), frames(0), totalFrames(0), minimalDuration(3.5), totalDuration(0.0), fpsEnabled(false), resolutionScale(-1.0f), scales(0.0), totalScales(0.0)
     #ifndef MAGNUM_TARGET_GLES
     , primitives(0), totalPrimitives(0), samples(0), totalSamples(0), primitiveEnabled(false), sampleEnabled(false)
     #endif
@@ -43,8 +43,10 @@ void FpsCounterExample::redraw() {
     #else
     if(fpsEnabled) {
     #endif
-        if(fpsEnabled)
+        if(fpsEnabled) {
             ++frames;
+            if(resolutionScale >= 0.0f) scales += resolutionScale;
+        }
         #ifndef MAGNUM_TARGET_GLES
         if(primitiveEnabled) {
             primitiveQuery.end();
@@ -67,7 +69,10 @@ void FpsCounterExample::redraw() {
             std::cout.setf(std::ostream::floatfield, std::ostream::fixed);
             if(fpsEnabled) {
                 std::cout << std::setw(10) << frames/duration << " FPS ";
+                if(resolutionScale >= 0.0f)
+                    std::cout << std::setw(6) << scales*100.0/frames << "% res ";
                 totalFrames += frames;
+                totalScales += scales;
             }
             #ifndef MAGNUM_TARGET_GLES
             if(primitiveEnabled) {
@@ -87,6 +92,7 @@ void FpsCounterExample::redraw() {
             std::cout.flush();
 
             frames = 0;
+            scales = 0.0;
             #ifndef MAGNUM_TARGET_GLES
             primitives = 0;
             samples = 0;
@@ -139,6 +145,7 @@ void FpsCounterExample::setSampleCounterEnabled(bool enabled) {
 void FpsCounterExample::resetCounter() {
     before = std::chrono::high_resolution_clock::now();
     frames = totalFrames = 0;
+    scales = totalScales = 0.0;
     #ifndef MAGNUM_TARGET_GLES
     primitives = totalPrimitives = samples = totalSamples = 0;
     #endif
@@ -154,8 +161,11 @@ void FpsCounterExample::printCounterStatistics() {
         std::cout << "Average values on " << viewport.x()
              << "x" << viewport.y() << " during " << totalDuration
              << " seconds:                                 \n";
-        if(fpsEnabled)
+        if(fpsEnabled) {
             std::cout << std::setw(10) << totalFrames/totalDuration << " FPS ";
+            if(resolutionScale >= 0.0f)
+                std::cout << std::setw(6) << totalScales*100.0/totalFrames << "% res ";
+        }
 
         #ifndef MAGNUM_TARGET_GLES
         if(primitiveEnabled) {
@@ -73,6 +73,17 @@ class FpsCounterExample: public Application {
          */
         void setFpsCounterEnabled(bool enabled);
 
+        /**
+         * @brief Set current resolution scale
+         *
+         * Expected to be called each frame when rendering with dynamic
+         * resolution. Once set, average scale is printed together with FPS.
+         * Negative value disables the printing again.
+         */
+        inline void setResolutionScale(Float scale) {
+            resolutionScale = scale;
+        }
+
         #ifndef MAGNUM_TARGET_GLES
         /** @brief Whether primitive counter is enabled */
         inline bool primitiveCounterEnabled() const { return primitiveEnabled; }
@@ -140,6 +151,8 @@ class FpsCounterExample: public Application {
         std::size_t frames, totalFrames;
         double minimalDuration, totalDuration;
         bool fpsEnabled;
+        Float resolutionScale;
+        double scales, totalScales;
         #ifndef MAGNUM_TARGET_GLES
         UnsignedInt primitives, totalPrimitives, samples, totalSamples;
         bool primitiveEnabled, sampleEnabled;
@@ -0,0 +1,93 @@
+#ifndef Magnum_Examples_GBufferShader_h
+#define Magnum_Examples_GBufferShader_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <Math/Matrix4.h>
+#include <AbstractShaderProgram.h>
+#include <Color.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief G-buffer shader
+
+Fills the G-buffer for @ref DeferredRenderer. Albedo and specular intensity
+go to RGBA8 target, view-space normal encoded with octahedral mapping to RG16F
+target and ambient color directly to the light accumulation target.
+*/
+class GBufferShader: public AbstractShaderProgram {
+    public:
+        typedef Attribute<0, Vector3> Position; /**< @brief Vertex position */
+        typedef Attribute<1, Vector3> Normal;   /**< @brief Normal direction */
+
+        enum: UnsignedInt {
+            AlbedoSpecularOutput = 0,   /**< Albedo and specular intensity */
+            NormalOutput = 1,           /**< Octahedral-encoded normal */
+            LightOutput = 2             /**< Ambient color */
+        };
+
+        GBufferShader();
+
+        /** @brief Set transformation matrix */
+        inline GBufferShader* setTransformationMatrix(const Matrix4& matrix) {
+            setUniform(transformationMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set projection matrix */
+        inline GBufferShader* setProjectionMatrix(const Matrix4& matrix) {
+            setUniform(projectionMatrixUniform, matrix);
+            return this;
+        }
+
+        /** @brief Set ambient color */
+        inline GBufferShader* setAmbientColor(const Color3<>& color) {
+            setUniform(ambientColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set diffuse color */
+        inline GBufferShader* setDiffuseColor(const Color3<>& color) {
+            setUniform(diffuseColorUniform, color);
+            return this;
+        }
+
+        /** @brief Set specular intensity */
+        inline GBufferShader* setSpecularIntensity(Float intensity) {
+            setUniform(specularIntensityUniform, intensity);
+            return this;
+        }
+
+    private:
+        Int transformationMatrixUniform,
+            projectionMatrixUniform,
+            ambientColorUniform,
+            diffuseColorUniform,
+            specularIntensityUniform;
+};
+
+}}
+
+#endif
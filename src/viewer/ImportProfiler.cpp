@@ -0,0 +1,136 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ImportProfiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+constexpr const char* PhaseNames[] = {
+    "open", "extract", "split", "optimize", "interleave", "compressIndices", "stripify", "bvh", "upload"
+};
+
+std::string escapeJson(const std::string& string) {
+    std::string out;
+    for(char c: string) {
+        if(c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+}
+
+const char* ImportProfiler::phaseName(Phase phase) {
+    return PhaseNames[std::size_t(phase)];
+}
+
+ImportProfiler::ImportProfiler(): begin(Clock::now()), currentPhase(Phase::Open), inMesh(false), phaseTimes{}, total(0.0), peakMemory(0) {}
+
+void ImportProfiler::start(Phase phase) {
+    currentPhase = phase;
+    phaseBegin = Clock::now();
+}
+
+void ImportProfiler::stop() {
+    const Double time = std::chrono::duration<Double, std::milli>(Clock::now() - phaseBegin).count();
+    phaseTimes[std::size_t(currentPhase)] += time;
+    if(inMesh) meshTimings.back().times[std::size_t(currentPhase)] += time;
+}
+
+void ImportProfiler::beginMesh(UnsignedInt id) {
+    meshTimings.push_back(MeshTiming{id, 0, 0, {}});
+    inMesh = true;
+}
+
+void ImportProfiler::endMesh(std::size_t vertexCount, std::size_t triangleCount) {
+    meshTimings.back().vertexCount = vertexCount;
+    meshTimings.back().triangleCount = triangleCount;
+    inMesh = false;
+}
+
+void ImportProfiler::finish() {
+    total = std::chrono::duration<Double, std::milli>(Clock::now() - begin).count();
+
+    /* Peak over whole process lifetime, which at this point is mostly the
+       import. Linux reports it in kilobytes. */
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    peakMemory = std::size_t(usage.ru_maxrss)*1024;
+}
+
+void ImportProfiler::print() const {
+    std::cout << "Import timing in ms:" << std::endl
+              << "    mesh  vertices  triangles   extract     split  optimize  interleave   indices  stripify       bvh    upload" << std::endl
+              << std::fixed << std::setprecision(2);
+    for(const MeshTiming& mesh: meshTimings) {
+        std::cout << std::setw(8) << mesh.id << std::setw(10) << mesh.vertexCount << std::setw(11) << mesh.triangleCount;
+        for(std::size_t i = std::size_t(Phase::Extract); i != PhaseCount; ++i)
+            std::cout << std::setw(i == std::size_t(Phase::Interleave) ? 12 : 10) << mesh.times[i];
+        std::cout << std::endl;
+    }
+
+    Double measured = 0.0;
+    for(Double time: phaseTimes) measured += time;
+    std::cout << "   total" << std::setw(31) << phaseTimes[std::size_t(Phase::Extract)];
+    for(std::size_t i = std::size_t(Phase::Split); i != PhaseCount; ++i)
+        std::cout << std::setw(i == std::size_t(Phase::Interleave) ? 12 : 10) << phaseTimes[i];
+    std::cout << std::endl
+              << "File open and parse " << phaseTimes[std::size_t(Phase::Open)] << " ms, other "
+              << total - measured << " ms, total " << total << " ms" << std::endl
+              << "Peak resident memory " << peakMemory/(1024.0*1024.0) << " MB" << std::endl;
+}
+
+bool ImportProfiler::writeJson(const std::string& filename, const std::string& importedFilename) const {
+    std::ofstream out(filename);
+    if(!out.good()) return false;
+
+    out << "{\n  \"file\": \"" << escapeJson(importedFilename) << "\",\n"
+        << "  \"totalTime\": " << total << ",\n"
+        << "  \"peakResidentMemory\": " << peakMemory << ",\n"
+        << "  \"phases\": {";
+    for(std::size_t i = 0; i != PhaseCount; ++i)
+        out << (i ? ", " : "") << '"' << PhaseNames[i] << "\": " << phaseTimes[i];
+    out << "},\n  \"meshes\": [";
+    for(std::size_t i = 0; i != meshTimings.size(); ++i) {
+        const MeshTiming& mesh = meshTimings[i];
+        out << (i ? ",\n" : "\n") << "    {\"id\": " << mesh.id
+            << ", \"vertices\": " << mesh.vertexCount
+            << ", \"triangles\": " << mesh.triangleCount;
+        for(std::size_t j = std::size_t(Phase::Extract); j != PhaseCount; ++j)
+            out << ", \"" << PhaseNames[j] << "\": " << mesh.times[j];
+        out << '}';
+    }
+    out << "\n  ]\n}\n";
+
+    return out.good();
+}
+
+}}
@@ -0,0 +1,138 @@
+#ifndef Magnum_Examples_ImportProfiler_h
+#define Magnum_Examples_ImportProfiler_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Import phase profiler
+
+Measures wall time of import phases per mesh and in total and peak resident
+memory of the process. Results can be printed to console output or written as
+JSON. Usage:
+@code
+profiler.start(ImportProfiler::Phase::Open);
+// open the file...
+profiler.stop();
+
+profiler.beginMesh(id);
+profiler.start(ImportProfiler::Phase::Extract);
+// ...
+profiler.stop();
+profiler.endMesh(vertexCount, triangleCount);
+
+profiler.finish();
+@endcode
+*/
+class ImportProfiler {
+    public:
+        /** @brief Import phase */
+        enum class Phase: UnsignedByte {
+            Open,               /**< File open and parse, not per mesh */
+            Extract,            /**< Mesh data extraction */
+            Split,              /**< Splitting into chunks */
+            Optimize,           /**< Vertex cache optimization */
+            Interleave,         /**< Vertex data interleaving */
+            CompressIndices,    /**< Index compression */
+            Stripify,           /**< Triangle strip generation and comparison */
+            Bvh,                /**< BVH build for picking */
+            Upload              /**< GPU upload */
+        };
+
+        enum: std::size_t {
+            PhaseCount = 9      /**< @brief Phase count */
+        };
+
+        /** @brief Phase name */
+        static const char* phaseName(Phase phase);
+
+        /** @brief Timing of one mesh */
+        struct MeshTiming {
+            UnsignedInt id;                 /**< @brief Mesh ID */
+            std::size_t vertexCount,        /**< @brief Vertex count */
+                triangleCount;              /**< @brief Triangle count */
+            Double times[PhaseCount];       /**< @brief Phase times in milliseconds */
+        };
+
+        /** @brief Constructor, starts measuring total time */
+        explicit ImportProfiler();
+
+        /** @brief Start measuring given phase */
+        void start(Phase phase);
+
+        /** @brief Stop measuring current phase */
+        void stop();
+
+        /** @brief Begin processing of new mesh */
+        void beginMesh(UnsignedInt id);
+
+        /** @brief End processing of current mesh */
+        void endMesh(std::size_t vertexCount, std::size_t triangleCount);
+
+        /** @brief Stop measuring total time and get peak resident memory */
+        void finish();
+
+        /** @brief Per-mesh timing */
+        inline const std::vector<MeshTiming>& meshes() const { return meshTimings; }
+
+        /** @brief Total time of given phase in milliseconds */
+        inline Double phaseTime(Phase phase) const { return phaseTimes[std::size_t(phase)]; }
+
+        /** @brief Total import time in milliseconds */
+        inline Double totalTime() const { return total; }
+
+        /** @brief Peak resident memory in bytes */
+        inline std::size_t peakResidentMemory() const { return peakMemory; }
+
+        /** @brief Print per-mesh and total timing to console output */
+        void print() const;
+
+        /**
+         * @brief Write timing as JSON
+         *
+         * Returns `false` if the file cannot be written.
+         */
+        bool writeJson(const std::string& filename, const std::string& importedFilename) const;
+
+    private:
+        typedef std::chrono::high_resolution_clock Clock;
+
+        Clock::time_point begin, phaseBegin;
+        Phase currentPhase;
+        bool inMesh;
+        std::vector<MeshTiming> meshTimings;
+        Double phaseTimes[PhaseCount];
+        Double total;
+        std::size_t peakMemory;
+};
+
+}}
+
+#endif
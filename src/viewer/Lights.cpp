@@ -0,0 +1,62 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "Lights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <Math/Functions.h>
+
+namespace Magnum { namespace Examples {
+
+std::vector<PointLight> generateLights(std::size_t count, const Vector3& min, const Vector3& max) {
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<Float> unit(0.0f, 1.0f);
+
+    /* Each light covers about four times its share of the box volume. Flat
+       boxes are made thicker, so the lights don't get zero radius. */
+    const Vector3 extent = max - min;
+    Vector3 size = extent;
+    for(std::size_t i = 0; i != 3; ++i) size[i] = std::max(size[i], extent.length()*0.1f);
+    const Float radius = std::cbrt(4.0f*size.x()*size.y()*size.z()/count);
+
+    std::vector<PointLight> lights;
+    lights.reserve(count);
+    for(std::size_t i = 0; i != count; ++i) {
+        const Vector3 position = min + extent*Vector3(unit(generator), unit(generator), unit(generator));
+
+        /* Saturated colors, so the individual lights can be distinguished */
+        const Float hue = unit(generator)*6.0f;
+        const Color3<> color(Math::clamp(std::abs(hue - 3.0f) - 1.0f, 0.0f, 1.0f),
+                             Math::clamp(2.0f - std::abs(hue - 2.0f), 0.0f, 1.0f),
+                             Math::clamp(2.0f - std::abs(hue - 4.0f), 0.0f, 1.0f));
+
+        lights.push_back({position, radius, color});
+    }
+
+    return lights;
+}
+
+}}
@@ -0,0 +1,54 @@
+#ifndef Magnum_Examples_Lights_h
+#define Magnum_Examples_Lights_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <Math/Vector3.h>
+#include <Color.h>
+
+namespace Magnum { namespace Examples {
+
+/** @brief Point light */
+struct PointLight {
+    Vector3 position;   /**< @brief Position */
+    Float radius;       /**< @brief Radius, no light reaches beyond it */
+    Color3<> color;     /**< @brief Color */
+};
+
+/**
+@brief Generate lights filling given box
+@param count    Light count
+@param min      Minimal corner of the box
+@param max      Maximal corner of the box
+
+The lights are randomly placed with a fixed seed, so the results are
+repeatable. Their radius is chosen so each point in the box is covered by
+roughly the same count of lights regardless of the total count.
+*/
+std::vector<PointLight> generateLights(std::size_t count, const Vector3& min, const Vector3& max);
+
+}}
+
+#endif
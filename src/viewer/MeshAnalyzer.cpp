@@ -0,0 +1,160 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <PluginManager/PluginManager.h>
+#include <Trade/AbstractImporter.h>
+#include <Trade/MeshData3D.h>
+
+#include "VertexCache.h"
+#include "configure.h"
+
+using namespace Corrade::PluginManager;
+using namespace Magnum::Trade;
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Simulates FIFO and LRU post-transform vertex caches of various sizes on all
+ * meshes in given COLLADA file and reports ACMR and ATVR of the original
+ * triangle order and of the order produced by Tipsify and Forsyth's
+ * algorithm, both tuned for the given cache size. The viewer itself uses
+ * Tipsify with cache size 24 by default, see its --optimizer and
+ * --cache-size options.
+ */
+namespace {
+
+constexpr std::size_t CacheSizeCount = 6;
+constexpr std::size_t CacheSizes[CacheSizeCount] = {8, 12, 16, 24, 32, 64};
+constexpr VertexCacheOptimizer Optimizers[] = {
+    VertexCacheOptimizer::None,
+    VertexCacheOptimizer::Tipsify,
+    VertexCacheOptimizer::Forsyth
+};
+
+struct Totals {
+    std::size_t triangles;
+
+    /* Sum of ACMR*triangleCount for each cache size, optimizer and policy */
+    double misses[CacheSizeCount][3][2];
+};
+
+}
+
+int analyze(int argc, char** argv) {
+    const char* filename = nullptr;
+    bool perMesh = true;
+    for(int i = 1; i != argc; ++i) {
+        if(std::strcmp(argv[i], "--summary") == 0) perMesh = false;
+        else if(argv[i][0] != '-' && !filename) filename = argv[i];
+        else filename = nullptr;
+    }
+    if(!filename) {
+        std::cout << "Usage: " << argv[0] << " [--summary] file.dae" << std::endl;
+        return 0;
+    }
+
+    PluginManager<AbstractImporter> manager(MAGNUM_PLUGINS_IMPORTER_DIR);
+    if(manager.load("ColladaImporter") != LoadState::Loaded) {
+        Error() << "Could not load ColladaImporter plugin";
+        return 1;
+    }
+    std::unique_ptr<AbstractImporter> importer(manager.instance("ColladaImporter"));
+    if(!importer || !importer->openFile(filename)) {
+        Error() << "Could not open" << filename;
+        return 2;
+    }
+
+    Totals totals{};
+    std::cout << std::fixed << std::setprecision(3);
+
+    for(UnsignedInt id = 0; id != importer->mesh3DCount(); ++id) {
+        std::unique_ptr<MeshData3D> data(importer->mesh3D(id));
+        if(!data || !data->indices() || !data->positionArrayCount()) continue;
+
+        const std::vector<UnsignedInt> indices = *data->indices();
+        const UnsignedInt vertexCount = data->positions(0)->size();
+        totals.triangles += indices.size()/3;
+
+        if(perMesh) {
+            std::cout << "Mesh " << id << ": " << vertexCount << " vertices, " << indices.size()/3 << " triangles" << std::endl
+                      << "  cache  optimizer     ms   FIFO ACMR  FIFO ATVR   LRU ACMR   LRU ATVR" << std::endl;
+        }
+
+        for(std::size_t size = 0; size != CacheSizeCount; ++size) {
+            for(std::size_t optimizer = 0; optimizer != 3; ++optimizer) {
+                std::vector<UnsignedInt> optimized = indices;
+                const auto start = std::chrono::high_resolution_clock::now();
+                optimizeVertexCache(optimized, vertexCount, Optimizers[optimizer], CacheSizes[size]);
+                const double time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+                const VertexCacheStatistics fifo = simulateVertexCache(optimized, vertexCount, VertexCachePolicy::Fifo, CacheSizes[size]);
+                const VertexCacheStatistics lru = simulateVertexCache(optimized, vertexCount, VertexCachePolicy::Lru, CacheSizes[size]);
+                totals.misses[size][optimizer][0] += fifo.acmr*(indices.size()/3);
+                totals.misses[size][optimizer][1] += lru.acmr*(indices.size()/3);
+
+                if(!perMesh) continue;
+                std::cout << std::setw(7) << CacheSizes[size]
+                          << std::setw(11) << vertexCacheOptimizerName(Optimizers[optimizer])
+                          << std::setw(7) << std::setprecision(1) << time << std::setprecision(3)
+                          << std::setw(12) << fifo.acmr << std::setw(11) << fifo.atvr
+                          << std::setw(11) << lru.acmr << std::setw(11) << lru.atvr << std::endl;
+            }
+        }
+    }
+
+    if(!totals.triangles) {
+        Error() << "No indexed meshes in" << filename;
+        return 3;
+    }
+
+    /* Triangle-weighted ACMR over all meshes, best optimizer for each cache
+       size marked */
+    std::cout << "All meshes: " << totals.triangles << " triangles" << std::endl
+              << "  cache  optimizer   FIFO ACMR   LRU ACMR" << std::endl;
+    for(std::size_t size = 0; size != CacheSizeCount; ++size) {
+        std::size_t best = 0;
+        for(std::size_t optimizer = 1; optimizer != 3; ++optimizer)
+            if(totals.misses[size][optimizer][0] < totals.misses[size][best][0]) best = optimizer;
+
+        for(std::size_t optimizer = 0; optimizer != 3; ++optimizer)
+            std::cout << std::setw(7) << CacheSizes[size]
+                      << std::setw(11) << vertexCacheOptimizerName(Optimizers[optimizer])
+                      << std::setw(12) << totals.misses[size][optimizer][0]/totals.triangles
+                      << std::setw(11) << totals.misses[size][optimizer][1]/totals.triangles
+                      << (optimizer == best ? "  *" : "") << std::endl;
+    }
+
+    return 0;
+}
+
+}}
+
+int main(int argc, char** argv) {
+    return Magnum::Examples::analyze(argc, argv);
+}
@@ -0,0 +1,103 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "MeshSplitter.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+/* Spreads lower 10 bits so there are two zero bits between each of them */
+UnsignedInt spreadBits(UnsignedInt x) {
+    x &= 0x3ff;
+    x = (x | (x << 16)) & 0x030000ff;
+    x = (x | (x << 8)) & 0x0300f00f;
+    x = (x | (x << 4)) & 0x030c30c3;
+    x = (x | (x << 2)) & 0x09249249;
+    return x;
+}
+
+}
+
+std::vector<MeshChunk> splitMesh(const std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, UnsignedInt maxVertexCount) {
+    const std::size_t triangleCount = indices.size()/3;
+
+    /* Bounds of triangle centroids (times three, the division is not needed
+       for sorting) */
+    std::vector<Vector3> centroids(triangleCount);
+    Vector3 min, max;
+    for(std::size_t i = 0; i != triangleCount; ++i) {
+        centroids[i] = positions[indices[i*3]] + positions[indices[i*3 + 1]] + positions[indices[i*3 + 2]];
+        for(std::size_t j = 0; j != 3; ++j) {
+            min[j] = i ? std::min(min[j], centroids[i][j]) : centroids[i][j];
+            max[j] = i ? std::max(max[j], centroids[i][j]) : centroids[i][j];
+        }
+    }
+
+    /* Sort triangles by 30-bit Morton code of the centroid */
+    std::vector<std::pair<UnsignedInt, UnsignedInt>> order(triangleCount);
+    for(std::size_t i = 0; i != triangleCount; ++i) {
+        UnsignedInt code = 0;
+        for(std::size_t j = 0; j != 3; ++j) {
+            const Float extent = max[j] - min[j];
+            const UnsignedInt quantized = extent > 0.0f ? UnsignedInt((centroids[i][j] - min[j])/extent*1023.0f) : 0;
+            code |= spreadBits(quantized) << (2 - j);
+        }
+        order[i] = {code, UnsignedInt(i)};
+    }
+    std::sort(order.begin(), order.end());
+
+    /* Greedily fill the chunks. Vertex is in current chunk if its stamp is
+       equal to chunk count. */
+    std::vector<MeshChunk> chunks;
+    std::vector<UnsignedInt> stamp(positions.size(), 0), remap(positions.size());
+    for(const std::pair<UnsignedInt, UnsignedInt>& item: order) {
+        const UnsignedInt* const triangle = indices.data() + item.second*3;
+
+        UnsignedInt newVertexCount = 0;
+        for(std::size_t j = 0; j != 3; ++j)
+            if(stamp[triangle[j]] != chunks.size()) ++newVertexCount;
+        if(chunks.empty() || chunks.back().positions.size() + newVertexCount > maxVertexCount)
+            chunks.emplace_back();
+
+        MeshChunk& chunk = chunks.back();
+        for(std::size_t j = 0; j != 3; ++j) {
+            const UnsignedInt vertex = triangle[j];
+            if(stamp[vertex] != chunks.size()) {
+                stamp[vertex] = chunks.size();
+                remap[vertex] = chunk.positions.size();
+                chunk.positions.push_back(positions[vertex]);
+                chunk.normals.push_back(normals[vertex]);
+            }
+            chunk.indices.push_back(remap[vertex]);
+        }
+    }
+
+    return chunks;
+}
+
+}}
@@ -0,0 +1,57 @@
+#ifndef Magnum_Examples_MeshSplitter_h
+#define Magnum_Examples_MeshSplitter_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <Math/Vector3.h>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/** @brief Mesh chunk */
+struct MeshChunk {
+    std::vector<UnsignedInt> indices;   /**< @brief Triangle indices */
+    std::vector<Vector3> positions;     /**< @brief Vertex positions */
+    std::vector<Vector3> normals;       /**< @brief Vertex normals */
+};
+
+/**
+@brief Split mesh into chunks with limited vertex count
+@param indices          Triangle indices
+@param positions        Vertex positions
+@param normals          Vertex normals
+@param maxVertexCount   Max vertex count in one chunk
+
+Triangles are sorted along Morton curve by their centroid and then greedily
+added to chunks until the chunk would have more than @p maxVertexCount
+unique vertices. Chunks are thus spatially compact, which is good both for
+culling and for vertex cache. Vertices on chunk boundaries are duplicated.
+Triangle order in each chunk is not optimized for vertex cache.
+*/
+std::vector<MeshChunk> splitMesh(const std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals, UnsignedInt maxVertexCount);
+
+}}
+
+#endif
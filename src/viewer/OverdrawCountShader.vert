@@ -22,19 +22,10 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#define FrameCount 7
+uniform mat4 transformationProjectionMatrix;
 
-uniform sampler2D frame[FrameCount];
-
-in vec2 textureCoordinate;
-
-out vec4 color;
+layout(location = 0) in vec4 position;
 
 void main() {
-    vec4 summedBlur = vec4(0.0, 0.0, 0.0, 0.0);
-    for(int i = 0; i != FrameCount; ++i)
-        summedBlur += texture(frame[i], textureCoordinate);
-
-    color.rgb = summedBlur.rgb/FrameCount;
-    color.a = 1.0;
+    gl_Position = transformationProjectionMatrix*position;
 }
@@ -0,0 +1,46 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+uniform sampler2D layerTextureData;
+uniform float maxLayers;
+
+out vec4 color;
+
+void main() {
+    float layers = texelFetch(layerTextureData, ivec2(gl_FragCoord.xy), 0).r;
+
+    /* Background stays black, saturated pixels are white */
+    if(layers == 0.0) {
+        color = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    } else if(layers > maxLayers) {
+        color = vec4(1.0);
+        return;
+    }
+
+    /* Blue for one layer, through green and yellow to red for maxLayers */
+    float t = 4.0*(layers - 1.0)/max(maxLayers - 1.0, 1.0);
+    color.rgb = clamp(vec3(t - 1.5, 1.5 - abs(t - 2.0), 2.5 - t), 0.0, 1.0);
+    color.a = 1.0;
+}
@@ -0,0 +1,146 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "OverdrawVisualizer.h"
+
+#include <algorithm>
+#include <vector>
+#include <Utility/Resource.h>
+#include <DefaultFramebuffer.h>
+#include <Image.h>
+#include <Renderer.h>
+#include <Shader.h>
+
+#include "DrawListCamera.h"
+#include "ViewedObject.h"
+
+namespace Magnum { namespace Examples {
+
+OverdrawVisualizer::OverdrawVisualizer(const Vector2i& size): framebuffer({{}, size}), layers(16.0f) {
+    /* Fullscreen triangle, positions are generated from gl_VertexID */
+    resolveMesh.setPrimitive(Mesh::Primitive::Triangles)
+        ->setVertexCount(3);
+
+    createTexture();
+}
+
+void OverdrawVisualizer::setViewport(const Vector2i& size) {
+    if(framebuffer.viewport().size() == size) return;
+
+    framebuffer.setViewport({{}, size});
+    createTexture();
+}
+
+void OverdrawVisualizer::createTexture() {
+    /* Immutable storage can't be resized, create new texture */
+    layerTexture.reset(new Texture2D);
+    layerTexture->setMinificationFilter(Texture2D::Filter::Nearest)
+        ->setMagnificationFilter(Texture2D::Filter::Nearest)
+        ->setWrapping(Texture2D::Wrapping::ClampToEdge)
+        ->setStorage(1, Texture2D::InternalFormat::R32F, framebuffer.viewport().size());
+    framebuffer.attachTexture2D(Framebuffer::ColorAttachment(0), layerTexture.get(), 0);
+}
+
+void OverdrawVisualizer::draw(DrawListCamera* camera) {
+    /* The viewer doesn't change clear color, so it is zero */
+    framebuffer.clear(AbstractFramebuffer::Clear::Color);
+    framebuffer.bind(AbstractFramebuffer::Target::Draw);
+
+    Renderer::setFeature(Renderer::Feature::DepthTest, false);
+    Renderer::setFeature(Renderer::Feature::Blending, true);
+    Renderer::setBlendFunction(Renderer::BlendFunction::One, Renderer::BlendFunction::One);
+
+    for(const DrawCommand& command: camera->drawList()) {
+        countShader.setTransformationProjectionMatrix(camera->projectionMatrix()*command.transformationMatrix)
+            ->use();
+        command.object->viewerMesh()->drawPositions();
+    }
+
+    Renderer::setFeature(Renderer::Feature::Blending, false);
+
+    /* Map the counts to colors */
+    defaultFramebuffer.bind(AbstractFramebuffer::Target::Draw);
+    layerTexture->bind(ResolveShader::LayerTextureLayer);
+    resolveShader.setMaxLayers(layers)
+        ->use();
+    resolveMesh.draw();
+    Renderer::setFeature(Renderer::Feature::DepthTest, true);
+}
+
+OverdrawVisualizer::Statistics OverdrawVisualizer::statistics() {
+    const Vector2i size = framebuffer.viewport().size();
+    Image2D image(AbstractImage::Format::Red, AbstractImage::Type::Float);
+    framebuffer.read({}, size, AbstractImage::Format::Red, AbstractImage::Type::Float, &image);
+    const Float* data = reinterpret_cast<const Float*>(image.data());
+
+    /* Only covered pixels, so the background doesn't skew the statistics */
+    std::vector<Float> covered;
+    covered.reserve(size.product());
+    double sum = 0.0;
+    for(std::size_t i = 0; i != std::size_t(size.product()); ++i) if(data[i] > 0.0f) {
+        covered.push_back(data[i]);
+        sum += data[i];
+    }
+
+    Statistics statistics{};
+    if(covered.empty()) return statistics;
+
+    auto percentile = [&covered](Float fraction) {
+        auto nth = covered.begin() + std::size_t(fraction*(covered.size() - 1));
+        std::nth_element(covered.begin(), nth, covered.end());
+        return *nth;
+    };
+
+    statistics.coverage = Float(covered.size())/size.product();
+    statistics.mean = sum/covered.size();
+    statistics.max = *std::max_element(covered.begin(), covered.end());
+    statistics.median = percentile(0.5f);
+    statistics.percentile90 = percentile(0.9f);
+    statistics.percentile99 = percentile(0.99f);
+    return statistics;
+}
+
+OverdrawVisualizer::CountShader::CountShader() {
+    Corrade::Utility::Resource rs("shaders");
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("OverdrawCountShader.vert")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("OverdrawCountShader.frag")));
+
+    link();
+
+    transformationProjectionMatrixUniform = uniformLocation("transformationProjectionMatrix");
+}
+
+OverdrawVisualizer::ResolveShader::ResolveShader() {
+    Corrade::Utility::Resource rs("shaders");
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Vertex, rs.get("OverdrawResolveShader.vert")));
+    attachShader(Shader::fromData(Version::GL330, Shader::Type::Fragment, rs.get("OverdrawResolveShader.frag")));
+
+    link();
+
+    maxLayersUniform = uniformLocation("maxLayers");
+
+    setUniform(uniformLocation("layerTextureData"), LayerTextureLayer);
+}
+
+}}
@@ -0,0 +1,139 @@
+#ifndef Magnum_Examples_OverdrawVisualizer_h
+#define Magnum_Examples_OverdrawVisualizer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <AbstractShaderProgram.h>
+#include <Framebuffer.h>
+#include <Mesh.h>
+#include <Texture.h>
+
+namespace Magnum { namespace Examples {
+
+class DrawListCamera;
+
+/**
+@brief Overdraw visualizer
+
+Draws everything in the camera draw list with additive blending into a float
+target, each fragment adding one. Depth test is disabled, so the result is
+count of all fragments rasterized in given pixel, visible or not. The counts
+are then mapped to color ramp from blue (one layer) through green and yellow
+to red (maxLayers() layers), pixels with even more layers are white.
+*/
+class OverdrawVisualizer {
+    public:
+        /** @brief Layers per pixel statistics */
+        struct Statistics {
+            Float coverage;     /**< @brief Fraction of pixels with at least one layer */
+            Float mean;         /**< @brief Mean layer count of covered pixels */
+            Float max;          /**< @brief Max layer count */
+            Float median;       /**< @brief 50th percentile of covered pixels */
+            Float percentile90; /**< @brief 90th percentile of covered pixels */
+            Float percentile99; /**< @brief 99th percentile of covered pixels */
+        };
+
+        /**
+         * @brief Constructor
+         * @param size      Viewport size
+         */
+        explicit OverdrawVisualizer(const Vector2i& size);
+
+        /** @brief Layer count mapped to the end of the color ramp */
+        inline Float maxLayers() const { return layers; }
+
+        /**
+         * @brief Set layer count mapped to the end of the color ramp
+         *
+         * Default is `16`.
+         */
+        inline OverdrawVisualizer* setMaxLayers(Float count) {
+            layers = count;
+            return this;
+        }
+
+        /** @brief Set viewport size */
+        void setViewport(const Vector2i& size);
+
+        /**
+         * @brief Draw overdraw of current camera draw list
+         *
+         * The camera draw list must be built with
+         * DrawListCamera::buildDrawList() before. The result is drawn into
+         * default framebuffer.
+         */
+        void draw(DrawListCamera* camera);
+
+        /**
+         * @brief Statistics of last draw() call
+         *
+         * Reads the counts back from GPU, thus stalls the pipeline.
+         */
+        Statistics statistics();
+
+    private:
+        class CountShader: public AbstractShaderProgram {
+            public:
+                CountShader();
+
+                inline CountShader* setTransformationProjectionMatrix(const Matrix4& matrix) {
+                    setUniform(transformationProjectionMatrixUniform, matrix);
+                    return this;
+                }
+
+            private:
+                Int transformationProjectionMatrixUniform;
+        };
+
+        class ResolveShader: public AbstractShaderProgram {
+            public:
+                enum: Int {
+                    LayerTextureLayer = 0
+                };
+
+                ResolveShader();
+
+                inline ResolveShader* setMaxLayers(Float count) {
+                    setUniform(maxLayersUniform, count);
+                    return this;
+                }
+
+            private:
+                Int maxLayersUniform;
+        };
+
+        void createTexture();
+
+        Framebuffer framebuffer;
+        std::unique_ptr<Texture2D> layerTexture;
+        CountShader countShader;
+        ResolveShader resolveShader;
+        Mesh resolveMesh;
+        Float layers;
+};
+
+}}
+
+#endif
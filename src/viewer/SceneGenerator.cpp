@@ -0,0 +1,268 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "SceneGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+#include <Color.h>
+#include <Math/Constants.h>
+#include <Math/Matrix4.h>
+#include <Primitives/Cube.h>
+#include <Primitives/Icosphere.h>
+#include <Primitives/UVSphere.h>
+#include <Trade/MeshData3D.h>
+#include <Trade/MeshObjectData3D.h>
+#include <Trade/PhongMaterialData.h>
+#include <Trade/SceneData.h>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+enum: UnsignedInt {
+    /* Cube, two icospheres and three UV spheres */
+    ShapeCount = 6,
+
+    /* Hash components of object and mesh properties */
+    RotationComponent = 0,
+    DirectionComponent = 1,
+    DistanceComponent = 3,
+    MaterialComponent = 4,
+    MeshSizeComponent = 5,
+    ShininessComponent = 6
+};
+
+/* MurmurHash3 finalizer */
+inline UnsignedInt mix(UnsignedInt h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+Trade::MeshData3D* scaledCopy(Trade::MeshData3D& data, Float scale) {
+    std::vector<Vector3>* positions = new std::vector<Vector3>(*data.positions(0));
+    for(Vector3& position: *positions) position *= scale;
+    return new Trade::MeshData3D(Mesh::Primitive::Triangles, new std::vector<UnsignedInt>(*data.indices()), {positions}, {new std::vector<Vector3>(*data.normals(0))}, {});
+}
+
+}
+
+SceneGenerator::SceneGenerator(): objectCount(1000), maxDepth(4), fanOut(8), materials(16), seed(0), reuse(0.9f), meshCount(0), depth(0), rootGridSize(0), rootSpacing(0.0f) {}
+
+SceneGenerator::~SceneGenerator() = default;
+
+bool SceneGenerator::setOptions(const std::string& options) {
+    std::istringstream in(options);
+    std::string option;
+    while(std::getline(in, option, ',')) {
+        const std::size_t equals = option.find('=');
+        const std::string key = option.substr(0, equals);
+        const std::string value = equals == std::string::npos ? std::string() : option.substr(equals + 1);
+        char* end;
+
+        if(key == "reuse") {
+            const Float v = std::strtof(value.c_str(), &end);
+            if(!value.empty() && !*end && v >= 0.0f && v <= 1.0f) {
+                reuse = v;
+                continue;
+            }
+        } else {
+            const unsigned long v = std::strtoul(value.c_str(), &end, 10);
+            if(!value.empty() && !*end) {
+                if(key == "seed") {
+                    seed = v;
+                    continue;
+                }
+                if(v && key == "objects") {
+                    objectCount = v;
+                    continue;
+                }
+                if(v && key == "depth") {
+                    maxDepth = v;
+                    continue;
+                }
+                if(v && key == "fanout") {
+                    fanOut = v;
+                    continue;
+                }
+                if(v && key == "materials") {
+                    materials = v;
+                    continue;
+                }
+            }
+        }
+
+        Error() << "SceneGenerator: invalid option" << option;
+        return false;
+    }
+
+    return true;
+}
+
+void SceneGenerator::generate() {
+    close();
+    nodes.reserve(objectCount);
+
+    /* Each object becomes a child of the first object which can take more
+       children, or a new root if there is none */
+    std::size_t parent = 0;
+    for(UnsignedInt i = 0; i != objectCount; ++i) {
+        while(parent != i && (nodes[parent].level + 1 == maxDepth || nodes[parent].childCount == fanOut))
+            ++parent;
+
+        if(parent == i) {
+            nodes.push_back({0, 0, 0, 0});
+            roots.push_back(i);
+            continue;
+        }
+
+        Node& p = nodes[parent];
+        if(!p.childCount) p.firstChild = i;
+        ++p.childCount;
+        const UnsignedInt level = p.level + 1;
+        nodes.push_back({0, 0, UnsignedInt(parent), level});
+        depth = std::max(depth, level + 1);
+    }
+    if(!roots.empty()) depth = std::max(depth, 1u);
+
+    meshCount = std::max(UnsignedInt(std::round(objectCount*(1.0f - reuse))), 1u);
+
+    /* Roots are on a square grid in XY plane, spaced by estimated size of
+       their subtrees, the whole scene is then scaled to size of about 4 */
+    rootGridSize = Int(std::ceil(std::sqrt(Float(roots.size()))));
+    rootSpacing = 3.0f + 2.0f*std::cbrt(Float(objectCount)/std::max(std::size_t(1), roots.size()));
+}
+
+Float SceneGenerator::random(UnsignedInt id, UnsignedInt component) const {
+    return (mix(seed + mix(id + mix(component + 0x9e3779b9)))>>8)/Float(1 << 24);
+}
+
+void SceneGenerator::close() {
+    nodes.clear();
+    roots.clear();
+    meshCount = depth = 0;
+}
+
+UnsignedInt SceneGenerator::sceneCount() const {
+    return nodes.empty() ? 0 : 1;
+}
+
+Trade::SceneData* SceneGenerator::scene(UnsignedInt id) {
+    if(nodes.empty() || id != 0) return nullptr;
+    return new Trade::SceneData({}, roots);
+}
+
+UnsignedInt SceneGenerator::object3DCount() const {
+    return nodes.size();
+}
+
+Trade::ObjectData3D* SceneGenerator::object3D(UnsignedInt id) {
+    if(id >= nodes.size()) return nullptr;
+    const Node& node = nodes[id];
+
+    std::vector<UnsignedInt> children(node.childCount);
+    std::iota(children.begin(), children.end(), node.firstChild);
+
+    const Matrix4 rotation = Matrix4::rotationY(Deg(360.0f*random(id, RotationComponent)));
+    Matrix4 transformation;
+
+    /* Root on the grid, scaled so the scene fits the view */
+    if(!node.level) {
+        const Int index = std::lower_bound(roots.begin(), roots.end(), id) - roots.begin();
+        const Float scale = 4.0f/(rootGridSize*rootSpacing);
+        const Vector2 position = (Vector2(index%rootGridSize, index/rootGridSize) - Vector2(Float(rootGridSize - 1)/2.0f))*rootSpacing*scale;
+        transformation = Matrix4::translation({position.x(), position.y(), 0.0f})*
+            Matrix4::scaling(Vector3(scale))*rotation;
+
+    /* Child in random direction from the parent, farther with more siblings
+       so the density stays about the same */
+    } else {
+        const Float z = 2.0f*random(id, DirectionComponent) - 1.0f;
+        const Float angle = 2.0f*Constants::pi()*random(id, DirectionComponent + 1);
+        const Float r = std::sqrt(1.0f - z*z);
+        const Float distance = (1.0f + random(id, DistanceComponent))*std::cbrt(Float(nodes[node.parent].childCount));
+        transformation = Matrix4::translation(Vector3(r*std::cos(angle), r*std::sin(angle), z)*distance)*rotation;
+    }
+
+    const UnsignedInt material = std::min(UnsignedInt(random(id, MaterialComponent)*materials), materials - 1);
+    return new Trade::MeshObjectData3D(children, transformation, id%meshCount, material);
+}
+
+UnsignedInt SceneGenerator::mesh3DCount() const {
+    return meshCount;
+}
+
+Trade::MeshData3D* SceneGenerator::mesh3D(UnsignedInt id) {
+    if(id >= meshCount) return nullptr;
+
+    /* Primitives have radius 1 (cube sqrt(3)), scale them to 0.3 - 0.6 */
+    const Float size = 0.3f + 0.3f*random(id, MeshSizeComponent);
+    switch(id%ShapeCount) {
+        case 0: {
+            Trade::MeshData3D cube = Primitives::Cube::solid();
+            return scaledCopy(cube, size/std::sqrt(3.0f));
+        }
+        case 1: {
+            Primitives::Icosphere<1> icosphere;
+            return scaledCopy(icosphere, size);
+        }
+        case 2: {
+            Primitives::Icosphere<2> icosphere;
+            return scaledCopy(icosphere, size);
+        }
+        case 3: {
+            Trade::MeshData3D sphere = Primitives::UVSphere::solid(8, 16);
+            return scaledCopy(sphere, size);
+        }
+        case 4: {
+            Trade::MeshData3D sphere = Primitives::UVSphere::solid(12, 24);
+            return scaledCopy(sphere, size);
+        }
+        default: {
+            Trade::MeshData3D sphere = Primitives::UVSphere::solid(16, 32);
+            return scaledCopy(sphere, size);
+        }
+    }
+}
+
+UnsignedInt SceneGenerator::materialCount() const {
+    return nodes.empty() ? 0 : materials;
+}
+
+Trade::AbstractMaterialData* SceneGenerator::material(UnsignedInt id) {
+    if(nodes.empty() || id >= materials) return nullptr;
+    return new Trade::PhongMaterialData({0.0f, 0.0f, 0.0f},
+        Color3<>::fromHSV(Deg(360.0f*id/materials), 0.6f, 0.9f),
+        {1.0f, 1.0f, 1.0f}, 10.0f + 90.0f*random(id, ShininessComponent));
+}
+
+}}
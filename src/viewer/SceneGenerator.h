@@ -0,0 +1,161 @@
+#ifndef Magnum_Examples_SceneGenerator_h
+#define Magnum_Examples_SceneGenerator_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <string>
+#include <vector>
+#include <Trade/AbstractImporter.h>
+
+namespace Magnum { namespace Examples {
+
+/**
+@brief Procedural scene generator
+
+Importer which, instead of reading a file, generates object hierarchy of
+given size from @ref Primitives shapes, so scene graph and renderer scaling
+can be measured on controlled workloads. The viewer adds it the same way as
+any imported scene, see `--generate` option.
+
+The objects are created in breadth-first order. Each object gets up to
+@ref setFanOut() "fan-out" children until given @ref setDepth() "depth" is
+reached, if no object can take more children, a new root is started. This
+way depth `1` gives flat scene, fan-out `1` gives chains of given depth and
+depth `2` with large fan-out gives wide scene. Meshes are cube, icosphere and
+UV spheres of various tessellation and size, each shared by on average
+`1/(1 - reuse)` objects. Materials are evenly distributed around the hue
+circle.
+
+Transformations, mesh and material assignment are computed from hash of the
+seed and object ID, so the same options always give the same scene and only
+the hierarchy is stored.
+*/
+class SceneGenerator: public Trade::AbstractImporter {
+    public:
+        explicit SceneGenerator();
+        ~SceneGenerator();
+
+        /**
+         * @brief Set options from string
+         *
+         * Comma-separated `key=value` list with keys `objects`, `depth`,
+         * `fanout`, `reuse`, `materials` and `seed`, e.g.
+         * `objects=10000,depth=4,fanout=8`. Options which are not specified
+         * are not changed. Prints error message and returns `false` on
+         * unknown key or invalid value.
+         */
+        bool setOptions(const std::string& options);
+
+        /** @brief Set object count, default is `1000` */
+        inline SceneGenerator* setObjectCount(UnsignedInt count) {
+            objectCount = count;
+            return this;
+        }
+
+        /** @brief Set max hierarchy depth, default is `4` */
+        inline SceneGenerator* setDepth(UnsignedInt depth) {
+            maxDepth = depth;
+            return this;
+        }
+
+        /** @brief Set max child count of each object, default is `8` */
+        inline SceneGenerator* setFanOut(UnsignedInt fanOut) {
+            this->fanOut = fanOut;
+            return this;
+        }
+
+        /**
+         * @brief Set mesh reuse ratio
+         *
+         * Value `0` gives each object its own mesh, `1` one mesh for all
+         * objects. Default is `0.9`.
+         */
+        inline SceneGenerator* setMeshReuse(Float reuse) {
+            this->reuse = reuse;
+            return this;
+        }
+
+        /** @brief Set material count, default is `16` */
+        inline SceneGenerator* setMaterialCount(UnsignedInt count) {
+            materials = count;
+            return this;
+        }
+
+        /** @brief Set random seed, default is `0` */
+        inline SceneGenerator* setSeed(UnsignedInt seed) {
+            this->seed = seed;
+            return this;
+        }
+
+        /**
+         * @brief Generate the scene
+         *
+         * Replaces previously generated scene. The data are then available
+         * through the importer interface until close() is called.
+         */
+        void generate();
+
+        /** @brief Count of root objects */
+        inline std::size_t rootCount() const { return roots.size(); }
+
+        /** @brief Depth of the deepest object */
+        inline UnsignedInt generatedDepth() const { return depth; }
+
+        inline Features features() const override { return {}; }
+
+        void close() override;
+
+        inline Int defaultScene() override { return 0; }
+        UnsignedInt sceneCount() const override;
+        Trade::SceneData* scene(UnsignedInt id) override;
+        UnsignedInt object3DCount() const override;
+        Trade::ObjectData3D* object3D(UnsignedInt id) override;
+        UnsignedInt mesh3DCount() const override;
+        Trade::MeshData3D* mesh3D(UnsignedInt id) override;
+        UnsignedInt materialCount() const override;
+        Trade::AbstractMaterialData* material(UnsignedInt id) override;
+
+    private:
+        /* Children of each object are contiguous, as they are created in
+           breadth-first order */
+        struct Node {
+            UnsignedInt firstChild, childCount, parent, level;
+        };
+
+        Float random(UnsignedInt id, UnsignedInt component) const;
+
+        UnsignedInt objectCount, maxDepth, fanOut, materials, seed;
+        Float reuse;
+
+        std::vector<Node> nodes;
+        std::vector<UnsignedInt> roots;
+        UnsignedInt meshCount, depth;
+        Int rootGridSize;
+        Float rootSpacing;
+};
+
+}}
+
+#endif
@@ -0,0 +1,252 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <SceneGraph/Camera3D.h>
+#include <SceneGraph/Drawable.h>
+#include <SceneGraph/Scene.h>
+#include <Trade/ObjectData3D.h>
+#include <Trade/SceneData.h>
+
+#include "SceneGenerator.h"
+#include "Types.h"
+
+namespace Magnum { namespace Examples {
+
+/*
+ * Measures CPU cost per object of drawing the scene graph, without any
+ * OpenGL context. The drawables are objects with the same structure as
+ * ViewedObject, but their draw() only consumes the matrix, so what is left is
+ * the cost of transformation computation and draw() dispatch. Each phase of
+ * Camera3D::draw() is measured separately, together with per-object
+ * absoluteTransformation() as used by the viewer's draw list. The results can
+ * be saved and compared with a previous run to track changes.
+ */
+namespace {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+class NoopDrawable: public Object3D, public SceneGraph::Drawable3D<> {
+    public:
+        NoopDrawable(Float* sink, Object3D* parent, SceneGraph::DrawableGroup3D<>* group): Object3D(parent), SceneGraph::Drawable3D<>(this, group), sink(sink) {}
+
+        void draw(const Matrix4& transformationMatrix, SceneGraph::AbstractCamera3D<>*) override {
+            *sink += transformationMatrix.translation().z();
+        }
+
+    private:
+        Float* sink;
+};
+
+struct Shape {
+    const char* name;
+    const char* options;
+};
+
+/* Flat scene, chains of 64 objects and roots with 1000 children */
+const Shape Shapes[] = {
+    {"flat", "depth=1"},
+    {"deep", "depth=64,fanout=1"},
+    {"wide", "depth=2,fanout=1000"}
+};
+
+enum: std::size_t {
+    Build,      /* Object and drawable creation */
+    Absolute,   /* absoluteTransformation() of each drawable */
+    Batch,      /* Scene::transformationMatrices() of all drawables */
+    Dispatch,   /* draw() of each drawable */
+    Draw,       /* The whole Camera3D::draw() */
+    PhaseCount
+};
+
+const char* PhaseNames[] = {"build", "absolute", "batch", "dispatch", "draw"};
+
+Double elapsedNanoseconds(Clock::time_point start) {
+    return std::chrono::duration<Double, std::nano>(Clock::now() - start).count();
+}
+
+/* Best time of a few runs, in nanoseconds */
+Double measure(const std::function<void()>& test) {
+    Double best = 0.0;
+    for(std::size_t i = 0; i != 5; ++i) {
+        const Clock::time_point start = Clock::now();
+        test();
+        const Double time = elapsedNanoseconds(start);
+        if(!i || time < best) best = time;
+    }
+    return best;
+}
+
+std::string resultKey(const char* shape, UnsignedInt objectCount, std::size_t phase) {
+    std::ostringstream out;
+    out << shape << ' ' << objectCount << ' ' << PhaseNames[phase];
+    return out.str();
+}
+
+}
+
+int benchmark(int argc, char** argv) {
+    UnsignedInt maxObjects = 1000000;
+    std::string saveFile, compareFile;
+    for(int i = 1; i != argc; ++i) {
+        if(std::strcmp(argv[i], "--max-objects") == 0 && i + 1 != argc && std::atoi(argv[i + 1]) >= 1000)
+            maxObjects = std::atoi(argv[++i]);
+        else if(std::strcmp(argv[i], "--save") == 0 && i + 1 != argc)
+            saveFile = argv[++i];
+        else if(std::strcmp(argv[i], "--compare") == 0 && i + 1 != argc)
+            compareFile = argv[++i];
+        else {
+            std::cout << "Usage: " << argv[0] << " [--max-objects N] [--save file.txt] [--compare file.txt]" << std::endl;
+            return 0;
+        }
+    }
+
+    /* Previous results, one "shape objects phase ns" per line */
+    std::map<std::string, Double> previous;
+    if(!compareFile.empty()) {
+        std::ifstream in(compareFile);
+        if(!in) {
+            Error() << "Cannot open" << compareFile;
+            return 1;
+        }
+        std::string shape, phase;
+        UnsignedInt objectCount;
+        Double time;
+        while(in >> shape >> objectCount >> phase >> time) {
+            std::ostringstream key;
+            key << shape << ' ' << objectCount << ' ' << phase;
+            previous[key.str()] = time;
+        }
+    }
+
+    std::ostringstream saved;
+    saved << std::setprecision(6);
+
+    std::cout << "ns per object, " << (previous.empty() ? "" : "change against " + compareFile + " in parentheses, ") << "best of 5 runs" << std::endl
+              << std::fixed << std::setprecision(2) << "shape      objects";
+    for(const char* name: PhaseNames) std::cout << std::setw(previous.empty() ? 12 : 22) << name;
+    std::cout << std::endl;
+
+    Float sink = 0.0f;
+    for(const Shape& shape: Shapes) for(UnsignedInt objectCount = 1000; objectCount <= maxObjects; objectCount *= 10) {
+        /* Generate the hierarchy upfront, so only the scene graph operations
+           are measured. Parents always precede their children. */
+        SceneGenerator generator;
+        generator.setOptions(shape.options);
+        generator.setObjectCount(objectCount)->generate();
+        std::vector<Int> parents(objectCount, -1);
+        std::vector<Matrix4> transformations(objectCount);
+        for(UnsignedInt id = 0; id != objectCount; ++id) {
+            std::unique_ptr<Trade::ObjectData3D> object(generator.object3D(id));
+            transformations[id] = object->transformation();
+            for(UnsignedInt child: object->children()) parents[child] = id;
+        }
+        generator.close();
+
+        Double times[PhaseCount];
+
+        std::unique_ptr<Scene3D> scene(new Scene3D);
+        SceneGraph::DrawableGroup3D<> drawables;
+        Object3D* cameraObject = new Object3D(scene.get());
+        cameraObject->translate(Vector3::zAxis(5.0f));
+        SceneGraph::Camera3D<>* camera = new SceneGraph::Camera3D<>(cameraObject);
+
+        Clock::time_point start = Clock::now();
+        std::vector<NoopDrawable*> objects(objectCount);
+        for(UnsignedInt id = 0; id != objectCount; ++id) {
+            objects[id] = new NoopDrawable(&sink, parents[id] == -1 ? static_cast<Object3D*>(scene.get()) : objects[parents[id]], &drawables);
+            objects[id]->setTransformation(transformations[id]);
+        }
+        times[Build] = elapsedNanoseconds(start);
+
+        times[Absolute] = measure([&]() {
+            const Matrix4 cameraMatrix = camera->cameraMatrix();
+            Float sum = 0.0f;
+            for(std::size_t i = 0; i != drawables.size(); ++i)
+                sum += (cameraMatrix*static_cast<NoopDrawable*>(drawables[i])->absoluteTransformation()).translation().z();
+            sink += sum;
+        });
+
+        std::vector<SceneGraph::AbstractObject3D<>*> drawableObjects(drawables.size());
+        for(std::size_t i = 0; i != drawables.size(); ++i)
+            drawableObjects[i] = drawables[i]->object();
+        SceneGraph::AbstractObject3D<>* root = scene.get();
+        times[Batch] = measure([&]() {
+            sink += root->transformationMatrices(drawableObjects, camera->cameraMatrix()).back().translation().z();
+        });
+
+        times[Dispatch] = measure([&]() {
+            const Matrix4 identity;
+            for(std::size_t i = 0; i != drawables.size(); ++i)
+                drawables[i]->draw(identity, camera);
+        });
+
+        times[Draw] = measure([&]() { camera->draw(drawables); });
+
+        std::cout << std::left << std::setw(6) << shape.name << std::right << std::setw(13) << objectCount;
+        for(std::size_t phase = 0; phase != PhaseCount; ++phase) {
+            const Double time = times[phase]/objectCount;
+            std::cout << std::setw(12) << time;
+            saved << resultKey(shape.name, objectCount, phase) << ' ' << time << '\n';
+
+            auto found = previous.find(resultKey(shape.name, objectCount, phase));
+            if(found != previous.end()) {
+                std::ostringstream change;
+                change << std::fixed << std::setprecision(1) << " (" << std::showpos << (time/found->second - 1.0)*100.0 << "%)";
+                std::cout << std::left << std::setw(10) << change.str() << std::right;
+            } else if(!previous.empty()) std::cout << std::setw(10) << "";
+        }
+        std::cout << std::endl;
+    }
+
+    /* So the compiler can't throw the draws away */
+    if(sink == 0.0f) std::cout << "Empty scene?" << std::endl;
+
+    if(!saveFile.empty()) {
+        std::ofstream out(saveFile);
+        if(!(out << saved.str())) {
+            Error() << "Cannot write" << saveFile;
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+}}
+
+int main(int argc, char** argv) {
+    return Magnum::Examples::benchmark(argc, argv);
+}
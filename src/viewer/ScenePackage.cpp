@@ -0,0 +1,251 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ScenePackage.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <Mesh.h>
+
+#include "ViewedObject.h"
+
+namespace Magnum { namespace Examples {
+
+namespace {
+    constexpr const char Magic[8] = {'M', 'G', 'N', 'S', 'C', 'P', 'K', '1'};
+
+    /* Mesh data alignment. Pages of larger size are still handled correctly,
+       only the neighboring meshes might then share a page. */
+    constexpr UnsignedLong PageSize = 4096;
+
+    /* Limit for degenerate cases, e.g. many instances at the same place */
+    constexpr std::size_t MaxDepth = 16;
+
+    inline UnsignedLong alignTo(UnsignedLong offset, UnsignedLong alignment) {
+        return (offset + alignment - 1)/alignment*alignment;
+    }
+
+    inline UnsignedInt octant(const Vector3& point, const Vector3& middle) {
+        return (point.x() >= middle.x() ? 1 : 0)|
+               (point.y() >= middle.y() ? 2 : 0)|
+               (point.z() >= middle.z() ? 4 : 0);
+    }
+
+    void buildNode(std::vector<ScenePackageNode>& nodes, std::vector<ScenePackageInstance>& instances, std::size_t id, std::size_t begin, std::size_t end, std::size_t maxInstances, std::size_t depth) {
+        ScenePackageNode node;
+        std::fill_n(node.children, 8, 0);
+        node.firstInstance = begin;
+        node.instanceCount = end - begin;
+        node.min = instances[begin].center - Vector3(instances[begin].radius);
+        node.max = instances[begin].center + Vector3(instances[begin].radius);
+        for(std::size_t i = begin + 1; i != end; ++i) for(std::size_t j = 0; j != 3; ++j) {
+            node.min[j] = std::min(node.min[j], instances[i].center[j] - instances[i].radius);
+            node.max[j] = std::max(node.max[j], instances[i].center[j] + instances[i].radius);
+        }
+        nodes[id] = node;
+
+        if(end - begin <= maxInstances || depth == MaxDepth) return;
+
+        /* Sort the instances into octants by their centers, so instances of
+           each child are contiguous */
+        const Vector3 middle = (node.min + node.max)*0.5f;
+        std::stable_sort(instances.begin() + begin, instances.begin() + end, [&middle](const ScenePackageInstance& a, const ScenePackageInstance& b) {
+            return octant(a.center, middle) < octant(b.center, middle);
+        });
+
+        /* All in the same octant, splitting wouldn't help */
+        if(octant(instances[begin].center, middle) == octant(instances[end - 1].center, middle))
+            return;
+
+        for(std::size_t first = begin; first != end; ) {
+            const UnsignedInt childOctant = octant(instances[first].center, middle);
+            std::size_t last = first + 1;
+            while(last != end && octant(instances[last].center, middle) == childOctant) ++last;
+
+            const std::size_t child = nodes.size();
+            nodes.emplace_back();
+            nodes[id].children[childOctant] = child;
+            buildNode(nodes, instances, child, first, last, maxInstances, depth + 1);
+            first = last;
+        }
+    }
+}
+
+bool writeScenePackage(const std::string& filename, const std::vector<ViewedObject*>& objects, const std::size_t maxInstancesPerNode) {
+    /* Gather unique meshes and instances */
+    std::unordered_map<ViewerMesh*, UnsignedInt> meshIds;
+    std::vector<ViewerMesh*> meshes;
+    std::vector<ScenePackageInstance> instances;
+    instances.reserve(objects.size());
+    for(ViewedObject* object: objects) {
+        ViewerMesh* mesh = object->viewerMesh();
+        if(!mesh->hasHostData()) {
+            Error() << "writeScenePackage(): data of mesh" << mesh->id << "are not in host memory";
+            return false;
+        }
+
+        auto found = meshIds.emplace(mesh, meshes.size());
+        if(found.second) meshes.push_back(mesh);
+
+        ScenePackageInstance instance;
+        instance.transformation = object->absoluteTransformation();
+        instance.ambientColor = object->ambientColor();
+        instance.diffuseColor = object->diffuseColor();
+        instance.specularColor = object->specularColor();
+        instance.shininess = object->shininess();
+        instance.mesh = found.first->second;
+
+        /* Largest axis scale, so the sphere contains the mesh also with
+           non-uniform scaling */
+        const Float scale = std::max({instance.transformation[0].xyz().length(),
+                                      instance.transformation[1].xyz().length(),
+                                      instance.transformation[2].xyz().length()});
+        instance.center = instance.transformation.transformPoint(mesh->center);
+        instance.radius = mesh->radius*scale;
+        instances.push_back(instance);
+    }
+
+    /* Octree over the instances */
+    std::vector<ScenePackageNode> nodes;
+    if(!instances.empty()) {
+        nodes.emplace_back();
+        buildNode(nodes, instances, 0, 0, instances.size(), maxInstancesPerNode, 0);
+    }
+
+    /* Mesh data layout, each mesh starts at page boundary */
+    std::vector<ScenePackageMesh> packageMeshes(meshes.size());
+    UnsignedLong offset = sizeof(ScenePackageHeader) +
+        meshes.size()*sizeof(ScenePackageMesh) +
+        instances.size()*sizeof(ScenePackageInstance) +
+        nodes.size()*sizeof(ScenePackageNode);
+    for(std::size_t i = 0; i != meshes.size(); ++i) {
+        const ViewerMesh* mesh = meshes[i];
+        ScenePackageMesh& packageMesh = packageMeshes[i];
+        packageMesh.vertexOffset = alignTo(offset, PageSize);
+        packageMesh.indexOffset = packageMesh.vertexOffset + mesh->vertexDataSize;
+        packageMesh.positionOffset = alignTo(packageMesh.indexOffset + mesh->indexCount*Mesh::indexSize(mesh->indexType), 4);
+        packageMesh.size = packageMesh.positionOffset + mesh->vertexCount*sizeof(Vector3) - packageMesh.vertexOffset;
+        packageMesh.vertexCount = mesh->vertexCount;
+        packageMesh.vertexDataSize = mesh->vertexDataSize;
+        packageMesh.indexCount = mesh->indexCount;
+        packageMesh.primitive = UnsignedInt(mesh->primitive);
+        packageMesh.indexType = UnsignedInt(mesh->indexType);
+        packageMesh.restartIndex = mesh->restartIndex;
+        packageMesh.center = mesh->center;
+        packageMesh.radius = mesh->radius;
+        offset = packageMesh.vertexOffset + packageMesh.size;
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if(!out.good()) {
+        Error() << "writeScenePackage(): cannot open" << filename;
+        return false;
+    }
+
+    ScenePackageHeader header;
+    std::copy_n(Magic, 8, header.magic);
+    header.meshCount = meshes.size();
+    header.instanceCount = instances.size();
+    header.nodeCount = nodes.size();
+    header.reserved = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(ScenePackageHeader));
+    out.write(reinterpret_cast<const char*>(packageMeshes.data()), packageMeshes.size()*sizeof(ScenePackageMesh));
+    out.write(reinterpret_cast<const char*>(instances.data()), instances.size()*sizeof(ScenePackageInstance));
+    out.write(reinterpret_cast<const char*>(nodes.data()), nodes.size()*sizeof(ScenePackageNode));
+
+    const char padding[PageSize]{};
+    for(std::size_t i = 0; i != meshes.size(); ++i) {
+        const ViewerMesh* mesh = meshes[i];
+        const ScenePackageMesh& packageMesh = packageMeshes[i];
+        out.write(padding, packageMesh.vertexOffset - UnsignedLong(out.tellp()));
+        out.write(mesh->vertexData.get(), mesh->vertexDataSize);
+        out.write(mesh->indexData.get(), mesh->indexCount*Mesh::indexSize(mesh->indexType));
+        out.write(padding, packageMesh.positionOffset - UnsignedLong(out.tellp()));
+        out.write(reinterpret_cast<const char*>(mesh->positions.data()), mesh->vertexCount*sizeof(Vector3));
+    }
+
+    if(!out.good()) {
+        Error() << "writeScenePackage(): cannot write" << filename;
+        return false;
+    }
+
+    Debug() << "Written scene package" << filename << "with" << meshes.size() << "meshes," << instances.size() << "instances and" << nodes.size() << "octree nodes," << offset/1024 << "kB";
+    return true;
+}
+
+ScenePackage::ScenePackage(const std::string& filename): file(filename), valid(false) {
+    if(!file.isOpen()) return;
+
+    if(file.size() < sizeof(ScenePackageHeader) || std::memcmp(header()->magic, Magic, 8) != 0) {
+        Error() << "ScenePackage:" << filename << "is not a scene package";
+        return;
+    }
+
+    const UnsignedLong tableSize = sizeof(ScenePackageHeader) +
+        UnsignedLong(meshCount())*sizeof(ScenePackageMesh) +
+        UnsignedLong(instanceCount())*sizeof(ScenePackageInstance) +
+        UnsignedLong(nodeCount())*sizeof(ScenePackageNode);
+    if(tableSize > file.size()) {
+        Error() << "ScenePackage:" << filename << "is truncated";
+        return;
+    }
+
+    /* Check that all the data are inside the file and all references are
+       valid, so nothing needs to be checked later */
+    for(std::size_t i = 0; i != meshCount(); ++i) {
+        const ScenePackageMesh& m = mesh(i);
+        const Mesh::IndexType indexType = Mesh::IndexType(m.indexType);
+        if((indexType != Mesh::IndexType::UnsignedByte && indexType != Mesh::IndexType::UnsignedShort && indexType != Mesh::IndexType::UnsignedInt) ||
+           m.vertexOffset < tableSize || m.size > file.size() || m.vertexOffset > file.size() - m.size ||
+           m.indexOffset < m.vertexOffset + m.vertexDataSize ||
+           m.positionOffset < m.indexOffset + UnsignedLong(m.indexCount)*Mesh::indexSize(indexType) ||
+           m.positionOffset + UnsignedLong(m.vertexCount)*sizeof(Vector3) > m.vertexOffset + m.size) {
+            Error() << "ScenePackage: invalid mesh" << i << "in" << filename;
+            return;
+        }
+    }
+
+    for(std::size_t i = 0; i != instanceCount(); ++i) if(instance(i).mesh >= meshCount()) {
+        Error() << "ScenePackage: invalid instance" << i << "in" << filename;
+        return;
+    }
+
+    /* Children always have larger index than parent, so there are no cycles */
+    for(std::size_t i = 0; i != nodeCount(); ++i) {
+        const ScenePackageNode& n = node(i);
+        bool invalid = UnsignedLong(n.firstInstance) + n.instanceCount > instanceCount();
+        for(UnsignedInt child: n.children)
+            if(child && (child <= i || child >= nodeCount())) invalid = true;
+        if(invalid) {
+            Error() << "ScenePackage: invalid octree node" << i << "in" << filename;
+            return;
+        }
+    }
+
+    valid = true;
+}
+
+}}
@@ -0,0 +1,190 @@
+#ifndef Magnum_Examples_ScenePackage_h
+#define Magnum_Examples_ScenePackage_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <vector>
+#include <Math/Matrix4.h>
+#include <Magnum.h>
+
+#include "common/MappedFile.h"
+
+namespace Magnum { namespace Examples {
+
+class ViewedObject;
+
+/*
+    Scene package file layout, all in native byte order:
+
+    ScenePackageHeader
+    ScenePackageMesh[meshCount]
+    ScenePackageInstance[instanceCount]
+    ScenePackageNode[nodeCount]
+    mesh data, each mesh starting at page boundary
+*/
+
+/** @brief Scene package header */
+struct ScenePackageHeader {
+    char magic[8];              /**< @brief `MGNSCPK` and version */
+    UnsignedInt meshCount;      /**< @brief Mesh count */
+    UnsignedInt instanceCount;  /**< @brief Instance count */
+    UnsignedInt nodeCount;      /**< @brief Octree node count */
+    UnsignedInt reserved;
+};
+
+/**
+@brief Mesh in scene package
+
+Processed mesh data, ready for upload. Vertex data are interleaved positions
+and normals, index data are followed by separate positions for depth-only
+passes. The data of each mesh are aligned to page size, so they can be paged
+in and out independently.
+*/
+struct ScenePackageMesh {
+    UnsignedLong vertexOffset;      /**< @brief Offset of vertex data */
+    UnsignedLong indexOffset;       /**< @brief Offset of index data */
+    UnsignedLong positionOffset;    /**< @brief Offset of positions */
+    UnsignedLong size;              /**< @brief Size of all mesh data */
+    UnsignedInt vertexCount;        /**< @brief Vertex count */
+    UnsignedInt vertexDataSize;     /**< @brief Vertex data size */
+    UnsignedInt indexCount;         /**< @brief Index count */
+    UnsignedInt primitive;          /**< @brief Mesh::Primitive value */
+    UnsignedInt indexType;          /**< @brief Mesh::IndexType value */
+    UnsignedInt restartIndex;       /**< @brief Primitive restart index or 0 */
+    Vector3 center;                 /**< @brief Bounding sphere center */
+    Float radius;                   /**< @brief Bounding sphere radius */
+};
+
+/** @brief Mesh instance in scene package */
+struct ScenePackageInstance {
+    Matrix4 transformation;         /**< @brief Transformation */
+    Vector3 ambientColor;           /**< @brief Ambient color */
+    Vector3 diffuseColor;           /**< @brief Diffuse color */
+    Vector3 specularColor;          /**< @brief Specular color */
+    Float shininess;                /**< @brief Shininess */
+    UnsignedInt mesh;               /**< @brief Mesh index */
+    Vector3 center;                 /**< @brief Transformed bounding sphere center */
+    Float radius;                   /**< @brief Transformed bounding sphere radius */
+};
+
+/**
+@brief Octree node in scene package
+
+Instances of each node are contiguous range, which contains instances of all
+its children. Only leaf nodes have instances which are not in any child.
+*/
+struct ScenePackageNode {
+    Vector3 min;                    /**< @brief Bounding box minimum */
+    Vector3 max;                    /**< @brief Bounding box maximum */
+    UnsignedInt children[8];        /**< @brief Child nodes, `0` if not present */
+    UnsignedInt firstInstance;      /**< @brief First instance */
+    UnsignedInt instanceCount;      /**< @brief Instance count */
+};
+
+/**
+@brief Write scene package
+@param filename             Output file
+@param objects              Objects to write
+@param maxInstancesPerNode  Max instance count in octree leaf
+
+Meshes of all objects are expected to have processed data in host memory,
+see ViewerMesh::hasHostData(). Meshes shared by more objects are written only
+once. Object transformations are taken relative to the scene root. Returns
+`false` on error.
+*/
+bool writeScenePackage(const std::string& filename, const std::vector<ViewedObject*>& objects, std::size_t maxInstancesPerNode = 64);
+
+/**
+@brief Scene package
+
+Memory-mapped scene package file. The mesh data are not read until accessed,
+so the package can be larger than host memory. See SceneStreamer for paging
+the data in and out.
+*/
+class ScenePackage {
+    public:
+        /**
+         * @brief Constructor
+         *
+         * Maps and validates the file. If the file cannot be opened or is
+         * not a valid package, prints error message and isOpen() returns
+         * `false`.
+         */
+        explicit ScenePackage(const std::string& filename);
+
+        /** @brief Whether the package is open */
+        inline bool isOpen() const { return valid; }
+
+        /** @brief Mesh count */
+        inline std::size_t meshCount() const { return header()->meshCount; }
+
+        /** @brief Mesh */
+        inline const ScenePackageMesh& mesh(std::size_t id) const {
+            return reinterpret_cast<const ScenePackageMesh*>(file.data() + sizeof(ScenePackageHeader))[id];
+        }
+
+        /** @brief Instance count */
+        inline std::size_t instanceCount() const { return header()->instanceCount; }
+
+        /** @brief Instance */
+        inline const ScenePackageInstance& instance(std::size_t id) const {
+            return reinterpret_cast<const ScenePackageInstance*>(file.data() + sizeof(ScenePackageHeader) + meshCount()*sizeof(ScenePackageMesh))[id];
+        }
+
+        /** @brief Octree node count */
+        inline std::size_t nodeCount() const { return header()->nodeCount; }
+
+        /** @brief Octree node, root has index `0` */
+        inline const ScenePackageNode& node(std::size_t id) const {
+            return reinterpret_cast<const ScenePackageNode*>(file.data() + sizeof(ScenePackageHeader) + meshCount()*sizeof(ScenePackageMesh) + instanceCount()*sizeof(ScenePackageInstance))[id];
+        }
+
+        /** @brief Data at given offset */
+        inline const char* data(UnsignedLong offset) const {
+            return file.data() + offset;
+        }
+
+        /** @brief Hint that data of given mesh will be needed soon */
+        inline void prefetch(std::size_t id) {
+            file.adviseWillNeed(mesh(id).vertexOffset, mesh(id).size);
+        }
+
+        /** @brief Release data of given mesh from host memory */
+        inline void evict(std::size_t id) {
+            file.adviseDontNeed(mesh(id).vertexOffset, mesh(id).size);
+        }
+
+    private:
+        inline const ScenePackageHeader* header() const {
+            return reinterpret_cast<const ScenePackageHeader*>(file.data());
+        }
+
+        MappedFile file;
+        bool valid;
+};
+
+}}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SceneStreamer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "DrawListCamera.h"
+#include "ScenePackage.h"
+#include "ViewedObject.h"
+#include "ViewerMesh.h"
+
+namespace Magnum { namespace Examples {
+
+SceneStreamer::SceneStreamer(ScenePackage& package, std::vector<ViewerMesh*> meshes): package(package), meshes(std::move(meshes)), states(this->meshes.size()), meshInstances(this->meshes.size()), ramBudget(std::size_t(1024)*1024*1024), vramBudget(512*1024*1024), resident(0), uploaded(0), prefetched(0), evicted(0), released(0), frame(1), prefetchDistance(0.0f), prefetchFrames(30.0f), hasPreviousPosition(false) {
+    for(std::size_t i = 0; i != package.instanceCount(); ++i)
+        meshInstances[package.instance(i).mesh].push_back(i);
+
+    if(package.nodeCount())
+        prefetchDistance = (package.node(0).max - package.node(0).min).length()/4.0f;
+}
+
+std::size_t SceneStreamer::upload(ViewerMesh* mesh) {
+    const ScenePackageMesh& packageMesh = package.mesh(mesh->id);
+
+    /* Reading the data pages them in, if they weren't prefetched */
+    MeshState& state = states[mesh->id];
+    if(!state.resident) {
+        state.resident = true;
+        resident += packageMesh.size;
+    }
+    state.lastUsed = frame;
+
+    const std::size_t size = mesh->upload(package.data(packageMesh.vertexOffset),
+                                          package.data(packageMesh.indexOffset),
+                                          reinterpret_cast<const Vector3*>(package.data(packageMesh.positionOffset)));
+    uploaded += size;
+    return size;
+}
+
+void SceneStreamer::update(const std::vector<DrawCommand>& drawList, const Vector3& cameraPosition) {
+    for(const DrawCommand& command: drawList) {
+        MeshState& state = states[command.object->viewerMesh()->id];
+        state.lastUsed = state.lastVisible = frame;
+    }
+
+    /* Predict camera position from its motion in last frame */
+    Vector3 predictedPosition = cameraPosition;
+    if(hasPreviousPosition)
+        predictedPosition += (cameraPosition - previousPosition)*prefetchFrames;
+    previousPosition = cameraPosition;
+    hasPreviousPosition = true;
+
+    /* Meshes near current and predicted position, nearest first */
+    nearby.clear();
+    collectNearby(cameraPosition, nearby);
+    if(predictedPosition != cameraPosition)
+        collectNearby(predictedPosition, nearby);
+    std::sort(nearby.begin(), nearby.end(), [this](UnsignedInt a, UnsignedInt b) {
+        return states[a].distance < states[b].distance;
+    });
+
+    /* Make room for the ones not yet in memory */
+    std::size_t needed = 0;
+    for(UnsignedInt id: nearby) {
+        states[id].lastUsed = frame;
+        if(!states[id].resident) needed += package.mesh(id).size;
+    }
+    if(resident + needed > ramBudget)
+        evict(resident + needed - ramBudget, cameraPosition);
+
+    /* Prefetch as many as fit into the budget */
+    for(UnsignedInt id: nearby) {
+        if(states[id].resident) continue;
+
+        const std::size_t size = package.mesh(id).size;
+        if(resident + size > ramBudget) break;
+
+        package.prefetch(id);
+        states[id].resident = true;
+        resident += size;
+        ++prefetched;
+    }
+
+    releaseOverBudget(cameraPosition);
+
+    ++frame;
+}
+
+void SceneStreamer::collectNearby(const Vector3& position, std::vector<UnsignedInt>& out) {
+    if(!package.nodeCount()) return;
+
+    std::vector<UnsignedInt> stack{0};
+    while(!stack.empty()) {
+        const ScenePackageNode& node = package.node(stack.back());
+        stack.pop_back();
+
+        /* Distance from the node bounding box */
+        Vector3 offset;
+        for(std::size_t i = 0; i != 3; ++i)
+            offset[i] = std::max({node.min[i] - position[i], 0.0f, position[i] - node.max[i]});
+        if(offset.length() > prefetchDistance) continue;
+
+        bool leaf = true;
+        for(UnsignedInt child: node.children) if(child) {
+            stack.push_back(child);
+            leaf = false;
+        }
+        if(!leaf) continue;
+
+        /* Nearest instance of each mesh */
+        for(std::size_t i = node.firstInstance; i != node.firstInstance + node.instanceCount; ++i) {
+            const ScenePackageInstance& instance = package.instance(i);
+            const Float distance = std::max((instance.center - position).length() - instance.radius, 0.0f);
+            if(distance > prefetchDistance) continue;
+
+            /* Mesh can be instanced more times, keep the nearest distance */
+            MeshState& state = states[instance.mesh];
+            if(state.lastNearby != frame) {
+                state.lastNearby = frame;
+                state.distance = distance;
+                out.push_back(instance.mesh);
+            } else state.distance = std::min(state.distance, distance);
+        }
+    }
+}
+
+void SceneStreamer::evict(std::size_t bytes, const Vector3& cameraPosition) {
+    std::vector<UnsignedInt> candidates;
+    for(std::size_t i = 0; i != states.size(); ++i) if(states[i].resident && states[i].lastUsed != frame) {
+        states[i].distance = distance(i, cameraPosition);
+        candidates.push_back(i);
+    }
+
+    /* Least recently used first, farthest first for the same frame */
+    std::sort(candidates.begin(), candidates.end(), [this](UnsignedInt a, UnsignedInt b) {
+        if(states[a].lastUsed != states[b].lastUsed)
+            return states[a].lastUsed < states[b].lastUsed;
+        return states[a].distance > states[b].distance;
+    });
+
+    std::size_t freed = 0;
+    for(UnsignedInt id: candidates) {
+        if(freed >= bytes) break;
+
+        const std::size_t size = package.mesh(id).size;
+        package.evict(id);
+        states[id].resident = false;
+        resident -= size;
+        freed += size;
+        ++evicted;
+    }
+}
+
+void SceneStreamer::releaseOverBudget(const Vector3& cameraPosition) {
+    if(uploaded <= vramBudget) return;
+
+    std::vector<UnsignedInt> candidates;
+    for(std::size_t i = 0; i != meshes.size(); ++i) if(meshes[i]->isUploaded() && states[i].lastVisible != frame) {
+        states[i].distance = distance(i, cameraPosition);
+        candidates.push_back(i);
+    }
+
+    /* Least recently visible first, farthest first for the same frame */
+    std::sort(candidates.begin(), candidates.end(), [this](UnsignedInt a, UnsignedInt b) {
+        if(states[a].lastVisible != states[b].lastVisible)
+            return states[a].lastVisible < states[b].lastVisible;
+        return states[a].distance > states[b].distance;
+    });
+
+    for(UnsignedInt id: candidates) {
+        if(uploaded <= vramBudget) break;
+
+        uploaded -= meshes[id]->release();
+        ++released;
+    }
+}
+
+Float SceneStreamer::distance(UnsignedInt mesh, const Vector3& position) const {
+    Float distance = std::numeric_limits<Float>::infinity();
+    for(UnsignedInt i: meshInstances[mesh]) {
+        const ScenePackageInstance& instance = package.instance(i);
+        distance = std::min(distance, (instance.center - position).length() - instance.radius);
+    }
+    return std::max(distance, 0.0f);
+}
+
+}}
@@ -0,0 +1,172 @@
+#ifndef Magnum_Examples_SceneStreamer_h
+#define Magnum_Examples_SceneStreamer_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <vector>
+#include <Magnum.h>
+#include <Math/Vector3.h>
+
+namespace Magnum { namespace Examples {
+
+struct DrawCommand;
+class ScenePackage;
+struct ViewerMesh;
+
+/**
+@brief Out-of-core streaming of scene package
+
+Pages mesh data of memory-mapped @ref ScenePackage in and out of host memory
+and uploads and releases them on GPU, each within separate budget.
+
+Visible meshes are uploaded by @ref DrawListCamera, which calls upload(),
+limited by its per-frame upload budget. Each frame update() then:
+
+-   prefetches data of meshes within prefetch distance from the camera
+    position extrapolated along the camera motion, nearest first, so the
+    data are already in host memory when they become visible,
+-   releases host memory of meshes which weren't needed for the longest time
+    and are farthest away, if the prefetch would exceed host memory budget,
+-   releases GPU memory of meshes which weren't visible for the longest time
+    and are farthest away, if uploaded meshes exceed GPU memory budget.
+
+Meshes needed in current frame are never released, so the budgets can be
+exceeded if they aren't enough for the visible part of the scene. Host memory
+usage is counted for prefetched and uploaded meshes, the OS might page the
+data in earlier (e.g. with read-ahead) or out sooner under memory pressure.
+*/
+class SceneStreamer {
+    public:
+        /**
+         * @brief Constructor
+         * @param package   Scene package
+         * @param meshes    Meshes created from the package, index in the
+         *      list is the mesh index in the package
+         */
+        explicit SceneStreamer(ScenePackage& package, std::vector<ViewerMesh*> meshes);
+
+        /**
+         * @brief Set host memory budget
+         *
+         * Default is 1 GB.
+         */
+        inline SceneStreamer* setRamBudget(std::size_t bytes) {
+            ramBudget = bytes;
+            return this;
+        }
+
+        /**
+         * @brief Set GPU memory budget
+         *
+         * Default is 512 MB.
+         */
+        inline SceneStreamer* setVramBudget(std::size_t bytes) {
+            vramBudget = bytes;
+            return this;
+        }
+
+        /**
+         * @brief Set prefetch distance
+         *
+         * Data of meshes closer to predicted camera position are prefetched.
+         * Default is quarter of scene bounding box diagonal.
+         */
+        inline SceneStreamer* setPrefetchDistance(Float distance) {
+            prefetchDistance = distance;
+            return this;
+        }
+
+        /**
+         * @brief Set prefetch frame count
+         *
+         * How many frames ahead the camera position is predicted. Default
+         * is `30`.
+         */
+        inline SceneStreamer* setPrefetchFrames(Float frames) {
+            prefetchFrames = frames;
+            return this;
+        }
+
+        /** @brief Size of mesh data in host memory */
+        inline std::size_t residentSize() const { return resident; }
+
+        /** @brief Size of mesh data on GPU */
+        inline std::size_t uploadedSize() const { return uploaded; }
+
+        /** @brief Count of meshes prefetched to host memory so far */
+        inline std::size_t prefetchCount() const { return prefetched; }
+
+        /** @brief Count of meshes released from host memory so far */
+        inline std::size_t evictionCount() const { return evicted; }
+
+        /** @brief Count of meshes released from GPU memory so far */
+        inline std::size_t releaseCount() const { return released; }
+
+        /**
+         * @brief Upload mesh
+         *
+         * Uploads mesh data directly from the mapped file. Returns uploaded
+         * size in bytes.
+         */
+        std::size_t upload(ViewerMesh* mesh);
+
+        /**
+         * @brief Update residency
+         * @param drawList          Draw list of current frame
+         * @param cameraPosition    Camera position relative to the package
+         *      root
+         *
+         * Expected to be called once per frame after drawing.
+         */
+        void update(const std::vector<DrawCommand>& drawList, const Vector3& cameraPosition);
+
+    private:
+        struct MeshState {
+            inline MeshState(): lastUsed(0), lastVisible(0), lastNearby(0), distance(0.0f), resident(false) {}
+
+            std::size_t lastUsed, lastVisible, lastNearby;
+            Float distance;
+            bool resident;
+        };
+
+        void collectNearby(const Vector3& position, std::vector<UnsignedInt>& out);
+        void evict(std::size_t bytes, const Vector3& cameraPosition);
+        void releaseOverBudget(const Vector3& cameraPosition);
+        Float distance(UnsignedInt mesh, const Vector3& position) const;
+
+        ScenePackage& package;
+        std::vector<ViewerMesh*> meshes;
+        std::vector<MeshState> states;
+        std::vector<std::vector<UnsignedInt>> meshInstances;
+        std::vector<UnsignedInt> nearby;
+
+        std::size_t ramBudget, vramBudget, resident, uploaded, prefetched, evicted, released, frame;
+        Float prefetchDistance, prefetchFrames;
+        Vector3 previousPosition;
+        bool hasPreviousPosition;
+};
+
+}}
+
+#endif
@@ -0,0 +1,203 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "TriangleStrips.h"
+
+#include <cstring>
+
+namespace Magnum { namespace Examples {
+
+namespace {
+
+constexpr UnsignedInt Committed = 1;
+
+class Stripifier {
+    public:
+        Stripifier(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t maxLength);
+
+        void run(std::vector<UnsignedInt>& strips);
+
+    private:
+        bool next(UnsignedInt a, UnsignedInt b, UnsignedInt marker, UnsignedInt& triangle, UnsignedInt& c) const;
+        std::size_t grow(UnsignedInt triangle, UnsignedInt rotation, UnsignedInt marker, std::vector<UnsignedInt>* strips);
+
+        const std::vector<UnsignedInt>& indices;
+        const std::size_t maxLength;
+
+        /* Triangles adjacent to each vertex */
+        std::vector<UnsignedInt> adjacencyOffset, adjacency;
+
+        /* Committed or last trial marker for each triangle */
+        std::vector<UnsignedInt> visited;
+};
+
+Stripifier::Stripifier(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t maxLength): indices(indices), maxLength(maxLength), adjacencyOffset(vertexCount + 1), adjacency(indices.size()), visited(indices.size()/3) {
+    for(UnsignedInt index: indices) ++adjacencyOffset[index + 1];
+    for(std::size_t i = 0; i != vertexCount; ++i)
+        adjacencyOffset[i + 1] += adjacencyOffset[i];
+
+    std::vector<UnsignedInt> position(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for(std::size_t i = 0; i != indices.size(); ++i)
+        adjacency[position[indices[i]]++] = i/3;
+}
+
+/* Find not yet visited triangle with directed edge a -> b and its third vertex */
+bool Stripifier::next(UnsignedInt a, UnsignedInt b, UnsignedInt marker, UnsignedInt& triangle, UnsignedInt& c) const {
+    for(std::size_t i = adjacencyOffset[a]; i != adjacencyOffset[a + 1]; ++i) {
+        const UnsignedInt t = adjacency[i];
+        if(visited[t] == Committed || visited[t] == marker) continue;
+
+        for(std::size_t j = 0; j != 3; ++j) {
+            if(indices[t*3 + j] != a || indices[t*3 + (j + 1)%3] != b) continue;
+            triangle = t;
+            c = indices[t*3 + (j + 2)%3];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Grows strip from given triangle and rotation, returns its triangle count.
+   If strips is not null, the strip is committed and appended to it. */
+std::size_t Stripifier::grow(UnsignedInt triangle, UnsignedInt rotation, UnsignedInt marker, std::vector<UnsignedInt>* strips) {
+    UnsignedInt a = indices[triangle*3 + rotation];
+    UnsignedInt b = indices[triangle*3 + (rotation + 1)%3];
+    const UnsignedInt c = indices[triangle*3 + (rotation + 2)%3];
+    visited[triangle] = marker;
+    if(strips) {
+        if(!strips->empty()) strips->push_back(StripRestart);
+        strips->insert(strips->end(), {a, b, c});
+    }
+
+    /* Even triangles in the strip are (a, b, c), odd ones (b, a, c) */
+    std::size_t count = 1;
+    a = b;
+    b = c;
+    for(UnsignedInt t, next; count != maxLength && (count % 2 ? this->next(b, a, marker, t, next) : this->next(a, b, marker, t, next)); ++count) {
+        visited[t] = marker;
+        if(strips) strips->push_back(next);
+        a = b;
+        b = next;
+    }
+
+    return count;
+}
+
+void Stripifier::run(std::vector<UnsignedInt>& strips) {
+    UnsignedInt marker = Committed;
+    for(UnsignedInt triangle = 0; triangle != visited.size(); ++triangle) {
+        if(visited[triangle] == Committed) continue;
+
+        /* Try all three rotations, each with its own marker, so the trial
+           doesn't need to be undone */
+        UnsignedInt best = 0;
+        std::size_t bestCount = 0;
+        for(UnsignedInt rotation = 0; rotation != 3; ++rotation) {
+            const std::size_t count = grow(triangle, rotation, ++marker, nullptr);
+            if(count > bestCount) {
+                best = rotation;
+                bestCount = count;
+            }
+        }
+
+        grow(triangle, best, Committed, &strips);
+    }
+}
+
+}
+
+std::vector<UnsignedInt> stripify(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t maxLength) {
+    std::vector<UnsignedInt> strips;
+    strips.reserve(indices.size()/2);
+    Stripifier(indices, vertexCount, maxLength).run(strips);
+    return strips;
+}
+
+std::vector<UnsignedInt> unstripify(const std::vector<UnsignedInt>& strips) {
+    std::vector<UnsignedInt> indices;
+    std::size_t begin = 0;
+    for(std::size_t i = 0; i <= strips.size(); ++i) {
+        if(i != strips.size() && strips[i] != StripRestart) continue;
+
+        for(std::size_t j = begin; j + 2 < i; ++j) {
+            if((j - begin) % 2) indices.insert(indices.end(), {strips[j + 1], strips[j], strips[j + 2]});
+            else indices.insert(indices.end(), {strips[j], strips[j + 1], strips[j + 2]});
+        }
+        begin = i + 1;
+    }
+
+    return indices;
+}
+
+std::tuple<std::size_t, Mesh::IndexType, char*> compressStripIndices(const std::vector<UnsignedInt>& strips, UnsignedInt vertexCount) {
+    Mesh::IndexType type;
+    if(vertexCount <= 0xFF) type = Mesh::IndexType::UnsignedByte;
+    else if(vertexCount <= 0xFFFF) type = Mesh::IndexType::UnsignedShort;
+    else type = Mesh::IndexType::UnsignedInt;
+
+    const std::size_t size = Mesh::indexSize(type);
+    const UnsignedInt restart = stripRestartIndex(type);
+    char* data = new char[strips.size()*size];
+    for(std::size_t i = 0; i != strips.size(); ++i) {
+        const UnsignedInt index = strips[i] == StripRestart ? restart : strips[i];
+        if(type == Mesh::IndexType::UnsignedByte) {
+            const UnsignedByte value = index;
+            std::memcpy(data + i*size, &value, size);
+        } else if(type == Mesh::IndexType::UnsignedShort) {
+            const UnsignedShort value = index;
+            std::memcpy(data + i*size, &value, size);
+        } else std::memcpy(data + i*size, &index, size);
+    }
+
+    return std::make_tuple(strips.size(), type, data);
+}
+
+UnsignedInt stripRestartIndex(Mesh::IndexType type) {
+    switch(type) {
+        case Mesh::IndexType::UnsignedByte: return 0xFF;
+        case Mesh::IndexType::UnsignedShort: return 0xFFFF;
+        case Mesh::IndexType::UnsignedInt: return 0xFFFFFFFF;
+    }
+
+    return 0;
+}
+
+void usePrimitiveRestart(UnsignedInt index) {
+    #ifndef MAGNUM_TARGET_GLES
+    static UnsignedInt current = 0;
+    if(index == current) return;
+
+    if(!index) glDisable(GL_PRIMITIVE_RESTART);
+    else {
+        if(!current) glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(index);
+    }
+    current = index;
+    #else
+    static_cast<void>(index);
+    #endif
+}
+
+}}
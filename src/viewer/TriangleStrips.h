@@ -0,0 +1,84 @@
+#ifndef Magnum_Examples_TriangleStrips_h
+#define Magnum_Examples_TriangleStrips_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <tuple>
+#include <vector>
+#include <Mesh.h>
+
+namespace Magnum { namespace Examples {
+
+/** @brief Strip restart marker in output of stripify() */
+constexpr UnsignedInt StripRestart = ~UnsignedInt(0);
+
+/**
+@brief Convert triangle list to triangle strips
+@param indices      Triangle indices
+@param vertexCount  Vertex count
+
+Greedily grows strips from triangles in the original order, so the vertex
+cache optimized order is mostly preserved. For each starting triangle the
+rotation producing the longest strip is chosen. Triangle winding is
+preserved. Strips are separated with @ref StripRestart.
+*/
+std::vector<UnsignedInt> stripify(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t maxLength);
+
+/**
+@brief Convert triangle strips back to triangle list
+
+Inverse of stripify(), useful for analysis of the strip triangle order, e.g.
+with simulateVertexCache().
+*/
+std::vector<UnsignedInt> unstripify(const std::vector<UnsignedInt>& strips);
+
+/**
+@brief Compress strip indices
+@param strips       Strip indices separated with @ref StripRestart
+@param vertexCount  Vertex count
+@return Index count, type and data. Data are meant to be deleted with
+    `delete[]`.
+
+Chooses the smallest type which has its max value free for use as primitive
+restart index, the @ref StripRestart markers are replaced with it. See
+stripRestartIndex().
+*/
+std::tuple<std::size_t, Mesh::IndexType, char*> compressStripIndices(const std::vector<UnsignedInt>& strips, UnsignedInt vertexCount);
+
+/** @brief Primitive restart index for given index type */
+UnsignedInt stripRestartIndex(Mesh::IndexType type);
+
+/**
+@brief Set primitive restart index for following draws
+@param index    Restart index or `0` to disable primitive restart
+
+The state is global, it is changed only if different from the previous call.
+Primitive restart is not available on OpenGL ES 2, there this function does
+nothing.
+*/
+void usePrimitiveRestart(UnsignedInt index);
+
+}}
+
+#endif
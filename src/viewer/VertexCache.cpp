@@ -0,0 +1,227 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "VertexCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <MeshTools/Tipsify.h>
+
+namespace Magnum { namespace Examples {
+
+VertexCacheStatistics simulateVertexCache(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, VertexCachePolicy policy, std::size_t cacheSize) {
+    std::size_t misses = 0;
+    std::vector<bool> referenced(vertexCount);
+
+    /* FIFO: vertex is in the cache if less than cacheSize misses happened
+       since it was inserted */
+    if(policy == VertexCachePolicy::Fifo) {
+        std::vector<std::size_t> insertedAt(vertexCount, ~std::size_t(0));
+        for(UnsignedInt index: indices) {
+            referenced[index] = true;
+            if(insertedAt[index] != ~std::size_t(0) && misses - insertedAt[index] < cacheSize) continue;
+
+            insertedAt[index] = misses;
+            ++misses;
+        }
+
+    /* LRU: most recently used vertex at the front */
+    } else {
+        std::vector<UnsignedInt> cache;
+        cache.reserve(cacheSize + 1);
+        for(UnsignedInt index: indices) {
+            referenced[index] = true;
+            auto found = std::find(cache.begin(), cache.end(), index);
+            if(found != cache.end()) cache.erase(found);
+            else ++misses;
+
+            cache.insert(cache.begin(), index);
+            if(cache.size() > cacheSize) cache.pop_back();
+        }
+    }
+
+    const std::size_t referencedCount = std::count(referenced.begin(), referenced.end(), true);
+    return {indices.empty() ? 0.0f : Float(misses)/(indices.size()/3),
+            referencedCount ? Float(misses)/referencedCount : 0.0f};
+}
+
+namespace {
+    /* Constants from the original paper */
+    constexpr Float CacheDecayPower = 1.5f;
+    constexpr Float LastTriangleScore = 0.75f;
+    constexpr Float ValenceBoostScale = 2.0f;
+    constexpr Float ValenceBoostPower = 0.5f;
+
+    Float forsythScore(Int cachePosition, UnsignedInt remainingTriangles, std::size_t cacheSize) {
+        /* No triangles left, the vertex doesn't matter anymore */
+        if(!remainingTriangles) return -1.0f;
+
+        Float score = 0.0f;
+
+        /* Vertices of the last triangle have fixed score, so it doesn't
+           matter in which order they were added */
+        if(cachePosition >= 0) {
+            if(cachePosition < 3) score = LastTriangleScore;
+            else score = std::pow(1.0f - Float(cachePosition - 3)/(cacheSize - 3), CacheDecayPower);
+        }
+
+        /* Boost vertices with only a few triangles left, so lone triangles
+           don't stay behind */
+        return score + ValenceBoostScale*std::pow(Float(remainingTriangles), -ValenceBoostPower);
+    }
+}
+
+void optimizeForsyth(std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t cacheSize) {
+    const std::size_t triangleCount = indices.size()/3;
+    if(!triangleCount || cacheSize <= 3) return;
+
+    /* Triangles adjacent to each vertex, vertex i has remaining[i] triangles
+       starting at offsets[i] */
+    std::vector<UnsignedInt> offsets(vertexCount + 1);
+    for(UnsignedInt index: indices) ++offsets[index + 1];
+    for(std::size_t i = 0; i != vertexCount; ++i) offsets[i + 1] += offsets[i];
+    std::vector<UnsignedInt> adjacency(indices.size());
+    std::vector<UnsignedInt> remaining(vertexCount);
+    for(std::size_t i = 0; i != indices.size(); ++i) {
+        const UnsignedInt vertex = indices[i];
+        adjacency[offsets[vertex] + remaining[vertex]++] = i/3;
+    }
+
+    std::vector<Int> cachePosition(vertexCount, -1);
+    std::vector<Float> vertexScore(vertexCount);
+    for(std::size_t i = 0; i != vertexCount; ++i)
+        vertexScore[i] = forsythScore(-1, remaining[i], cacheSize);
+
+    auto triangleScore = [&](std::size_t triangle) {
+        return vertexScore[indices[triangle*3]] + vertexScore[indices[triangle*3 + 1]] + vertexScore[indices[triangle*3 + 2]];
+    };
+
+    /* Start with the best triangle overall */
+    Int best = 0;
+    Float bestScore = triangleScore(0);
+    for(std::size_t i = 1; i != triangleCount; ++i) {
+        const Float score = triangleScore(i);
+        if(score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount);
+    std::vector<UnsignedInt> cache, newCache, output;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+    output.reserve(indices.size());
+    std::size_t nextUnemitted = 0;
+
+    while(output.size() != indices.size()) {
+        /* Nothing in the cache has any triangles left, continue with first
+           triangle not yet emitted */
+        if(best == -1) {
+            while(emitted[nextUnemitted]) ++nextUnemitted;
+            best = nextUnemitted;
+        }
+
+        /* Emit the triangle and remove it from adjacency of its vertices */
+        emitted[best] = true;
+        newCache.clear();
+        for(std::size_t i = 0; i != 3; ++i) {
+            const UnsignedInt vertex = indices[best*3 + i];
+            output.push_back(vertex);
+
+            UnsignedInt* triangles = adjacency.data() + offsets[vertex];
+            *std::find(triangles, triangles + remaining[vertex], UnsignedInt(best)) = triangles[remaining[vertex] - 1];
+            --remaining[vertex];
+
+            if(std::find(newCache.begin(), newCache.end(), vertex) == newCache.end())
+                newCache.push_back(vertex);
+        }
+
+        /* Vertices of the triangle go to the front of LRU cache. Degenerate
+           triangles have less than three distinct vertices. */
+        const std::size_t triangleVertexCount = newCache.size();
+        for(UnsignedInt vertex: cache)
+            if(std::find(newCache.begin(), newCache.begin() + triangleVertexCount, vertex) == newCache.begin() + triangleVertexCount)
+                newCache.push_back(vertex);
+
+        /* Update scores of all vertices in the cache, including those just
+           pushed out of it */
+        for(std::size_t i = 0; i != newCache.size(); ++i) {
+            const UnsignedInt vertex = newCache[i];
+            cachePosition[vertex] = i < cacheSize ? Int(i) : -1;
+            vertexScore[vertex] = forsythScore(cachePosition[vertex], remaining[vertex], cacheSize);
+        }
+
+        /* Next triangle is the best one touching the cache */
+        best = -1;
+        bestScore = -1.0f;
+        for(UnsignedInt vertex: newCache) {
+            for(std::size_t i = 0; i != remaining[vertex]; ++i) {
+                const UnsignedInt triangle = adjacency[offsets[vertex] + i];
+                const Float score = triangleScore(triangle);
+                if(score > bestScore) {
+                    best = triangle;
+                    bestScore = score;
+                }
+            }
+        }
+
+        if(newCache.size() > cacheSize) newCache.resize(cacheSize);
+        std::swap(cache, newCache);
+    }
+
+    std::swap(indices, output);
+}
+
+void optimizeVertexCache(std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, VertexCacheOptimizer optimizer, std::size_t cacheSize) {
+    switch(optimizer) {
+        case VertexCacheOptimizer::None: return;
+        case VertexCacheOptimizer::Tipsify:
+            MeshTools::tipsify(indices, vertexCount, cacheSize);
+            return;
+        case VertexCacheOptimizer::Forsyth:
+            optimizeForsyth(indices, vertexCount, cacheSize);
+            return;
+    }
+}
+
+bool vertexCacheOptimizerFromName(const std::string& name, VertexCacheOptimizer& optimizer) {
+    if(name == "none") optimizer = VertexCacheOptimizer::None;
+    else if(name == "tipsify") optimizer = VertexCacheOptimizer::Tipsify;
+    else if(name == "forsyth") optimizer = VertexCacheOptimizer::Forsyth;
+    else return false;
+    return true;
+}
+
+const char* vertexCacheOptimizerName(VertexCacheOptimizer optimizer) {
+    switch(optimizer) {
+        case VertexCacheOptimizer::None: return "none";
+        case VertexCacheOptimizer::Tipsify: return "tipsify";
+        case VertexCacheOptimizer::Forsyth: return "forsyth";
+    }
+
+    return "";
+}
+
+}}
@@ -0,0 +1,93 @@
+#ifndef Magnum_Examples_VertexCache_h
+#define Magnum_Examples_VertexCache_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <string>
+#include <vector>
+#include <Magnum.h>
+
+namespace Magnum { namespace Examples {
+
+/** @brief Post-transform vertex cache replacement policy */
+enum class VertexCachePolicy {
+    Fifo,   /**< First in, first out (most hardware) */
+    Lru     /**< Least recently used */
+};
+
+/** @brief Vertex cache optimization algorithm */
+enum class VertexCacheOptimizer {
+    None,       /**< Keep the original order */
+    Tipsify,    /**< MeshTools::tipsify() */
+    Forsyth     /**< optimizeForsyth() */
+};
+
+/** @brief Vertex cache statistics */
+struct VertexCacheStatistics {
+    /** @brief Average cache miss ratio, transformed vertices per triangle */
+    Float acmr;
+
+    /** @brief Average transform to vertex ratio, transformed vertices per referenced vertex */
+    Float atvr;
+};
+
+/**
+@brief Simulate post-transform vertex cache
+@param indices      Triangle indices
+@param vertexCount  Vertex count
+@param policy       Replacement policy
+@param cacheSize    Cache size
+
+ACMR is between 0.5 and 3, ATVR between 1 and 6, lower is better.
+*/
+VertexCacheStatistics simulateVertexCache(const std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, VertexCachePolicy policy, std::size_t cacheSize);
+
+/**
+@brief Forsyth's vertex cache optimization
+@param indices      Triangle indices
+@param vertexCount  Vertex count
+@param cacheSize    Cache size
+
+Greedily emits the triangle with highest score, which is sum of scores of its
+vertices. Vertices recently used and vertices with only a few remaining
+triangles have higher score. Unlike MeshTools::tipsify() it models LRU cache.
+See http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html.
+*/
+void optimizeForsyth(std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, std::size_t cacheSize);
+
+/** @brief Optimize triangle order with given algorithm */
+void optimizeVertexCache(std::vector<UnsignedInt>& indices, UnsignedInt vertexCount, VertexCacheOptimizer optimizer, std::size_t cacheSize);
+
+/**
+@brief Optimizer from name
+@return `false` if the name is not one of `none`, `tipsify`, `forsyth`
+*/
+bool vertexCacheOptimizerFromName(const std::string& name, VertexCacheOptimizer& optimizer);
+
+/** @brief Name of the optimizer */
+const char* vertexCacheOptimizerName(VertexCacheOptimizer optimizer);
+
+}}
+
+#endif
@@ -24,7 +24,6 @@
     DEALINGS IN THE SOFTWARE.
 */
 
-#include "Mesh.h"
 #include <SceneGraph/AbstractCamera.h>
 #include <SceneGraph/Drawable.h>
 #include "SceneGraph/Object.h"
@@ -32,18 +31,47 @@
 #include "Trade/PhongMaterialData.h"
 
 #include "Types.h"
+#include "ViewerMesh.h"
+#ifndef MAGNUM_TARGET_GLES
+#include "ClusteredPhongShader.h"
+#include "ForwardPhongShader.h"
+#include "GBufferShader.h"
+#endif
 
 namespace Magnum { namespace Examples {
 
-class ViewedObject: public Object3D, SceneGraph::Drawable3D<> {
+/* Depth pre-pass needs invariant position in the main pass, which is
+   available only on desktop */
+#ifndef MAGNUM_TARGET_GLES
+typedef ForwardPhongShader ForwardShader;
+#else
+typedef Shaders::PhongShader ForwardShader;
+#endif
+
+class ViewedObject: public Object3D, public SceneGraph::Drawable3D<> {
     public:
-        ViewedObject(Mesh* mesh, Trade::PhongMaterialData* material, Shaders::PhongShader* shader, Object3D* parent, SceneGraph::DrawableGroup3D<>* group): Object3D(parent), SceneGraph::Drawable3D<>(this, group), mesh(mesh), ambientColor(material->ambientColor()), diffuseColor(material->diffuseColor()), specularColor(material->specularColor()), shininess(material->shininess()), shader(shader) {}
+        ViewedObject(ViewerMesh* mesh, Trade::PhongMaterialData* material, ForwardShader* shader, Object3D* parent, SceneGraph::DrawableGroup3D<>* group): Object3D(parent), SceneGraph::Drawable3D<>(this, group), mesh(mesh), ambient(material->ambientColor()), diffuse(material->diffuseColor()), specular(material->specularColor()), specularExponent(material->shininess()), shader(shader) {}
+
+        /** @brief Mesh */
+        inline ViewerMesh* viewerMesh() const { return mesh; }
+
+        /** @brief Ambient color */
+        inline Vector3 ambientColor() const { return ambient; }
+
+        /** @brief Diffuse color */
+        inline Vector3 diffuseColor() const { return diffuse; }
+
+        /** @brief Specular color */
+        inline Vector3 specularColor() const { return specular; }
+
+        /** @brief Shininess */
+        inline Float shininess() const { return specularExponent; }
 
         void draw(const Matrix4& transformationMatrix, SceneGraph::AbstractCamera3D<>* camera) override {
-            shader->setAmbientColor(ambientColor)
-                ->setDiffuseColor(diffuseColor)
-                ->setSpecularColor(specularColor)
-                ->setShininess(shininess)
+            shader->setAmbientColor(ambient)
+                ->setDiffuseColor(diffuse)
+                ->setSpecularColor(specular)
+                ->setShininess(specularExponent)
                 ->setLightPosition({-3.0f, 10.0f, 10.0f})
                 ->setTransformationMatrix(transformationMatrix)
                 ->setProjectionMatrix(camera->projectionMatrix())
@@ -52,13 +80,46 @@ class ViewedObject: public Object3D, SceneGraph::Drawable3D<> {
             mesh->draw();
         }
 
+        #ifndef MAGNUM_TARGET_GLES
+        /**
+         * @brief Draw into G-buffer
+         *
+         * Projection matrix is expected to be already set.
+         */
+        void drawGBuffer(GBufferShader* shader, const Matrix4& transformationMatrix) {
+            shader->setAmbientColor(ambient)
+                ->setDiffuseColor(diffuse)
+                ->setSpecularIntensity((specular.x() + specular.y() + specular.z())/3.0f)
+                ->setTransformationMatrix(transformationMatrix)
+                ->use();
+
+            mesh->draw();
+        }
+
+        /**
+         * @brief Draw with clustered lighting
+         *
+         * Projection matrix and light data are expected to be already set.
+         */
+        void drawClustered(ClusteredPhongShader* shader, const Matrix4& transformationMatrix) {
+            shader->setAmbientColor(ambient)
+                ->setDiffuseColor(diffuse)
+                ->setSpecularColor(specular)
+                ->setShininess(specularExponent)
+                ->setTransformationMatrix(transformationMatrix)
+                ->use();
+
+            mesh->draw();
+        }
+        #endif
+
     private:
-        Mesh* mesh;
-        Vector3 ambientColor,
-            diffuseColor,
-            specularColor;
-        Float shininess;
-        Shaders::PhongShader* shader;
+        ViewerMesh* mesh;
+        Vector3 ambient,
+            diffuse,
+            specular;
+        Float specularExponent;
+        ForwardShader* shader;
 };
 
 }}
@@ -22,14 +22,21 @@
     DEALINGS IN THE SOFTWARE.
 */
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 
 #include <PluginManager/PluginManager.h>
 #include <DefaultFramebuffer.h>
 #include <Mesh.h>
+#include <Query.h>
 #include <Renderer.h>
-#include <MeshTools/Tipsify.h>
 #include <MeshTools/Interleave.h>
 #include <MeshTools/CompressIndices.h>
 #include <SceneGraph/Scene.h>
@@ -40,7 +47,28 @@
 #include <Trade/MeshObjectData3D.h>
 #include <Trade/SceneData.h>
 
+#include "common/JobSystem.h"
+#include "BinaryMeshImporter.h"
+#ifndef MAGNUM_TARGET_GLES
+#include "ClusteredLighting.h"
+#include "ClusteredPhongShader.h"
+#include "DeferredRenderer.h"
+#include "DynamicResolution.h"
+#endif
+#include "DepthShader.h"
+#include "DrawListCamera.h"
 #include "FpsCounterExample.h"
+#include "ImportProfiler.h"
+#include "Lights.h"
+#include "MeshSplitter.h"
+#ifndef MAGNUM_TARGET_GLES
+#include "OverdrawVisualizer.h"
+#endif
+#include "SceneGenerator.h"
+#include "ScenePackage.h"
+#include "SceneStreamer.h"
+#include "TriangleStrips.h"
+#include "VertexCache.h"
 #include "ViewedObject.h"
 #include "configure.h"
 
@@ -51,6 +79,18 @@ using namespace Magnum::Examples;
 
 namespace Magnum { namespace Examples {
 
+namespace {
+    /* Meshes with more vertices are split so each chunk fits into 16-bit
+       indices, with the max value left free for primitive restart */
+    constexpr UnsignedInt MaxChunkVertexCount = 65535;
+
+    /* Light counts measured in light sweep */
+    constexpr std::size_t SweepLightCounts[] = {16, 64, 256, 1024, 4096};
+    constexpr std::size_t SweepStepCount = 5;
+    constexpr std::size_t SweepWarmupFrames = 5;
+    constexpr std::size_t SweepFrames = 30;
+}
+
 class ViewerExample: public FpsCounterExample {
     public:
         explicit ViewerExample(const Arguments& arguments);
@@ -67,105 +107,357 @@ class ViewerExample: public FpsCounterExample {
     private:
         Vector3 positionOnSphere(const Vector2i& _position) const;
 
-        void addObject(AbstractImporter* colladaImporter, Object3D* parent, std::unordered_map<std::size_t, PhongMaterialData*>& materials, std::size_t objectId);
+        /* Triangle strips with primitive restart */
+        enum class StripMode {
+            Off,        /* Triangle lists */
+            On,         /* Triangle strips */
+            Automatic   /* Whichever draws faster */
+        };
+
+        #ifndef MAGNUM_TARGET_GLES
+        enum class RenderPath {
+            Forward,    /* One light, Phong shader */
+            Deferred,   /* All lights, DeferredRenderer */
+            Clustered   /* All lights, ClusteredLighting */
+        };
+
+        void printOverdrawStatistics();
+        void setRenderPath(RenderPath path);
+        void setLightCount(std::size_t count);
+        void startLightSweep();
+        void updateLightSweep();
+        void setDynamicResolution(bool enabled);
+        #endif
 
+        void importScene(const char* filename, const std::string& extension, const std::string& timingJson);
+        void generateScene(const std::string& options, const std::string& timingJson);
+        void addScene(AbstractImporter* importer, const std::string& name, const std::string& timingJson);
+        void buildSceneBvh();
+        void pick(const Vector2i& position);
+        void openPackage(const char* filename, std::size_t ramBudget, std::size_t vramBudget);
+        void addObject(AbstractImporter* importer, Object3D* parent, std::unordered_map<std::size_t, PhongMaterialData*>& materials, std::size_t objectId);
+        ViewerMesh* createMesh(std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals);
+        #ifndef MAGNUM_TARGET_GLES
+        Double measureDrawTime(const char* vertexData, std::size_t vertexDataSize, UnsignedInt vertexCount, Mesh::Primitive primitive, std::size_t indexCount, Mesh::IndexType indexType, const char* indexData);
+        #endif
+
+        JobSystem jobs;
+        ImportProfiler importProfiler;
         Scene3D scene;
         SceneGraph::DrawableGroup3D<> drawables;
         Object3D* cameraObject;
-        SceneGraph::Camera3D<>* camera;
-        PhongShader shader;
+        DrawListCamera* camera;
+        ForwardShader shader;
         Object3D* o;
-        std::unordered_map<std::size_t, std::tuple<Buffer*, Buffer*, Mesh*>> meshes;
-        std::size_t vertexCount, triangleCount, objectCount, meshCount, materialCount;
+        std::unordered_map<std::size_t, std::vector<ViewerMesh*>> meshes;
+        std::size_t vertexCount, triangleCount, objectCount, meshCount, chunkCount, materialCount;
+        VertexCacheOptimizer optimizer;
+        std::size_t cacheSize;
+        bool analyzeCache;
+        Float missesBefore, missesAfter;
+        bool splitMeshes;
+        StripMode stripMode;
+        std::size_t listIndexBytes, indexBytes;
+        bool lazyUpload, firstFrame, uploadPending;
+        std::size_t meshDataBytes;
+        std::chrono::high_resolution_clock::time_point startTime;
+        std::unique_ptr<ScenePackage> package;
+        std::unique_ptr<SceneStreamer> streamer;
+        bool picking;
+        std::size_t bvhBytes;
+        SceneBvh sceneBvh;
         bool wireframe;
+        #ifndef MAGNUM_TARGET_GLES
+        std::unique_ptr<OverdrawVisualizer> overdraw;
+        bool overdrawReport;
+
+        RenderPath renderPath;
+        std::unique_ptr<DeferredRenderer> deferred;
+        std::unique_ptr<ClusteredLighting> clustered;
+        ShaderVariants<ClusteredPhongShader> clusteredShaders;
+        ClusteredPhongShader* clusteredShader;
+        Query shadingQuery;
+        std::size_t lightCount;
+        Vector3 sceneMin, sceneMax;
+
+        bool dynamicResolutionEnabled;
+        std::unique_ptr<DynamicResolution> dynamicResolution;
+        Double targetFrameTime;
+
+        std::size_t sweepStep, sweepFrame, sweepOriginalLightCount;
+        Double sweepGeometryTime, sweepLightingTime, sweepAssignmentTime;
+        UnsignedLong sweepBandwidth;
+        UnsignedInt sweepMaxLights;
+        std::chrono::high_resolution_clock::time_point sweepStart;
+        #endif
         Vector3 previousPosition;
 };
 
-ViewerExample::ViewerExample(const Arguments& arguments): FpsCounterExample(arguments, (new Configuration)->setTitle("Magnum Viewer")), vertexCount(0), triangleCount(0), objectCount(0), meshCount(0), materialCount(0), wireframe(false) {
-    if(arguments.argc != 2) {
-        Debug() << "Usage:" << arguments.argv[0] << "file.dae";
+ViewerExample::ViewerExample(const Arguments& arguments): FpsCounterExample(arguments, (new Configuration)->setTitle("Magnum Viewer")), vertexCount(0), triangleCount(0), objectCount(0), meshCount(0), chunkCount(0), materialCount(0), optimizer(VertexCacheOptimizer::Tipsify), cacheSize(24), analyzeCache(false), missesBefore(0.0f), missesAfter(0.0f), splitMeshes(true), listIndexBytes(0), indexBytes(0), lazyUpload(false), firstFrame(true), uploadPending(false), meshDataBytes(0), startTime(std::chrono::high_resolution_clock::now()), picking(true), bvhBytes(0), wireframe(false)
+    #ifndef MAGNUM_TARGET_GLES
+    , overdrawReport(false), renderPath(RenderPath::Forward), clusteredShader(nullptr), lightCount(256), dynamicResolutionEnabled(false), targetFrameTime(16.6), sweepStep(SweepStepCount)
+    #endif
+{
+    const char* filename = nullptr;
+    bool invalid = false;
+    std::string generatorOptions;
+    std::string timingJson;
+    std::string packageFile;
+    std::size_t uploadBudget = 16, ramBudget = 1024, vramBudget = 512;
+    #ifndef MAGNUM_TARGET_GLES
+    DrawListCamera::DepthPrepass depthPrepass = DrawListCamera::DepthPrepass::Automatic;
+    RenderPath initialRenderPath = RenderPath::Forward;
+    bool initialDynamicResolution = false;
+    #endif
+    #ifndef MAGNUM_TARGET_GLES
+    stripMode = StripMode::Automatic;
+    #else
+    stripMode = StripMode::Off;
+    #endif
+    for(int i = 1; i != arguments.argc; ++i) {
+        const std::string argument = arguments.argv[i];
+        if(argument == "--analyze-cache") analyzeCache = true;
+        else if(argument == "--optimizer" && i + 1 != arguments.argc && vertexCacheOptimizerFromName(arguments.argv[i + 1], optimizer)) ++i;
+        else if(argument == "--cache-size" && i + 1 != arguments.argc && std::atoi(arguments.argv[i + 1]) > 3)
+            cacheSize = std::atoi(arguments.argv[++i]);
+        else if(argument == "--no-split") splitMeshes = false;
+        else if(argument == "--lazy-upload") lazyUpload = true;
+        else if(argument == "--no-picking") picking = false;
+        else if(argument == "--upload-budget" && i + 1 != arguments.argc && std::atoi(arguments.argv[i + 1]) > 0)
+            uploadBudget = std::atoi(arguments.argv[++i]);
+        else if(argument == "--ram-budget" && i + 1 != arguments.argc && std::atoi(arguments.argv[i + 1]) > 0)
+            ramBudget = std::atoi(arguments.argv[++i]);
+        else if(argument == "--vram-budget" && i + 1 != arguments.argc && std::atoi(arguments.argv[i + 1]) > 0)
+            vramBudget = std::atoi(arguments.argv[++i]);
+        else if(argument == "--generate" && i + 1 != arguments.argc)
+            generatorOptions = arguments.argv[++i];
+        else if(argument == "--write-package" && i + 1 != arguments.argc)
+            packageFile = arguments.argv[++i];
+        else if(argument == "--timing-json" && i + 1 != arguments.argc)
+            timingJson = arguments.argv[++i];
+        #ifndef MAGNUM_TARGET_GLES
+        else if(argument == "--overdraw-report") overdrawReport = true;
+        else if(argument == "--strips" && i + 1 != arguments.argc) {
+            const std::string mode = arguments.argv[++i];
+            if(mode == "off") stripMode = StripMode::Off;
+            else if(mode == "on") stripMode = StripMode::On;
+            else if(mode == "auto") stripMode = StripMode::Automatic;
+            else {
+                invalid = true;
+                break;
+            }
+        }
+        else if(argument == "--depth-prepass" && i + 1 != arguments.argc) {
+            const std::string mode = arguments.argv[++i];
+            if(mode == "off") depthPrepass = DrawListCamera::DepthPrepass::Off;
+            else if(mode == "on") depthPrepass = DrawListCamera::DepthPrepass::On;
+            else if(mode == "auto") depthPrepass = DrawListCamera::DepthPrepass::Automatic;
+            else {
+                invalid = true;
+                break;
+            }
+        } else if(argument == "--render-path" && i + 1 != arguments.argc) {
+            const std::string path = arguments.argv[++i];
+            if(path == "forward") initialRenderPath = RenderPath::Forward;
+            else if(path == "deferred") initialRenderPath = RenderPath::Deferred;
+            else if(path == "clustered") initialRenderPath = RenderPath::Clustered;
+            else {
+                invalid = true;
+                break;
+            }
+        } else if(argument == "--lights" && i + 1 != arguments.argc)
+            lightCount = std::atoi(arguments.argv[++i]);
+        else if(argument == "--dynamic-resolution") initialDynamicResolution = true;
+        else if(argument == "--frame-time" && i + 1 != arguments.argc && std::atof(arguments.argv[i + 1]) > 0.0)
+            targetFrameTime = std::atof(arguments.argv[++i]);
+        #endif
+        else if(argument[0] != '-' && !filename) filename = arguments.argv[i];
+        else {
+            invalid = true;
+            break;
+        }
+    }
+
+    /* Either file or generated scene */
+    if(invalid || (filename != nullptr) == !generatorOptions.empty()) {
+        Debug() << "Usage:" << arguments.argv[0] << "[--optimizer tipsify|forsyth|none] [--cache-size N] [--analyze-cache] [--no-split] [--lazy-upload] [--upload-budget MB] [--no-picking] [--ram-budget MB] [--vram-budget MB] [--write-package file.scenepack] [--timing-json file.json] [--strips off|on|auto] [--overdraw-report] [--depth-prepass off|on|auto] [--render-path forward|deferred|clustered] [--lights N] [--dynamic-resolution] [--frame-time MS] file.dae|file.ply|file.stl|file.scenepack|--generate objects=N,depth=N,fanout=N,reuse=R,materials=N,seed=N";
         std::exit(0);
     }
 
-    /* Instance ColladaImporter plugin */
-    PluginManager<AbstractImporter> manager(MAGNUM_PLUGINS_IMPORTER_DIR);
-    if(manager.load("ColladaImporter") != LoadState::Loaded) {
-        Error() << "Could not load ColladaImporter plugin";
+    /* Supported file types */
+    std::string extension = filename ? filename : "";
+    extension = extension.substr(std::min(extension.size(), extension.rfind('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if(filename && extension != ".dae" && extension != ".ply" && extension != ".stl" && extension != ".scenepack") {
+        Error() << "Unsupported file extension" << extension;
         std::exit(1);
     }
-    std::unique_ptr<AbstractImporter> colladaImporter(manager.instance("ColladaImporter"));
-    if(!colladaImporter) {
-        Error() << "Could not instance ColladaImporter plugin";
-        std::exit(2);
-    }
-    if(!(colladaImporter->features() & AbstractImporter::Feature::OpenFile)) {
-        Error() << "ColladaImporter cannot open files";
-        std::exit(3);
-    }
 
     /* Every scene needs a camera */
     (cameraObject = new Object3D(&scene))
         ->translate(Vector3::zAxis(5));
-    (camera = new SceneGraph::Camera3D<>(cameraObject))
+    (camera = new DrawListCamera(cameraObject))
         ->setAspectRatioPolicy(SceneGraph::AspectRatioPolicy::Extend)
         ->setPerspective(35.0_degf, 1.0f, 0.001f, 100);
+    #ifndef MAGNUM_TARGET_GLES
+    camera->setDepthPrepass(depthPrepass);
+    #endif
+    camera->setUploadBudget(uploadBudget*1024*1024);
     Renderer::setFeature(Renderer::Feature::DepthTest, true);
     Renderer::setFeature(Renderer::Feature::FaceCulling, true);
 
-    Debug() << "Opening file" << arguments.argv[1];
-
-    /* Load file */
-    if(!colladaImporter->openFile(arguments.argv[1]))
-        std::exit(4);
-
-    if(colladaImporter->sceneCount() == 0)
-        std::exit(5);
-
-    /* Map with materials */
-    std::unordered_map<std::size_t, PhongMaterialData*> materials;
-
     /* Default object, parent of all (for manipulation) */
     o = new Object3D(&scene);
 
-    Debug() << "Adding default scene...";
-
-    /* Load the scene */
-    SceneData* scene = colladaImporter->scene(colladaImporter->defaultScene());
+    /* Scene package is streamed, everything else is imported. Written
+       package needs the mesh data in host memory. */
+    if(extension == ".scenepack") openPackage(filename, ramBudget*1024*1024, vramBudget*1024*1024);
+    else {
+        if(!packageFile.empty()) lazyUpload = true;
+        if(!filename) generateScene(generatorOptions, timingJson);
+        else importScene(filename, extension, timingJson);
+    }
 
-    /* Add all children */
-    for(std::size_t objectId: scene->children3D())
-        addObject(colladaImporter.get(), o, materials, objectId);
+    if(!packageFile.empty()) {
+        std::vector<ViewedObject*> objects;
+        for(std::size_t i = 0; i != drawables.size(); ++i)
+            objects.push_back(static_cast<ViewedObject*>(drawables[i]));
+        if(!writeScenePackage(packageFile, objects))
+            std::exit(7);
+    }
 
-    Debug() << "Imported" << objectCount << "objects with" << meshCount << "meshes and" << materialCount << "materials,";
-    Debug() << "    " << vertexCount << "vertices and" << triangleCount << "triangles total.";
+    #ifndef MAGNUM_TARGET_GLES
+    /* Scene bounds relative to the manipulated object, for placing lights */
+    for(std::size_t i = 0; i != drawables.size(); ++i) {
+        ViewedObject* object = static_cast<ViewedObject*>(drawables[i]);
+        const Vector3 center = object->absoluteTransformation().transformPoint(object->viewerMesh()->center);
+        const Vector3 min = center - Vector3(object->viewerMesh()->radius);
+        const Vector3 max = center + Vector3(object->viewerMesh()->radius);
+        if(!i) {
+            sceneMin = min;
+            sceneMax = max;
+            continue;
+        }
 
-    /* Delete materials, as they are now unused */
-    for(auto i: materials) delete i.second;
+        for(std::size_t j = 0; j != 3; ++j) {
+            sceneMin[j] = std::min(sceneMin[j], min[j]);
+            sceneMax[j] = std::max(sceneMax[j], max[j]);
+        }
+    }
 
-    colladaImporter->close();
-    delete colladaImporter.release();
+    setRenderPath(initialRenderPath);
+    setDynamicResolution(initialDynamicResolution);
+    #endif
 }
 
 ViewerExample::~ViewerExample() {
-    for(auto i: meshes) {
-        delete std::get<0>(i.second);
-        delete std::get<1>(i.second);
-        delete std::get<2>(i.second);
-    }
+    for(auto i: meshes)
+        for(ViewerMesh* mesh: i.second) delete mesh;
 }
 
 void ViewerExample::viewportEvent(const Vector2i& size) {
     defaultFramebuffer.setViewport({{}, size});
     camera->setViewport(size);
+    #ifndef MAGNUM_TARGET_GLES
+    if(overdraw) overdraw->setViewport(size);
+    if(deferred) deferred->setViewport(size);
+    if(dynamicResolution) dynamicResolution->setViewport(size);
+    #endif
     FpsCounterExample::viewportEvent(size);
 }
 
 void ViewerExample::drawEvent() {
     defaultFramebuffer.clear(DefaultFramebuffer::Clear::Color|DefaultFramebuffer::Clear::Depth);
+
+    #ifndef MAGNUM_TARGET_GLES
+    /* Overdraw report requested, print it for the first frame and exit */
+    if(overdrawReport && !overdraw)
+        overdraw.reset(new OverdrawVisualizer(camera->viewport()));
+
+    /* Forward rendering at dynamic resolution. Overdraw visualization and
+       deferred renderer have their own targets and clustered shading
+       measures its own GPU time, which can't overlap with another time query,
+       so these are always at full resolution. */
+    const bool scaled = dynamicResolutionEnabled && !overdraw && renderPath == RenderPath::Forward;
+    if(scaled && !dynamicResolution) {
+        dynamicResolution.reset(new DynamicResolution(camera->viewport()));
+        dynamicResolution->setTargetFrameTime(targetFrameTime);
+    }
+    if(scaled) {
+        dynamicResolution->begin();
+        camera->setViewport(dynamicResolution->renderSize());
+    }
+
+    if(overdraw) {
+        camera->buildDrawList(drawables);
+        overdraw->draw(camera);
+
+        if(overdrawReport) {
+            printOverdrawStatistics();
+            std::exit(0);
+        }
+    } else if(renderPath == RenderPath::Deferred) {
+        /* Created here, as the viewport size isn't known in constructor */
+        if(!deferred) {
+            deferred.reset(new DeferredRenderer(camera->viewport()));
+            deferred->setLights(generateLights(lightCount, sceneMin, sceneMax));
+        }
+
+        camera->buildDrawList(drawables);
+        deferred->draw(camera, camera->cameraMatrix()*o->absoluteTransformation());
+        if(sweepStep != SweepStepCount) updateLightSweep();
+    } else if(renderPath == RenderPath::Clustered) {
+        if(!clustered) {
+            clustered.reset(new ClusteredLighting);
+            clustered->setLights(generateLights(lightCount, sceneMin, sceneMax));
+            clusteredShader = clusteredShaders.get(ClusteredLighting::shaderDefines());
+        }
+
+        camera->buildDrawList(drawables);
+        clustered->update(camera->cameraMatrix()*o->absoluteTransformation(), camera->projectionMatrix(), camera->near(), camera->far());
+
+        shadingQuery.begin(Query::Target::TimeElapsed);
+        clustered->bind(clusteredShader, camera->viewport());
+        clusteredShader->setProjectionMatrix(camera->projectionMatrix());
+        for(const DrawCommand& command: camera->drawList())
+            command.object->drawClustered(clusteredShader, command.transformationMatrix);
+        clustered->endFrame();
+        shadingQuery.end();
+
+        if(sweepStep != SweepStepCount) updateLightSweep();
+    } else camera->draw(drawables);
+
+    if(scaled) {
+        camera->setViewport(defaultFramebuffer.viewport().size());
+        dynamicResolution->end();
+        setResolutionScale(dynamicResolution->scale());
+    } else if(dynamicResolutionEnabled) setResolutionScale(1.0f);
+    #else
     camera->draw(drawables);
+    #endif
+
+    /* Page the scene package in and out based on what was drawn */
+    if(streamer)
+        streamer->update(camera->drawList(), (o->absoluteTransformation().inverted()*cameraObject->absoluteTransformation()).translation());
+
     swapBuffers();
 
-    if(fpsCounterEnabled()) redraw();
+    /* Time to first frame and progress of lazy upload */
+    const std::size_t uploadedBytes = streamer ? streamer->uploadedSize() : lazyUpload ? camera->uploadedSize() : meshDataBytes;
+    if(firstFrame) {
+        Debug() << "First frame drawn after" << std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count() << "ms with" << uploadedBytes/1024 << "kB of" << meshDataBytes/1024 << "kB mesh data uploaded";
+        firstFrame = false;
+    }
+    if(camera->pendingUploadCount()) uploadPending = true;
+    else if(uploadPending) {
+        Debug() << "All visible meshes uploaded," << uploadedBytes/1024 << "kB of" << meshDataBytes/1024 << "kB mesh data";
+        uploadPending = false;
+    }
+
+    if(fpsCounterEnabled() || camera->pendingUploadCount()) redraw();
+    #ifndef MAGNUM_TARGET_GLES
+    else if(sweepStep != SweepStepCount) redraw();
+    #endif
 }
 
 void ViewerExample::keyPressEvent(KeyEvent& event) {
@@ -193,10 +485,43 @@ void ViewerExample::keyPressEvent(KeyEvent& event) {
             Mesh::setPolygonMode(wireframe ? Mesh::PolygonMode::Fill : Mesh::PolygonMode::Line);
             wireframe = !wireframe;
             break;
+        case KeyEvent::Key::F1:
+            if(overdraw) overdraw.reset();
+            else overdraw.reset(new OverdrawVisualizer(camera->viewport()));
+            break;
+        case KeyEvent::Key::F2:
+            if(overdraw) printOverdrawStatistics();
+            break;
+        case KeyEvent::Key::F3:
+            if(camera->depthPrepass() == DrawListCamera::DepthPrepass::Off) {
+                camera->setDepthPrepass(DrawListCamera::DepthPrepass::On);
+                Debug() << "Depth pre-pass on";
+            } else if(camera->depthPrepass() == DrawListCamera::DepthPrepass::On) {
+                camera->setDepthPrepass(DrawListCamera::DepthPrepass::Automatic);
+                Debug() << "Depth pre-pass automatic";
+            } else {
+                camera->setDepthPrepass(DrawListCamera::DepthPrepass::Off);
+                Debug() << "Depth pre-pass off";
+            }
+            resetCounter();
+            break;
+        case KeyEvent::Key::F4:
+            if(renderPath == RenderPath::Forward) setRenderPath(RenderPath::Deferred);
+            else if(renderPath == RenderPath::Deferred) setRenderPath(RenderPath::Clustered);
+            else setRenderPath(RenderPath::Forward);
+            break;
+        case KeyEvent::Key::F5:
+            startLightSweep();
+            break;
+        case KeyEvent::Key::F6:
+            setDynamicResolution(!dynamicResolutionEnabled);
+            break;
         #endif
         case KeyEvent::Key::End:
-            if(fpsCounterEnabled()) printCounterStatistics();
-            else resetCounter();
+            if(fpsCounterEnabled()) {
+                printCounterStatistics();
+                if(streamer) Debug() << "Streaming:" << streamer->residentSize()/1024 << "kB in host memory," << streamer->uploadedSize()/1024 << "kB on GPU," << streamer->prefetchCount() << "meshes prefetched," << streamer->evictionCount() << "evicted from host memory and" << streamer->releaseCount() << "released from GPU";
+            } else resetCounter();
 
             setFpsCounterEnabled(!fpsCounterEnabled());
             break;
@@ -211,6 +536,9 @@ void ViewerExample::mousePressEvent(MouseEvent& event) {
         case MouseEvent::Button::Left:
             previousPosition = positionOnSphere(event.position());
             break;
+        case MouseEvent::Button::Middle:
+            pick(event.position());
+            break;
         case MouseEvent::Button::WheelUp:
         case MouseEvent::Button::WheelDown: {
             /* Distance between origin and near camera clipping plane */
@@ -249,6 +577,139 @@ void ViewerExample::mouseMoveEvent(MouseMoveEvent& event) {
     redraw();
 }
 
+#ifndef MAGNUM_TARGET_GLES
+void ViewerExample::printOverdrawStatistics() {
+    const OverdrawVisualizer::Statistics statistics = overdraw->statistics();
+    Debug() << "Overdraw: coverage" << statistics.coverage << "of pixels, layers per covered pixel:";
+    Debug() << "    mean" << statistics.mean << "median" << statistics.median << "90%" << statistics.percentile90 << "99%" << statistics.percentile99 << "max" << statistics.max;
+}
+
+void ViewerExample::setRenderPath(RenderPath path) {
+    renderPath = path;
+    resetCounter();
+
+    if(path == RenderPath::Forward)
+        Debug() << "Forward rendering with one light";
+    else if(path == RenderPath::Deferred)
+        Debug() << "Deferred rendering with" << lightCount << "lights";
+    else
+        Debug() << "Clustered forward rendering with" << lightCount << "lights";
+}
+
+void ViewerExample::setDynamicResolution(bool enabled) {
+    dynamicResolutionEnabled = enabled;
+    resetCounter();
+
+    if(enabled) {
+        Debug() << "Dynamic resolution with target GPU frame time" << targetFrameTime << "ms";
+        return;
+    }
+
+    /* Start again from full resolution next time */
+    dynamicResolution.reset();
+    setResolutionScale(-1.0f);
+    Debug() << "Full resolution";
+}
+
+void ViewerExample::setLightCount(std::size_t count) {
+    lightCount = count;
+    if(deferred) deferred->setLights(generateLights(lightCount, sceneMin, sceneMax));
+    if(clustered) clustered->setLights(generateLights(lightCount, sceneMin, sceneMax));
+}
+
+void ViewerExample::startLightSweep() {
+    if(sweepStep != SweepStepCount) return;
+
+    if(renderPath == RenderPath::Forward) setRenderPath(RenderPath::Deferred);
+    sweepOriginalLightCount = lightCount;
+    sweepStep = 0;
+    sweepFrame = 0;
+    setLightCount(SweepLightCounts[0]);
+
+    if(renderPath == RenderPath::Deferred)
+        std::cout << "  lights  G-buffer ms  lighting ms  frame ms  MB/frame  GB/s" << std::endl;
+    else
+        std::cout << "  lights  assignment ms  shading ms  frame ms  max lights/cluster" << std::endl;
+}
+
+void ViewerExample::updateLightSweep() {
+    /* Skip first frames after changing the lights */
+    if(sweepFrame++ < SweepWarmupFrames) {
+        sweepGeometryTime = sweepLightingTime = sweepAssignmentTime = 0.0;
+        sweepBandwidth = 0;
+        sweepMaxLights = 0;
+        sweepStart = std::chrono::high_resolution_clock::now();
+        return;
+    }
+
+    /* Waits for the GPU, so the frame time includes the whole frame */
+    if(renderPath == RenderPath::Deferred) {
+        const DeferredRenderer::Timing timing = deferred->timing();
+        sweepGeometryTime += timing.geometryTime;
+        sweepLightingTime += timing.lightingTime;
+        sweepBandwidth += timing.bandwidth;
+    } else {
+        sweepAssignmentTime += clustered->assignmentTime();
+        sweepLightingTime += shadingQuery.result<UnsignedLong>()/1.0e6;
+        sweepMaxLights = std::max(sweepMaxLights, clustered->maxLightsPerCluster());
+    }
+    if(sweepFrame != SweepWarmupFrames + SweepFrames) return;
+
+    const Double frameTime = std::chrono::duration<Double, std::milli>(std::chrono::high_resolution_clock::now() - sweepStart).count()/SweepFrames;
+    std::cout << std::fixed << std::setprecision(2) << std::setw(8) << SweepLightCounts[sweepStep];
+    if(renderPath == RenderPath::Deferred) {
+        const Double bandwidth = Double(sweepBandwidth)/SweepFrames;
+        std::cout << std::setw(13) << sweepGeometryTime/SweepFrames
+                  << std::setw(13) << sweepLightingTime/SweepFrames
+                  << std::setw(10) << frameTime
+                  << std::setw(10) << bandwidth/(1024.0*1024.0)
+                  << std::setw(6) << bandwidth/((sweepGeometryTime + sweepLightingTime)/SweepFrames*1.0e6) << std::endl;
+    } else {
+        std::cout << std::setw(15) << sweepAssignmentTime/SweepFrames
+                  << std::setw(12) << sweepLightingTime/SweepFrames
+                  << std::setw(10) << frameTime
+                  << std::setw(20) << sweepMaxLights << std::endl;
+    }
+
+    /* Next step or restore the original light count */
+    sweepFrame = 0;
+    if(++sweepStep != SweepStepCount) setLightCount(SweepLightCounts[sweepStep]);
+    else setLightCount(sweepOriginalLightCount);
+}
+
+Double ViewerExample::measureDrawTime(const char* vertexData, std::size_t vertexDataSize, UnsignedInt vertexCount, Mesh::Primitive primitive, std::size_t indexCount, Mesh::IndexType indexType, const char* indexData) {
+    constexpr std::size_t Iterations = 8;
+
+    Buffer vertexBuffer, indexBuffer;
+    vertexBuffer.setData(vertexDataSize, vertexData, Buffer::Usage::StaticDraw);
+    indexBuffer.setData(indexCount*Mesh::indexSize(indexType), indexData, Buffer::Usage::StaticDraw);
+    Mesh mesh;
+    mesh.setPrimitive(primitive)
+        ->setVertexCount(vertexCount)
+        ->addInterleavedVertexBuffer(&vertexBuffer, 0, ForwardShader::Position(), ForwardShader::Normal())
+        ->setIndexCount(indexCount)
+        ->setIndexBuffer(&indexBuffer, 0, indexType, 0, vertexCount - 1);
+
+    /* Rasterization disabled, the representations differ only in index
+       fetch and vertex processing */
+    usePrimitiveRestart(primitive == Mesh::Primitive::TriangleStrip ? stripRestartIndex(indexType) : 0);
+    shader.setTransformationMatrix(Matrix4())
+        ->setProjectionMatrix(Matrix4())
+        ->use();
+    Renderer::setFeature(Renderer::Feature::RasterizerDiscard, true);
+
+    /* First draw is not measured, it might include driver setup */
+    mesh.draw();
+    Query query;
+    query.begin(Query::Target::TimeElapsed);
+    for(std::size_t i = 0; i != Iterations; ++i) mesh.draw();
+    query.end();
+
+    Renderer::setFeature(Renderer::Feature::RasterizerDiscard, false);
+    return query.result<UnsignedLong>()/1.0e6/Iterations;
+}
+#endif
+
 Vector3 ViewerExample::positionOnSphere(const Vector2i& _position) const {
     Vector2i viewport = camera->viewport();
     Vector2 position(_position.x()*2.0f/viewport.x() - 1.0f,
@@ -260,44 +721,231 @@ Vector3 ViewerExample::positionOnSphere(const Vector2i& _position) const {
     return result.normalized();
 }
 
-void ViewerExample::addObject(AbstractImporter* colladaImporter, Object3D* parent, std::unordered_map<std::size_t, PhongMaterialData*>& materials, std::size_t objectId) {
-    ObjectData3D* object = colladaImporter->object3D(objectId);
+void ViewerExample::buildSceneBvh() {
+    /* Instances relative to the manipulated object, picking rays are
+       transformed into its coordinate system */
+    importProfiler.start(ImportProfiler::Phase::Bvh);
+    const Matrix4 toScene = o->absoluteTransformation().inverted();
+    for(std::size_t i = 0; i != drawables.size(); ++i) {
+        ViewedObject* object = static_cast<ViewedObject*>(drawables[i]);
+        if(object->viewerMesh()->bvh)
+            sceneBvh.addInstance(object->viewerMesh()->bvh.get(), toScene*object->absoluteTransformation(), object);
+    }
+    sceneBvh.build();
+    importProfiler.stop();
+
+    Debug() << "Picking BVH over" << sceneBvh.instanceCount() << "instances," << bvhBytes/1024 << "kB for mesh triangles.";
+}
+
+void ViewerExample::pick(const Vector2i& position) {
+    if(!sceneBvh.instanceCount()) {
+        Debug() << "Picking is not available, scene packages and --no-picking have no BVH";
+        return;
+    }
+
+    /* Ray through the pixel from near to far plane, in camera space */
+    const Vector2i viewport = camera->viewport();
+    const Float x = position.x()*2.0f/viewport.x() - 1.0f;
+    const Float y = 1.0f - position.y()*2.0f/viewport.y();
+    const Matrix4 unprojection = camera->projectionMatrix().inverted();
+    const Vector4 nearPoint = unprojection*Vector4(x, y, -1.0f, 1.0f);
+    const Vector4 farPoint = unprojection*Vector4(x, y, 1.0f, 1.0f);
+
+    /* Then in coordinate system of the manipulated object */
+    const Matrix4 toScene = (camera->cameraMatrix()*o->absoluteTransformation()).inverted();
+    const Vector3 origin = toScene.transformPoint(nearPoint.xyz()/nearPoint.w());
+    const Vector3 direction = toScene.transformPoint(farPoint.xyz()/farPoint.w()) - origin;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    SceneBvh::Hit hit;
+    const bool found = sceneBvh.intersect(origin, direction, hit);
+    const Double time = std::chrono::duration<Double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+    if(!found) {
+        Debug() << "Picked nothing in" << time << "us";
+        return;
+    }
+
+    Debug() << "Picked triangle" << hit.triangle << "of mesh" << hit.object->viewerMesh()->id << "at" << origin + direction*hit.distance << "in" << time << "us";
+}
+
+void ViewerExample::importScene(const char* filename, const std::string& extension, const std::string& timingJson) {
+    /* Binary PLY and STL are loaded with importer built into the viewer, the
+       rest with importer plugin. */
+    std::string pluginName;
+    if(extension == ".dae") pluginName = "ColladaImporter";
+
+    PluginManager<AbstractImporter> manager(MAGNUM_PLUGINS_IMPORTER_DIR);
+    std::unique_ptr<AbstractImporter> importer;
+    if(pluginName.empty()) importer.reset(new BinaryMeshImporter);
+    else {
+        if(manager.load(pluginName) != LoadState::Loaded) {
+            Error() << "Could not load" << pluginName << "plugin";
+            std::exit(1);
+        }
+        importer.reset(manager.instance(pluginName));
+        if(!importer) {
+            Error() << "Could not instance" << pluginName << "plugin";
+            std::exit(2);
+        }
+    }
+    if(!(importer->features() & AbstractImporter::Feature::OpenFile)) {
+        Error() << "Importer cannot open files";
+        std::exit(3);
+    }
+
+    Debug() << "Opening file" << filename;
+
+    /* Load file */
+    importProfiler.start(ImportProfiler::Phase::Open);
+    if(!importer->openFile(filename))
+        std::exit(4);
+
+    addScene(importer.get(), filename, timingJson);
+    importer.reset();
+}
+
+void ViewerExample::generateScene(const std::string& options, const std::string& timingJson) {
+    SceneGenerator generator;
+    if(!generator.setOptions(options))
+        std::exit(1);
+
+    Debug() << "Generating scene" << options;
+
+    /* Generation is measured as file open */
+    importProfiler.start(ImportProfiler::Phase::Open);
+    generator.generate();
+    Debug() << "Generated hierarchy with" << generator.rootCount() << "roots and depth" << generator.generatedDepth();
+
+    addScene(&generator, "generated", timingJson);
+}
+
+void ViewerExample::addScene(AbstractImporter* importer, const std::string& name, const std::string& timingJson) {
+    if(importer->sceneCount() == 0)
+        std::exit(5);
+
+    /* Map with materials */
+    std::unordered_map<std::size_t, PhongMaterialData*> materials;
+
+    Debug() << "Adding default scene...";
+
+    /* Load the scene */
+    SceneData* scene = importer->scene(importer->defaultScene());
+    importProfiler.stop();
+
+    /* Add all children */
+    for(std::size_t objectId: scene->children3D())
+        addObject(importer, o, materials, objectId);
+
+    Debug() << "Imported" << objectCount << "objects with" << meshCount << "meshes in" << chunkCount << "chunks and" << materialCount << "materials,";
+    Debug() << "    " << vertexCount << "vertices and" << triangleCount << "triangles total.";
+    if(analyzeCache && triangleCount)
+        Debug() << "Average FIFO cache miss ratio" << missesBefore/triangleCount << "before and" << missesAfter/triangleCount << "after optimization.";
+    if(stripMode != StripMode::Off)
+        Debug() << "Index memory" << indexBytes/1024 << "kB, as triangle lists it would be" << listIndexBytes/1024 << "kB.";
+
+    if(picking) buildSceneBvh();
+
+    importProfiler.finish();
+    importProfiler.print();
+    if(!timingJson.empty() && !importProfiler.writeJson(timingJson, name))
+        Error() << "Cannot write import timing to" << timingJson;
+
+    /* Delete materials, as they are now unused */
+    for(auto i: materials) delete i.second;
+
+    importer->close();
+}
+
+void ViewerExample::openPackage(const char* filename, const std::size_t ramBudget, const std::size_t vramBudget) {
+    Debug() << "Opening scene package" << filename;
+
+    package.reset(new ScenePackage(filename));
+    if(!package->isOpen())
+        std::exit(4);
+
+    /* The mesh data stay in the mapped file until the mesh is visible */
+    std::vector<ViewerMesh*> packageMeshes;
+    packageMeshes.reserve(package->meshCount());
+    for(std::size_t i = 0; i != package->meshCount(); ++i) {
+        const ScenePackageMesh& data = package->mesh(i);
+        ViewerMesh* mesh = new ViewerMesh(i);
+        mesh->primitive = Mesh::Primitive(data.primitive);
+        mesh->vertexCount = data.vertexCount;
+        mesh->vertexDataSize = data.vertexDataSize;
+        mesh->indexCount = data.indexCount;
+        mesh->indexType = Mesh::IndexType(data.indexType);
+        mesh->restartIndex = data.restartIndex;
+        mesh->center = data.center;
+        mesh->radius = data.radius;
+        meshes[i].push_back(mesh);
+        packageMeshes.push_back(mesh);
+
+        vertexCount += data.vertexCount;
+        meshDataBytes += mesh->dataSize();
+    }
+
+    for(std::size_t i = 0; i != package->instanceCount(); ++i) {
+        const ScenePackageInstance& instance = package->instance(i);
+        PhongMaterialData material(instance.ambientColor, instance.diffuseColor, instance.specularColor, instance.shininess);
+        (new ViewedObject(packageMeshes[instance.mesh], &material, &shader, o, &drawables))
+            ->setTransformation(instance.transformation);
+    }
+
+    objectCount = package->instanceCount();
+    meshCount = chunkCount = package->meshCount();
+    Debug() << "Opened" << objectCount << "objects with" << meshCount << "meshes and" << vertexCount << "vertices," << meshDataBytes/1024 << "kB of mesh data in" << package->nodeCount() << "octree nodes.";
+
+    streamer.reset(new SceneStreamer(*package, std::move(packageMeshes)));
+    streamer->setRamBudget(ramBudget)
+        ->setVramBudget(vramBudget);
+    camera->setStreamer(streamer.get());
+    lazyUpload = true;
+}
+
+void ViewerExample::addObject(AbstractImporter* importer, Object3D* parent, std::unordered_map<std::size_t, PhongMaterialData*>& materials, std::size_t objectId) {
+    ObjectData3D* object = importer->object3D(objectId);
 
     /* Only meshes for now */
     if(object->instanceType() == ObjectData3D::InstanceType::Mesh) {
         ++objectCount;
 
         /* Use already processed mesh, if exists */
-        Mesh* mesh;
+        std::vector<ViewerMesh*>* chunks;
         auto found = meshes.find(object->instanceId());
-        if(found != meshes.end()) mesh = std::get<2>(found->second);
+        if(found != meshes.end()) chunks = &found->second;
 
         /* Or create a new one */
         else {
             ++meshCount;
+            chunks = &meshes[object->instanceId()];
 
-            mesh = new Mesh;
-            Buffer* buffer = new Buffer;
-            Buffer* indexBuffer = new Buffer;
-            meshes.insert(std::make_pair(object->instanceId(), std::make_tuple(buffer, indexBuffer, mesh)));
-
-            MeshData3D* data = colladaImporter->mesh3D(object->instanceId());
+            importProfiler.beginMesh(object->instanceId());
+            importProfiler.start(ImportProfiler::Phase::Extract);
+            MeshData3D* data = importer->mesh3D(object->instanceId());
+            importProfiler.stop();
             if(!data || !data->indices() || !data->positionArrayCount() || !data->normalArrayCount())
                 std::exit(6);
 
             vertexCount += data->positions(0)->size();
             triangleCount += data->indices()->size()/3;
 
-            /* Optimize vertices */
-            Debug() << "Optimizing vertices of mesh" << object->instanceId() << "using Tipsify algorithm (cache size 24)...";
-            MeshTools::tipsify(*data->indices(), data->positions(0)->size(), 24);
+            if(optimizer != VertexCacheOptimizer::None)
+                Debug() << "Optimizing vertices of mesh" << object->instanceId() << "using" << vertexCacheOptimizerName(optimizer) << "algorithm, cache size" << cacheSize;
+
+            /* Split big meshes so each chunk can use 16-bit indices, each
+               chunk is then optimized separately */
+            if(splitMeshes && data->positions(0)->size() > MaxChunkVertexCount) {
+                importProfiler.start(ImportProfiler::Phase::Split);
+                std::vector<MeshChunk> parts = splitMesh(*data->indices(), *data->positions(0), *data->normals(0), MaxChunkVertexCount);
+                importProfiler.stop();
+                Debug() << "Splitting mesh" << object->instanceId() << "with" << data->positions(0)->size() << "vertices into" << parts.size() << "chunks";
 
-            /* Interleave mesh data */
-            MeshTools::interleave(mesh, buffer, Buffer::Usage::StaticDraw, *data->positions(0), *data->normals(0));
-            mesh->addInterleavedVertexBuffer(buffer, 0, PhongShader::Position(), PhongShader::Normal());
+                for(MeshChunk& part: parts)
+                    chunks->push_back(createMesh(part.indices, part.positions, part.normals));
+            } else chunks->push_back(createMesh(*data->indices(), *data->positions(0), *data->normals(0)));
 
-            /* Compress indices */
-            MeshTools::compressIndices(mesh, indexBuffer, Buffer::Usage::StaticDraw, *data->indices());
+            importProfiler.endMesh(data->positions(0)->size(), data->indices()->size()/3);
             delete data;
         }
 
@@ -310,19 +958,130 @@ void ViewerExample::addObject(AbstractImporter* colladaImporter, Object3D* paren
         else {
             ++materialCount;
 
-            material = static_cast<PhongMaterialData*>(colladaImporter->material(static_cast<MeshObjectData3D*>(object)->material()));
+            material = static_cast<PhongMaterialData*>(importer->material(static_cast<MeshObjectData3D*>(object)->material()));
             if(!material) material = new PhongMaterialData({0.0f, 0.0f, 0.0f}, {0.9f, 0.9f, 0.9f}, {1.0f, 1.0f, 1.0f}, 50.0f);
         }
 
-        /* Add object */
-        Object3D* o = new ViewedObject(mesh, material, &shader, parent, &drawables);
+        /* Add object, other chunks of the mesh are its children */
+        Object3D* o = new ViewedObject(chunks->front(), material, &shader, parent, &drawables);
+        for(std::size_t i = 1; i < chunks->size(); ++i)
+            new ViewedObject((*chunks)[i], material, &shader, o, &drawables);
         delete material;
         o->setTransformation(object->transformation());
     }
 
     /* Recursively add children */
     for(std::size_t id: object->children())
-        addObject(colladaImporter, o, materials, id);
+        addObject(importer, o, materials, id);
+}
+
+ViewerMesh* ViewerExample::createMesh(std::vector<UnsignedInt>& indices, const std::vector<Vector3>& positions, const std::vector<Vector3>& normals) {
+    ViewerMesh* mesh = new ViewerMesh(chunkCount++);
+
+    /* Optimize vertices */
+    VertexCacheStatistics before{};
+    if(analyzeCache)
+        before = simulateVertexCache(indices, positions.size(), VertexCachePolicy::Fifo, cacheSize);
+    importProfiler.start(ImportProfiler::Phase::Optimize);
+    optimizeVertexCache(indices, positions.size(), optimizer, cacheSize);
+    importProfiler.stop();
+    if(analyzeCache) {
+        const VertexCacheStatistics after = simulateVertexCache(indices, positions.size(), VertexCachePolicy::Fifo, cacheSize);
+        Debug() << "    FIFO ACMR" << before.acmr << "->" << after.acmr << "and ATVR" << before.atvr << "->" << after.atvr;
+        missesBefore += before.acmr*indices.size()/3;
+        missesAfter += after.acmr*indices.size()/3;
+    }
+
+    /* Bounding sphere for culling */
+    Vector3 min = positions[0], max = positions[0];
+    for(const Vector3& position: positions) {
+        min = Vector3(std::min(min.x(), position.x()), std::min(min.y(), position.y()), std::min(min.z(), position.z()));
+        max = Vector3(std::max(max.x(), position.x()), std::max(max.y(), position.y()), std::max(max.z(), position.z()));
+    }
+    mesh->center = (min + max)/2.0f;
+    for(const Vector3& position: positions)
+        mesh->radius = std::max(mesh->radius, (position - mesh->center).length());
+
+    /* Interleave mesh data */
+    importProfiler.start(ImportProfiler::Phase::Interleave);
+    std::size_t attributeCount, stride;
+    char* vertexData;
+    std::tie(attributeCount, stride, vertexData) = MeshTools::interleave(positions, normals);
+    importProfiler.stop();
+
+    /* Compress indices */
+    importProfiler.start(ImportProfiler::Phase::CompressIndices);
+    std::size_t indexCount;
+    Mesh::IndexType indexType;
+    char* indexData;
+    std::tie(indexCount, indexType, indexData) = MeshTools::compressIndices(indices);
+    importProfiler.stop();
+
+    /* Triangle strips with primitive restart. Strips longer than roughly the
+       cache size would make vertex cache use worse. In automatic mode the
+       strips are used only if they don't draw slower than the list, with lazy
+       upload they are used always to save time. */
+    Mesh::Primitive primitive = Mesh::Primitive::Triangles;
+    const std::size_t listBytes = indexCount*Mesh::indexSize(indexType);
+    if(stripMode != StripMode::Off) {
+        importProfiler.start(ImportProfiler::Phase::Stripify);
+        std::size_t stripIndexCount;
+        Mesh::IndexType stripIndexType;
+        char* stripIndexData;
+        std::tie(stripIndexCount, stripIndexType, stripIndexData) = compressStripIndices(stripify(indices, attributeCount, cacheSize*2/3), attributeCount);
+
+        bool useStrips = true;
+        #ifndef MAGNUM_TARGET_GLES
+        if(stripMode == StripMode::Automatic && !lazyUpload) {
+            const Double listTime = measureDrawTime(vertexData, attributeCount*stride, attributeCount, Mesh::Primitive::Triangles, indexCount, indexType, indexData);
+            const Double stripTime = measureDrawTime(vertexData, attributeCount*stride, attributeCount, Mesh::Primitive::TriangleStrip, stripIndexCount, stripIndexType, stripIndexData);
+            useStrips = stripTime <= listTime*1.03;
+            Debug() << "    indices" << listBytes/1024 << "kB as list," << stripIndexCount*Mesh::indexSize(stripIndexType)/1024 << "kB as strips, draw time" << listTime << "ms vs." << stripTime << "ms, using" << (useStrips ? "strips" : "list");
+        }
+        #endif
+
+        if(useStrips) {
+            std::swap(indexData, stripIndexData);
+            indexCount = stripIndexCount;
+            indexType = stripIndexType;
+            primitive = Mesh::Primitive::TriangleStrip;
+            mesh->restartIndex = stripRestartIndex(indexType);
+        }
+        delete[] stripIndexData;
+        importProfiler.stop();
+    }
+    listIndexBytes += listBytes;
+    indexBytes += indexCount*Mesh::indexSize(indexType);
+
+    /* BVH for picking, the triangle order doesn't matter for it */
+    if(picking) {
+        importProfiler.start(ImportProfiler::Phase::Bvh);
+        mesh->bvh.reset(new MeshBvh(indices, positions));
+        importProfiler.stop();
+        bvhBytes += mesh->bvh->memorySize();
+    }
+
+    /* Keep the processed data, they are uploaded either now or when the mesh
+       is visible for the first time */
+    mesh->primitive = primitive;
+    mesh->vertexCount = attributeCount;
+    mesh->vertexDataSize = attributeCount*stride;
+    mesh->indexCount = indexCount;
+    mesh->indexType = indexType;
+    mesh->vertexData.reset(vertexData);
+    mesh->indexData.reset(indexData);
+    mesh->positions = positions;
+    meshDataBytes += mesh->vertexDataSize + indexCount*Mesh::indexSize(indexType) + positions.size()*sizeof(Vector3);
+
+    /* Wait for the driver, so the actual copy is measured too */
+    if(!lazyUpload) {
+        importProfiler.start(ImportProfiler::Phase::Upload);
+        mesh->upload();
+        Renderer::finish();
+        importProfiler.stop();
+    }
+
+    return mesh;
 }
 
 }}
@@ -0,0 +1,90 @@
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ViewerMesh.h"
+
+#include <Shaders/PhongShader.h>
+
+#include "DepthShader.h"
+
+namespace Magnum { namespace Examples {
+
+std::size_t ViewerMesh::dataSize() const {
+    return vertexDataSize + indexCount*Mesh::indexSize(indexType) + vertexCount*sizeof(Vector3);
+}
+
+std::size_t ViewerMesh::upload() {
+    const std::size_t size = upload(vertexData.get(), indexData.get(), positions.data());
+
+    vertexData.reset();
+    indexData.reset();
+    std::vector<Vector3>().swap(positions);
+    return size;
+}
+
+std::size_t ViewerMesh::upload(const char* vertexData, const char* indexData, const Vector3* positions) {
+    vertexBuffer.setData(vertexDataSize, vertexData, Buffer::Usage::StaticDraw);
+    indexBuffer.setData(indexCount*Mesh::indexSize(indexType), indexData, Buffer::Usage::StaticDraw);
+    positionBuffer.setData(vertexCount*sizeof(Vector3), positions, Buffer::Usage::StaticDraw);
+
+    /* Attributes are set up only on first upload, the buffers stay the same */
+    if(!configured) {
+        mesh.setPrimitive(primitive)
+            ->addInterleavedVertexBuffer(&vertexBuffer, 0, Shaders::PhongShader::Position(), Shaders::PhongShader::Normal())
+            ->setIndexBuffer(&indexBuffer, 0, indexType, 0, vertexCount - 1);
+
+        /* Separate position stream for depth-only passes, less data to fetch
+           than the interleaved buffer */
+        positionMesh.setPrimitive(primitive)
+            ->addVertexBuffer(&positionBuffer, 0, DepthShader::Position())
+            ->setIndexBuffer(&indexBuffer, 0, indexType, 0, vertexCount - 1);
+        configured = true;
+    }
+
+    mesh.setVertexCount(vertexCount)
+        ->setIndexCount(indexCount);
+    positionMesh.setVertexCount(vertexCount)
+        ->setIndexCount(indexCount);
+
+    uploaded = true;
+    return dataSize();
+}
+
+std::size_t ViewerMesh::release() {
+    if(!uploaded) return 0;
+
+    /* Empty meshes are not drawn at all */
+    mesh.setVertexCount(0)
+        ->setIndexCount(0);
+    positionMesh.setVertexCount(0)
+        ->setIndexCount(0);
+    vertexBuffer.setData(0, nullptr, Buffer::Usage::StaticDraw);
+    indexBuffer.setData(0, nullptr, Buffer::Usage::StaticDraw);
+    positionBuffer.setData(0, nullptr, Buffer::Usage::StaticDraw);
+
+    uploaded = false;
+    return dataSize();
+}
+
+}}
@@ -0,0 +1,103 @@
+#ifndef Magnum_Examples_ViewerMesh_h
+#define Magnum_Examples_ViewerMesh_h
+/*
+    This file is part of Magnum.
+
+    Copyright © 2010, 2011, 2012, 2013 Vladimír Vondruš <mosra@centrum.cz>
+
+    Permission is hereby granted, free of charge, to any person obtaining a
+    copy of this software and associated documentation files (the "Software"),
+    to deal in the Software without restriction, including without limitation
+    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+    and/or sell copies of the Software, and to permit persons to whom the
+    Software is furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+    DEALINGS IN THE SOFTWARE.
+*/
+
+#include <memory>
+#include <vector>
+#include <Buffer.h>
+#include <Mesh.h>
+
+#include "Bvh.h"
+#include "TriangleStrips.h"
+
+namespace Magnum { namespace Examples {
+
+/* GPU data of one imported mesh, shared by all objects using it */
+struct ViewerMesh {
+    inline explicit ViewerMesh(UnsignedInt id): id(id), restartIndex(0), primitive(Mesh::Primitive::Triangles), vertexCount(0), vertexDataSize(0), indexCount(0), indexType(Mesh::IndexType::UnsignedInt), uploaded(false), configured(false), radius(0.0f) {}
+
+    /* Draw with primitive restart set up for strips */
+    inline void draw() {
+        usePrimitiveRestart(restartIndex);
+        mesh.draw();
+    }
+
+    inline void drawPositions() {
+        usePrimitiveRestart(restartIndex);
+        positionMesh.draw();
+    }
+
+    /* Whether the mesh is on GPU */
+    inline bool isUploaded() const { return uploaded; }
+
+    /* Whether the processed data are in host memory */
+    inline bool hasHostData() const { return !!vertexData; }
+
+    /* Size of vertex, index and position data in bytes */
+    std::size_t dataSize() const;
+
+    /* Upload the host data to GPU and release them, returns uploaded size in
+       bytes */
+    std::size_t upload();
+
+    /* Upload data from external memory, e.g. memory-mapped file. The host
+       data are not touched. Returns uploaded size in bytes. */
+    std::size_t upload(const char* vertexData, const char* indexData, const Vector3* positions);
+
+    /* Release GPU data, the mesh then needs to be uploaded again from
+       external memory. Returns released size in bytes. */
+    std::size_t release();
+
+    UnsignedInt id;
+    Buffer vertexBuffer, indexBuffer;
+    Mesh mesh;
+
+    /* Primitive restart index if the mesh is triangle strip, 0 otherwise */
+    UnsignedInt restartIndex;
+
+    /* Positions only, for depth pre-pass. Shares the index buffer. */
+    Buffer positionBuffer;
+    Mesh positionMesh;
+
+    /* Processed data in host memory, released in upload() */
+    Mesh::Primitive primitive;
+    UnsignedInt vertexCount;
+    std::size_t vertexDataSize, indexCount;
+    Mesh::IndexType indexType;
+    std::unique_ptr<char[]> vertexData, indexData;
+    std::vector<Vector3> positions;
+    bool uploaded, configured;
+
+    /* Bounding sphere in object space, used for culling */
+    Vector3 center;
+    Float radius;
+
+    /* Triangles in object space for picking, null if not built */
+    std::unique_ptr<MeshBvh> bvh;
+};
+
+}}
+
+#endif